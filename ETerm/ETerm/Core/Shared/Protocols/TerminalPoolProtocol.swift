@@ -99,10 +99,24 @@ protocol TerminalPoolProtocol: AnyObject {
     @discardableResult
     func writeInput(terminalId: Int, data: String) -> Bool
 
+    /// 流式粘贴到指定终端（自动处理 Bracketed Paste Mode）
+    @discardableResult
+    func paste(terminalId: Int, text: String) -> Bool
+
     /// 滚动指定终端
     @discardableResult
     func scroll(terminalId: Int, deltaLines: Int32) -> Bool
 
+    /// 把上一个（previous = true）或下一个命令提示符滚动到视口顶部（需要 OSC 133）
+    @discardableResult
+    func jumpToPrompt(terminalId: Int, previous: Bool) -> Bool
+
+    /// 最近一条已结束命令的输出（需要 OSC 133）
+    func getLastCommandOutput(terminalId: Int) -> String?
+
+    /// 导出命令块列表（JSON 数组，需要 OSC 133）
+    func getCommandBlocksJSON(terminalId: Int, includeOutput: Bool) -> String?
+
     /// 调整终端尺寸
     @discardableResult
     func resize(terminalId: Int, cols: UInt16, rows: UInt16) -> Bool
@@ -273,7 +287,11 @@ final class MockTerminalPool: TerminalPoolProtocol {
     func detachTerminal(_ terminalId: Int) -> DetachedTerminalHandle? { nil }
     func attachTerminal(_ detached: DetachedTerminalHandle) -> Int { -1 }
     func writeInput(terminalId: Int, data: String) -> Bool { false }
+    func paste(terminalId: Int, text: String) -> Bool { false }
     func scroll(terminalId: Int, deltaLines: Int32) -> Bool { false }
+    func jumpToPrompt(terminalId: Int, previous: Bool) -> Bool { false }
+    func getLastCommandOutput(terminalId: Int) -> String? { nil }
+    func getCommandBlocksJSON(terminalId: Int, includeOutput: Bool) -> String? { nil }
     func resize(terminalId: Int, cols: UInt16, rows: UInt16) -> Bool { false }
     func setRenderCallback(_ callback: @escaping () -> Void) {}
     func render(terminalId: Int, x: Float, y: Float, width: Float, height: Float, cols: UInt16, rows: UInt16) -> Bool { false }
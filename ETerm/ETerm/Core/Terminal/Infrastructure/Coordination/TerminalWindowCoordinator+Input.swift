@@ -31,6 +31,12 @@ extension TerminalWindowCoordinator {
         return terminalPool.writeInput(terminalId: terminalId, data: data)
     }
 
+    /// 流式粘贴（自动处理 Bracketed Paste Mode）
+    @discardableResult
+    func pasteText(terminalId: Int, text: String) -> Bool {
+        return terminalPool.paste(terminalId: terminalId, text: text)
+    }
+
     /// 滚动（统一入口）
     @discardableResult
     func scrollInternal(terminalId: Int, deltaLines: Int32) -> Bool {
@@ -314,6 +314,29 @@ bool terminal_pool_input(
     size_t len
 );
 
+/// Paste buffer release callback
+///
+/// Called once the PTY thread is done with (or drops) the pasted data.
+/// May be called on any thread.
+typedef void (*PasteReleaseCallback)(void* context);
+
+/// Stream a paste into terminal
+///
+/// The PTY thread writes `data` in chunks, wrapped in \x1b[200~ / \x1b[201~
+/// when Bracketed Paste Mode is enabled. Keystrokes sent meanwhile are written first.
+///
+/// @param release Non-NULL: zero-copy, `data` must stay valid until `release(context)`
+///                is called. NULL: `data` is copied before returning.
+/// @return false if the terminal was not found (`release` has been called)
+bool terminal_pool_paste(
+    TerminalPoolHandle handle,
+    size_t terminal_id,
+    const uint8_t* data,
+    size_t len,
+    PasteReleaseCallback release,
+    void* context
+);
+
 /// Scroll terminal
 bool terminal_pool_scroll(
     TerminalPoolHandle handle,
@@ -321,6 +344,38 @@ bool terminal_pool_scroll(
     int32_t delta
 );
 
+// ===== Command Blocks (OSC 133) =====
+
+/// Scroll the previous (`previous` = true) or next shell prompt to the top of the viewport
+///
+/// Requires OSC 133 shell integration marks.
+/// @return false if there is no prompt in that direction
+bool terminal_pool_jump_to_prompt(
+    TerminalPoolHandle handle,
+    size_t terminal_id,
+    bool previous
+);
+
+/// Get the output of the last finished command
+///
+/// @return String (must be freed with rio_free_string), NULL if no command finished
+///         or its output left the scrollback
+char* terminal_pool_get_last_command_output(
+    TerminalPoolHandle handle,
+    size_t terminal_id
+);
+
+/// Export the terminal's command blocks
+///
+/// Each entry has index, prompt_row, command, exit_code, running and duration_ms,
+/// plus output when `include_output` is true.
+/// @return JSON array string (must be freed with rio_free_string), NULL if the terminal was not found
+char* terminal_pool_get_command_blocks(
+    TerminalPoolHandle handle,
+    size_t terminal_id,
+    bool include_output
+);
+
 // ===== Render Flow (Unified Submit) =====
 
 /// Begin new frame (clear pending objects)
@@ -539,6 +594,63 @@ void terminal_pool_clear_search(
     size_t terminal_id
 );
 
+/// Workspace search hit
+///
+/// Lines are absolute (0 = oldest history line), columns are inclusive.
+/// `end_line` is past `line` only for matches across soft-wrapped lines.
+typedef struct {
+    size_t terminal_id;
+    size_t line;
+    size_t start_col;
+    size_t end_line;
+    size_t end_col;
+} WorkspaceSearchHit;
+
+/// Workspace search status
+typedef enum {
+    WorkspaceSearchStatus_Running = 0,    // More hits may follow
+    WorkspaceSearchStatus_Finished = 1,   // All terminals searched
+    WorkspaceSearchStatus_Capped = 2,     // Stopped at max_hits
+    WorkspaceSearchStatus_Cancelled = 3,  // Cancelled, no more hits follow
+} WorkspaceSearchStatus;
+
+/// Workspace search callback
+///
+/// Hits arrive in batches with status Running, the last call has count 0 and the
+/// final status. Called on a background thread, `hits` is only valid during the call.
+typedef void (*WorkspaceSearchCallback)(
+    void* context,
+    uint64_t search_id,
+    const WorkspaceSearchHit* hits,
+    size_t count,
+    WorkspaceSearchStatus status
+);
+
+/// Search the scrollback of several terminals at once
+///
+/// Runs in the background, the query is compiled once and terminals are searched
+/// in parallel. Per-terminal search highlights are not touched. Starting a new
+/// workspace search cancels the previous one.
+///
+/// @param terminal_ids Terminals to search, NULL (or terminal_count 0) for all terminals
+/// @param max_hits Hit limit across all terminals
+/// @param context Must stay valid until the callback reports a final status
+/// @return Search ID (> 0), or -1 if the query is invalid (no callback is made)
+int64_t terminal_pool_search_all(
+    TerminalPoolHandle handle,
+    const char* query,
+    bool is_regex,
+    bool case_sensitive,
+    const size_t* terminal_ids,
+    size_t terminal_count,
+    size_t max_hits,
+    WorkspaceSearchCallback callback,
+    void* context
+);
+
+/// Cancel the running workspace search, the callback then reports Cancelled
+void terminal_pool_cancel_search_all(TerminalPoolHandle handle);
+
 // =============================================================================
 // Cursor & Word Boundary API (new architecture)
 // =============================================================================
@@ -824,6 +936,94 @@ void terminal_pool_set_render_layout(
 /// This is for special cases (initialization, force refresh)
 void terminal_pool_render_all(TerminalPoolHandle handle);
 
+/// Set cursor blinking
+///
+/// Blinking is driven by idle VSyncs of the RenderScheduler; toggles only
+/// recomposite cached terminal images, no terminal is re-rendered.
+///
+/// @param handle TerminalPool handle
+/// @param terminal_id Terminal whose cursor blinks (usually the focused one), negative disables blinking
+/// @param interval_ms Toggle interval in milliseconds, 0 disables blinking
+void terminal_pool_set_cursor_blink(
+    TerminalPoolHandle handle,
+    int64_t terminal_id,
+    uint32_t interval_ms
+);
+
+/// Set how long a terminal stays hidden before it hibernates
+///
+/// A hibernated terminal drops its render caches and keeps its scrollback in
+/// a compact encoding; everything is restored when it is shown again.
+///
+/// @param handle TerminalPool handle
+/// @param seconds Hidden time in seconds (default 600), 0 disables hibernation
+void terminal_pool_set_hibernate_after(TerminalPoolHandle handle, uint32_t seconds);
+
+/// Hibernate a terminal now
+///
+/// @param handle TerminalPool handle
+/// @param terminal_id Terminal ID
+/// @return Bytes released, -1 if the terminal is missing, busy, already hibernated or has nothing to release
+int64_t terminal_pool_hibernate_terminal(TerminalPoolHandle handle, size_t terminal_id);
+
+/// Get the bytes released when a terminal hibernated
+///
+/// @param handle TerminalPool handle
+/// @param terminal_id Terminal ID
+/// @return Bytes released, -1 if the terminal is missing or not hibernated
+int64_t terminal_pool_get_hibernated_bytes(TerminalPoolHandle handle, size_t terminal_id);
+
+/// Set the pool-wide memory budget
+///
+/// When the terminals and the line cache exceed the budget, memory is reclaimed
+/// from the cheapest source up: spare scrollback capacity, render caches of
+/// hidden terminals and the line cache, then hidden terminals are hibernated
+/// (longest hidden first). Terminal content is never discarded.
+///
+/// @param handle TerminalPool handle
+/// @param bytes Budget in bytes, 0 for no limit
+void terminal_pool_set_memory_budget(TerminalPoolHandle handle, uint64_t bytes);
+
+/// Per-terminal memory statistics (estimated bytes)
+typedef struct {
+    uint64_t grid;              // Visible rows of both screens and the render snapshot
+    uint64_t scrollback;        // History rows, including hibernated history
+    uint64_t log_buffer;        // Output log buffer
+    uint64_t surfaces;          // Render surface/image and cursor patch
+    uint64_t graphics;          // Graphics not handed to the renderer yet
+    uint64_t total;             // Sum of the above
+    bool valid;                 // Whether the result is valid
+} TerminalMemoryStats;
+
+/// Get the memory statistics of a terminal
+///
+/// Walks all history rows of the terminal, query on demand rather than per frame.
+/// The line cache is shared by content across terminals, see
+/// terminal_pool_get_pool_memory_stats.
+///
+/// @param handle TerminalPool handle
+/// @param terminal_id Terminal ID
+/// @return Memory stats, valid=false if terminal not found
+TerminalMemoryStats terminal_pool_get_memory_stats(
+    TerminalPoolHandle handle,
+    size_t terminal_id
+);
+
+/// Pool-wide memory statistics (estimated bytes)
+typedef struct {
+    uint64_t terminals;         // Sum over all terminals
+    uint64_t line_cache;        // Line cache shared by all terminals
+    uint64_t total;             // terminals + line_cache
+    uint64_t budget;            // Memory budget, 0 for no limit
+    bool valid;                 // Whether the result is valid
+} PoolMemoryStats;
+
+/// Get the pool-wide memory statistics
+///
+/// @param handle TerminalPool handle
+/// @return Pool memory stats, valid=false if handle is invalid
+PoolMemoryStats terminal_pool_get_pool_memory_stats(TerminalPoolHandle handle);
+
 // ============================================================================
 // Terminal Mode API
 // ============================================================================
@@ -906,6 +1106,29 @@ ScrollInfo terminal_pool_get_scroll_info(
     size_t terminal_id
 );
 
+/// Synchronized update (DEC mode 2026) statistics
+typedef struct {
+    uint64_t started;           // Synchronized updates started
+    uint64_t completed;         // Ended by ESU
+    uint64_t timed_out;         // Aborted by the sync timeout
+    uint64_t overflowed;        // Aborted by the sync buffer limit
+    bool syncing;               // Whether a synchronized update is in progress
+    bool valid;                 // Whether the result is valid
+} SyncUpdateStats;
+
+/// Get synchronized update statistics (lock-free)
+///
+/// Growing timed_out/overflowed counts mean the running TUI exceeds the
+/// synchronized update limits and its frames get flushed mid-update.
+///
+/// @param handle TerminalPool handle
+/// @param terminal_id Terminal ID
+/// @return Sync stats, valid=false if terminal not found
+SyncUpdateStats terminal_pool_get_sync_stats(
+    TerminalPoolHandle handle,
+    size_t terminal_id
+);
+
 // =============================================================================
 // Keyboard API (key to escape sequence conversion)
 // =============================================================================
@@ -487,12 +487,73 @@ class TerminalPoolWrapper: TerminalPoolProtocol {
         }
     }
 
+    /// 流式粘贴（零拷贝）
+    ///
+    /// Rust 侧按块写入 PTY，并根据 Bracketed Paste Mode 自动包裹转义序列，
+    /// 调用方不需要再自己拼接 \u{1B}[200~ / \u{1B}[201~
+    @discardableResult
+    func paste(terminalId: Int, text: String) -> Bool {
+        guard let handle = handle else { return false }
+
+        // 与 writeInput 一致：\r\n 转换为 \n
+        let normalizedText = text.replacingOccurrences(of: "\r\n", with: "\n")
+        guard let data = normalizedText.data(using: .utf8) else { return false }
+
+        // NSData 的字节在其生命周期内地址稳定，由 release 回调释放
+        let buffer = data as NSData
+        let context = Unmanaged.passRetained(buffer).toOpaque()
+        return terminal_pool_paste(
+            handle,
+            terminalId,
+            buffer.bytes.assumingMemoryBound(to: UInt8.self),
+            buffer.length,
+            { context in
+                guard let context = context else { return }
+                Unmanaged<NSData>.fromOpaque(context).release()
+            },
+            context
+        )
+    }
+
     @discardableResult
     func scroll(terminalId: Int, deltaLines: Int32) -> Bool {
         guard let handle = handle else { return false }
         return terminal_pool_scroll(handle, terminalId, deltaLines)
     }
 
+    // MARK: - Command Blocks (OSC 133)
+
+    /// 把上一个（previous = true）或下一个命令提示符滚动到视口顶部
+    @discardableResult
+    func jumpToPrompt(terminalId: Int, previous: Bool) -> Bool {
+        guard let handle = handle else { return false }
+        return terminal_pool_jump_to_prompt(handle, terminalId, previous)
+    }
+
+    /// 最近一条已结束命令的输出
+    func getLastCommandOutput(terminalId: Int) -> String? {
+        guard let handle = handle else { return nil }
+
+        let cStr = terminal_pool_get_last_command_output(handle, terminalId)
+        guard let cStr = cStr else { return nil }
+
+        let result = String(cString: cStr)
+        rio_free_string(cStr)
+        return result
+    }
+
+    /// 导出命令块列表（JSON 数组）
+    func getCommandBlocksJSON(terminalId: Int, includeOutput: Bool) -> String? {
+        guard let handle = handle else { return nil }
+
+        let cStr = terminal_pool_get_command_blocks(handle, terminalId, includeOutput)
+        guard let cStr = cStr else { return nil }
+
+        let result = String(cString: cStr)
+        rio_free_string(cStr)
+        return result
+    }
+
     @discardableResult
     func resize(terminalId: Int, cols: UInt16, rows: UInt16) -> Bool {
         guard let handle = handle else { return false }
@@ -876,6 +937,65 @@ class TerminalPoolWrapper: TerminalPoolProtocol {
         terminal_pool_clear_search(handle, terminalId)
     }
 
+    /// 跨终端搜索（后台并行执行）
+    ///
+    /// 命中分批回调，最后一次回调 hits 为空、status 为结束状态。
+    /// 回调在后台线程上执行；新的搜索会取消上一次未完成的搜索。
+    ///
+    /// - Parameters:
+    ///   - terminalIds: 要搜索的终端，nil 表示所有终端
+    ///   - maxHits: 所有终端合计的命中上限
+    /// - Returns: 搜索 ID（> 0），查询无效返回 -1（不会回调）
+    @discardableResult
+    func searchAll(
+        query: String,
+        isRegex: Bool = false,
+        caseSensitive: Bool = false,
+        terminalIds: [Int]? = nil,
+        maxHits: Int = 10_000,
+        onHits: @escaping (UInt64, [WorkspaceSearchHit], WorkspaceSearchStatus) -> Void
+    ) -> Int64 {
+        guard let handle = handle else { return -1 }
+
+        // 回调闭包由 context 持有，收到结束状态时释放
+        let box = WorkspaceSearchCallbackBox(onHits)
+        let context = Unmanaged.passRetained(box).toOpaque()
+        let callback: WorkspaceSearchCallback = { context, searchId, hits, count, status in
+            guard let context = context else { return }
+            let box = Unmanaged<WorkspaceSearchCallbackBox>.fromOpaque(context)
+            let batch = hits.map { Array(UnsafeBufferPointer(start: $0, count: count)) } ?? []
+            box.takeUnretainedValue().onHits(searchId, batch, status)
+            if status != WorkspaceSearchStatus_Running {
+                box.release()
+            }
+        }
+
+        let ids = terminalIds ?? []
+        let searchId = ids.withUnsafeBufferPointer { buffer in
+            terminal_pool_search_all(
+                handle,
+                query,
+                isRegex,
+                caseSensitive,
+                buffer.baseAddress,
+                buffer.count,
+                maxHits,
+                callback,
+                context
+            )
+        }
+        if searchId < 0 {
+            Unmanaged<WorkspaceSearchCallbackBox>.fromOpaque(context).release()
+        }
+        return searchId
+    }
+
+    /// 取消进行中的跨终端搜索
+    func cancelSearchAll() {
+        guard let handle = handle else { return }
+        terminal_pool_cancel_search_all(handle)
+    }
+
     // MARK: - Terminal Mode
 
     /// 设置终端运行模式
@@ -987,6 +1107,69 @@ extension TerminalPoolWrapper {
         terminal_pool_render_all(handle)
     }
 
+    /// 设置光标闪烁
+    ///
+    /// - Parameters:
+    ///   - terminalId: 闪烁的终端（通常是焦点终端），nil 关闭闪烁
+    ///   - intervalMs: 亮灭切换间隔（毫秒），0 关闭闪烁
+    func setCursorBlink(terminalId: Int?, intervalMs: UInt32) {
+        guard let handle = handle else { return }
+        terminal_pool_set_cursor_blink(handle, Int64(terminalId ?? -1), intervalMs)
+    }
+
+    // MARK: - Hibernation
+
+    /// 设置休眠时长：终端隐藏超过该时长后释放渲染缓存、压缩历史行
+    ///
+    /// - Parameter seconds: 隐藏时长（秒），0 关闭自动休眠
+    func setHibernateAfter(seconds: UInt32) {
+        guard let handle = handle else { return }
+        terminal_pool_set_hibernate_after(handle, seconds)
+    }
+
+    /// 立即休眠终端
+    ///
+    /// - Returns: 释放的内存（字节），未休眠返回 nil
+    @discardableResult
+    func hibernateTerminal(terminalId: Int) -> Int? {
+        guard let handle = handle else { return nil }
+        let bytes = terminal_pool_hibernate_terminal(handle, terminalId)
+        return bytes >= 0 ? Int(bytes) : nil
+    }
+
+    /// 终端休眠释放的内存（字节），未休眠返回 nil
+    func hibernatedBytes(terminalId: Int) -> Int? {
+        guard let handle = handle else { return nil }
+        let bytes = terminal_pool_get_hibernated_bytes(handle, terminalId)
+        return bytes >= 0 ? Int(bytes) : nil
+    }
+
+    // MARK: - Memory Accounting
+
+    /// 设置内存预算：超出时依次收缩历史空闲容量、丢弃缓存、休眠不可见终端
+    ///
+    /// - Parameter bytes: 预算（字节），0 不限制
+    func setMemoryBudget(bytes: UInt64) {
+        guard let handle = handle else { return }
+        terminal_pool_set_memory_budget(handle, bytes)
+    }
+
+    /// 终端各部分的内存占用（会遍历历史行，按需查询，不要每帧调用）
+    ///
+    /// - Returns: 内存统计，终端不存在时返回 nil
+    func getMemoryStats(terminalId: Int) -> TerminalMemoryStats? {
+        guard let handle = handle else { return nil }
+        let stats = terminal_pool_get_memory_stats(handle, terminalId)
+        return stats.valid ? stats : nil
+    }
+
+    /// 池的内存占用（所有终端 + 共享的行缓存）
+    func getPoolMemoryStats() -> PoolMemoryStats? {
+        guard let handle = handle else { return nil }
+        let stats = terminal_pool_get_pool_memory_stats(handle)
+        return stats.valid ? stats : nil
+    }
+
     // MARK: - Lock-Free Cache API (Phase 1 Async FFI)
 
     /// 选区范围（无锁读取）
@@ -1154,3 +1337,12 @@ extension TerminalPoolWrapper {
         return lines >= 0 ? Int(lines) : nil
     }
 }
+
+/// 跨终端搜索回调的持有者（通过 Unmanaged 传给 Rust）
+private final class WorkspaceSearchCallbackBox {
+    let onHits: (UInt64, [WorkspaceSearchHit], WorkspaceSearchStatus) -> Void
+
+    init(_ onHits: @escaping (UInt64, [WorkspaceSearchHit], WorkspaceSearchStatus) -> Void) {
+        self.onHits = onHits
+    }
+}
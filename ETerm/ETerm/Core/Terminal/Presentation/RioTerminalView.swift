@@ -347,6 +347,8 @@ class RioContainerView: NSView {
                 self?.updatePanelViews()
                 // Tab 切换时显示发光效果
                 self?.showActiveGlow()
+                // 闪烁跟随焦点终端
+                self?.updateCursorBlink()
             }
         )
     }
@@ -365,6 +367,7 @@ class RioContainerView: NSView {
 
         // 窗口获得焦点时显示发光效果
         showActiveGlow()
+        updateCursorBlink()
     }
 
     @objc private func windowDidResignKey(_ notification: Notification) {
@@ -373,6 +376,16 @@ class RioContainerView: NSView {
 
         // 窗口失去焦点时立即隐藏发光
         hideActiveGlow()
+        updateCursorBlink()
+    }
+
+    /// 让焦点终端的光标闪烁，窗口不是 key window 时关闭闪烁
+    ///
+    /// 终端自己设置了闪烁光标（DECSCUSR / DECSET 12）时才会真正闪烁
+    private func updateCursorBlink() {
+        guard let pool = terminalPool else { return }
+        let terminalId = window?.isKeyWindow == true ? coordinator?.getActiveTerminalId() : nil
+        pool.setCursorBlink(terminalId: terminalId, intervalMs: cursorBlinkIntervalMs)
     }
 
     /// 显示 Active 终端发光效果
@@ -967,12 +980,10 @@ class RioMetalView: NSView, RenderViewProtocol {
     /// 较小的值 = 更灵敏的滚动，较大的值 = 滚动更慢
     private let scrollThreshold: CGFloat = 12.0
 
-    // MARK: - 光标闪烁相关（照抄 Rio）
+    // MARK: - 光标闪烁相关
 
-    private var lastBlinkToggle: Date?
-    private var isBlinkingCursorVisible: Bool = true
-    private var lastTypingTime: Date?
-    private let blinkInterval: TimeInterval = 0.5
+    /// 光标亮灭切换间隔（毫秒），闪烁计时和合成都在 Rust 侧
+    private let cursorBlinkIntervalMs: UInt32 = 500
 
     // MARK: - 文本选择状态
 
@@ -1262,6 +1273,9 @@ class RioMetalView: NSView, RenderViewProtocol {
             }
         }
 
+        // 光标闪烁（之后随焦点变化更新）
+        updateCursorBlink()
+
         // 设置 IME 回调（同步预编辑状态到 Rust 渲染层）
         imeCoordinator.onPreeditChange = { [weak self, weak pool] text, cursorOffset in
             guard let self = self,
@@ -1567,10 +1581,6 @@ class RioMetalView: NSView, RenderViewProtocol {
     }
 
     override func keyDown(with event: NSEvent) {
-        lastTypingTime = Date()
-        isBlinkingCursorVisible = true
-        lastBlinkToggle = nil
-
         guard let pool = terminalPool,
               let terminalId = coordinator?.getActiveTerminalId() else {
             super.keyDown(with: event)
@@ -1634,13 +1644,8 @@ class RioMetalView: NSView, RenderViewProtocol {
         // Cmd+V 粘贴
         if keyStroke.matches(.cmd("v")) {
             if let text = NSPasteboard.general.string(forType: .string) {
-                // 根据终端是否启用 Bracketed Paste Mode 决定是否包裹转义序列
-                if pool.isBracketedPasteEnabled(terminalId: Int(terminalId)) {
-                    let bracketedText = "\u{1B}[200~" + text + "\u{1B}[201~"
-                    _ = pool.writeInput(terminalId: Int(terminalId), data: bracketedText)
-                } else {
-                    _ = pool.writeInput(terminalId: Int(terminalId), data: text)
-                }
+                // Rust 侧根据 Bracketed Paste Mode 决定是否包裹转义序列
+                _ = pool.paste(terminalId: Int(terminalId), text: text)
             }
             return true
         }
@@ -2156,7 +2161,7 @@ class RioMetalView: NSView, RenderViewProtocol {
               let pool = terminalPool else {
             return
         }
-        _ = pool.writeInput(terminalId: Int(terminalId), data: text)
+        _ = pool.paste(terminalId: Int(terminalId), text: text)
     }
 
     @objc private func copySelection(_ sender: Any?) {
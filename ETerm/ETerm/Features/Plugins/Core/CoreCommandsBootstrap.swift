@@ -512,13 +512,8 @@ extension TerminalWindowCoordinator {
 
         // 检查文本
         if let text = pasteboard.string(forType: .string) {
-            // 根据终端是否启用 Bracketed Paste Mode 决定是否包裹转义序列
-            if isActiveTerminalBracketedPasteEnabled() {
-                let bracketedText = "\u{1B}[200~" + text + "\u{1B}[201~"
-                writeInput(terminalId: terminalId, data: bracketedText)
-            } else {
-                writeInput(terminalId: terminalId, data: text)
-            }
+            // Rust 侧根据 Bracketed Paste Mode 决定是否包裹转义序列
+            pasteText(terminalId: terminalId, text: text)
         }
     }
 
@@ -373,12 +373,66 @@ fn bench_real_world_scenarios(c: &mut Criterion) {
     group.finish();
 }
 
+fn bench_sgr_heavy(c: &mut Criterion) {
+    let mut group = c.benchmark_group("sgr_heavy");
+
+    // Colorized log output: level, timestamp and key/value highlighting
+    let colorized_log = {
+        let mut data = Vec::new();
+        for i in 0..500 {
+            data.extend_from_slice(
+                format!(
+                    "\x1b[2m2024-01-01T12:00:{:02}Z\x1b[0m \x1b[1;32mINFO\x1b[0m \x1b[36mserver\x1b[0m: request \x1b[1mid\x1b[0m=\x1b[33m{}\x1b[0m \x1b[1mstatus\x1b[0m=\x1b[32m200\x1b[0m\r\n",
+                    i % 60,
+                    i
+                )
+                .as_bytes(),
+            );
+        }
+        data
+    };
+
+    group.bench_function("colorized_log", |b| {
+        b.iter(|| {
+            let mut parser = Parser::new();
+            let mut performer = NoOpPerformer;
+            parser.advance(&mut performer, std_black_box(&colorized_log));
+        });
+    });
+
+    // Syntax-highlighted diff with 256-color and truecolor SGR per token
+    let highlighted_diff = {
+        let mut data = Vec::new();
+        for i in 0..500 {
+            data.extend_from_slice(
+                format!(
+                    "\x1b[48;2;30;60;30m\x1b[38;5;34m+\x1b[38;2;198;120;221mfn\x1b[39m \x1b[38;2;97;175;239mfunction_{}\x1b[38;2;171;178;191m() -> \x1b[38;2;229;192;123mResult\x1b[38;2;171;178;191m<(), \x1b[38;2;229;192;123mError\x1b[38;2;171;178;191m> {{\x1b[0m\x1b[K\r\n",
+                    i
+                )
+                .as_bytes(),
+            );
+        }
+        data
+    };
+
+    group.bench_function("highlighted_diff", |b| {
+        b.iter(|| {
+            let mut parser = Parser::new();
+            let mut performer = NoOpPerformer;
+            parser.advance(&mut performer, std_black_box(&highlighted_diff));
+        });
+    });
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_parser_advance,
     bench_parser_advance_chunked,
     bench_parser_advance_until_terminated,
     bench_utf8_scenarios,
-    bench_real_world_scenarios
+    bench_real_world_scenarios,
+    bench_sgr_heavy
 );
 criterion_main!(benches);
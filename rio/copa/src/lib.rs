@@ -648,9 +648,7 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
 
         // If the next character is ESC, just process it and short-circuit.
         if plain_chars == 0 {
-            self.state = State::Escape;
-            self.reset_params();
-            return 1;
+            return 1 + self.advance_ground_esc(performer, &bytes[1..]);
         }
 
         match simdutf8::basic::from_utf8(&bytes[..plain_chars]) {
@@ -660,9 +658,8 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
 
                 // If there's another character, it must be escape so process it directly.
                 if processed < num_bytes {
-                    self.state = State::Escape;
-                    self.reset_params();
-                    processed += 1;
+                    processed +=
+                        1 + self.advance_ground_esc(performer, &bytes[processed + 1..]);
                 }
 
                 processed
@@ -718,7 +715,71 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
         }
     }
 
+    /// Handle an ESC found in the ground state.
+    ///
+    /// Complete CSI sequences with only numeric parameters (the common
+    /// `ESC [ 38 ; 5 ; 196 m` SGR case) are parsed in a single scan and
+    /// dispatched directly, leaving the parser in ground state. Anything else
+    /// enters the escape state and goes through the state machine.
+    ///
+    /// Returns the number of bytes consumed after the ESC.
+    #[inline]
+    fn advance_ground_esc<P: Perform>(&mut self, performer: &mut P, bytes: &[u8]) -> usize {
+        self.reset_params();
+
+        if bytes.first() == Some(&b'[') {
+            if let Some(len) = self.advance_csi_fast(performer, &bytes[1..]) {
+                return 1 + len;
+            }
+            self.reset_params();
+        }
+
+        self.state = State::Escape;
+        0
+    }
+
+    /// Parse and dispatch a complete CSI sequence following `ESC [`.
+    ///
+    /// Only digits, `;` and `:` are accepted before the final byte, so the
+    /// result is identical to the state machine. Returns `None` without
+    /// dispatching when the sequence is incomplete, has private markers,
+    /// intermediates or control characters, or overflows the parameter list.
+    #[inline]
+    fn advance_csi_fast<P: Perform>(
+        &mut self,
+        performer: &mut P,
+        bytes: &[u8],
+    ) -> Option<usize> {
+        let mut i = 0;
+
+        loop {
+            let (param, digits) = parse_param_swar(&bytes[i..]);
+            i += digits;
+
+            let byte = *bytes.get(i)?;
+            i += 1;
+
+            if self.params.is_full() {
+                return None;
+            }
+
+            match byte {
+                b';' => self.params.push(param),
+                b':' => self.params.extend(param),
+                0x40..=0x7E => {
+                    self.params.push(param);
+                    performer.csi_dispatch(self.params(), &[], false, byte as char);
+                    return Some(i);
+                }
+                _ => return None,
+            }
+        }
+    }
+
     /// Advance the parser while processing a partial utf8 codepoint.
+    ///
+    /// Completed codepoints go through [`Self::ground_dispatch`] like any other
+    /// ground text, so a C1 control split across two reads is still executed.
     #[inline]
     fn advance_partial_utf8<P: Perform>(
         &mut self,
@@ -737,7 +798,7 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
             // If the entire buffer is valid, use the first character and continue parsing.
             Ok(parsed) => {
                 let c = unsafe { parsed.chars().next().unwrap_unchecked() };
-                performer.print(c);
+                Self::ground_dispatch(performer, c.encode_utf8(&mut [0; 4]));
 
                 self.partial_utf8_len = 0;
                 c.len_utf8() - old_bytes
@@ -751,8 +812,8 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
                 let valid_bytes = compat_err.valid_up_to();
 
                 // If we have any valid bytes, that means we partially copied another
-                // utf8 character into `partial_utf8`. Since we only care about the
-                // first character, we just ignore the rest.
+                // utf8 character into `partial_utf8`. Only the first character is
+                // consumed here, the rest is parsed again from `bytes`.
                 if valid_bytes > 0 {
                     let c = unsafe {
                         let parsed =
@@ -760,10 +821,10 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
                         parsed.chars().next().unwrap_unchecked()
                     };
 
-                    performer.print(c);
+                    Self::ground_dispatch(performer, c.encode_utf8(&mut [0; 4]));
 
                     self.partial_utf8_len = 0;
-                    return valid_bytes - old_bytes;
+                    return c.len_utf8() - old_bytes;
                 }
 
                 match compat_err.error_len() {
@@ -783,17 +844,98 @@ impl<const OSC_RAW_BUF_SIZE: usize> Parser<OSC_RAW_BUF_SIZE> {
     }
 
     /// Handle ground dispatch of print/execute for all characters in a string.
+    ///
+    /// Printable runs between control characters are handed to
+    /// [`Perform::print_str`] in one call, so performers can write them in bulk.
     #[inline]
     fn ground_dispatch<P: Perform>(performer: &mut P, text: &str) {
-        for c in text.chars() {
-            match c {
-                '\x00'..='\x1f' | '\u{80}'..='\u{9f}' => performer.execute(c as u8),
-                _ => performer.print(c),
+        let bytes = text.as_bytes();
+        let mut start = 0;
+        let mut i = 0;
+
+        while i < bytes.len() {
+            let byte = bytes[i];
+
+            // C0 controls are single bytes, C1 controls are encoded as `C2 80..=9F`.
+            // Neither byte can appear inside another UTF-8 sequence, so `i` is
+            // always on a char boundary here.
+            let control = if byte < 0x20 {
+                Some((byte, 1))
+            } else if byte == 0xC2 && matches!(bytes.get(i + 1), Some(0x80..=0x9F)) {
+                Some((bytes[i + 1], 2))
+            } else {
+                None
+            };
+
+            match control {
+                Some((control, len)) => {
+                    if start < i {
+                        performer.print_str(unsafe { text.get_unchecked(start..i) });
+                    }
+                    performer.execute(control);
+                    i += len;
+                    start = i;
+                }
+                None => i += 1,
             }
         }
+
+        if start < bytes.len() {
+            performer.print_str(unsafe { text.get_unchecked(start..) });
+        }
     }
 }
 
+/// Parse the ASCII digits at the start of `bytes` as a CSI parameter.
+///
+/// Up to eight digits are classified and combined at once using SWAR
+/// arithmetic on a `u64`; longer parameters continue byte by byte. Values
+/// saturate at `u16::MAX`, like the state machine.
+///
+/// Returns the parameter value and the number of digits consumed.
+#[inline]
+fn parse_param_swar(bytes: &[u8]) -> (u16, usize) {
+    let mut buf = [0u8; 8];
+    let len = bytes.len().min(8);
+    buf[..len].copy_from_slice(&bytes[..len]);
+    let chunk = u64::from_le_bytes(buf);
+
+    // A byte is a digit when its high nibble is 3 and its low nibble is <= 9.
+    let high = (chunk & 0xF0F0_F0F0_F0F0_F0F0) ^ 0x3030_3030_3030_3030;
+    let low = ((chunk & 0x0F0F_0F0F_0F0F_0F0F) + 0x0606_0606_0606_0606)
+        & 0xF0F0_F0F0_F0F0_F0F0;
+    let non_digits = high | low;
+    let digits = if non_digits == 0 {
+        8
+    } else {
+        (non_digits.trailing_zeros() / 8) as usize
+    };
+
+    if digits == 0 {
+        return (0, 0);
+    }
+
+    // Left-align the digits so the missing ones act as leading zeros, then
+    // combine pairs, quads and octets of digits.
+    let mut value = (chunk & 0x0F0F_0F0F_0F0F_0F0F) << (8 * (8 - digits));
+    value = value.wrapping_mul(10).wrapping_add(value >> 8) & 0x00FF_00FF_00FF_00FF;
+    value = value.wrapping_mul(100).wrapping_add(value >> 16) & 0x0000_FFFF_0000_FFFF;
+    value =
+        value.wrapping_mul(10000).wrapping_add(value >> 32) & 0x0000_0000_FFFF_FFFF;
+
+    let mut param = value.min(u16::MAX as u64) as u16;
+    let mut consumed = digits;
+
+    if digits == 8 {
+        while let Some(&byte) = bytes.get(consumed).filter(|byte| byte.is_ascii_digit()) {
+            param = param.saturating_mul(10).saturating_add((byte - b'0') as u16);
+            consumed += 1;
+        }
+    }
+
+    (param, consumed)
+}
+
 #[derive(PartialEq, Eq, Debug, Default, Copy, Clone)]
 enum State {
     CsiEntry,
@@ -829,6 +971,18 @@ pub trait Perform {
     /// Draw a character to the screen and update states.
     fn print(&mut self, _c: char) {}
 
+    /// Draw a run of printable characters to the screen.
+    ///
+    /// The string never contains C0 or C1 control characters. The default
+    /// implementation forwards each character to [`Perform::print`]; override
+    /// it to write whole runs at once.
+    #[inline]
+    fn print_str(&mut self, text: &str) {
+        for c in text.chars() {
+            self.print(c);
+        }
+    }
+
     /// Execute a C0 or C1 control function.
     fn execute(&mut self, _byte: u8) {}
 
@@ -1902,4 +2056,253 @@ mod tests {
         assert_eq!(dispatcher.dispatched[0], Sequence::Execute(0x18));
         assert_eq!(dispatcher.dispatched[1], Sequence::Execute(0x1A));
     }
+
+    #[test]
+    fn print_str_runs() {
+        #[derive(Default)]
+        struct RunDispatcher {
+            dispatched: Vec<Sequence>,
+            runs: Vec<std::string::String>,
+        }
+
+        impl Perform for RunDispatcher {
+            fn print(&mut self, c: char) {
+                self.dispatched.push(Sequence::Print(c));
+            }
+
+            fn print_str(&mut self, text: &str) {
+                self.runs.push(text.into());
+            }
+
+            fn execute(&mut self, byte: u8) {
+                self.dispatched.push(Sequence::Execute(byte));
+            }
+        }
+
+        const INPUT: &str = "hello\r\nwörld\u{85}ab\x1b[mcd";
+
+        let mut dispatcher = RunDispatcher::default();
+        let mut parser = Parser::new();
+
+        parser.advance(&mut dispatcher, INPUT.as_bytes());
+
+        assert_eq!(dispatcher.runs, ["hello", "wörld", "ab", "cd"]);
+        assert_eq!(
+            dispatcher.dispatched,
+            [
+                Sequence::Execute(b'\r'),
+                Sequence::Execute(b'\n'),
+                Sequence::Execute(0x85)
+            ]
+        );
+    }
+
+    #[test]
+    fn parse_param_swar_digits() {
+        assert_eq!(parse_param_swar(b""), (0, 0));
+        assert_eq!(parse_param_swar(b"m"), (0, 0));
+        assert_eq!(parse_param_swar(b"0;"), (0, 1));
+        assert_eq!(parse_param_swar(b"38;5"), (38, 2));
+        assert_eq!(parse_param_swar(b"255m"), (255, 3));
+        assert_eq!(parse_param_swar(b"0012:"), (12, 4));
+        assert_eq!(parse_param_swar(b"65535"), (65535, 5));
+        assert_eq!(parse_param_swar(b"65536"), (65535, 5));
+        assert_eq!(parse_param_swar(b"1234567/"), (65535, 7));
+        assert_eq!(parse_param_swar(b"00000042"), (42, 8));
+        assert_eq!(parse_param_swar(b"000000000007m"), (7, 12));
+        assert_eq!(parse_param_swar(b"99999999999"), (65535, 11));
+    }
+
+    #[test]
+    fn csi_fast_path_matches_state_machine() {
+        const INPUTS: &[&[u8]] = &[
+            b"\x1b[m",
+            b"\x1b[;m",
+            b"a\x1b[1;31mred\x1b[0m",
+            b"\x1b[38;5;196m\x1b[48;2;10;20;30m",
+            b"\x1b[4:3m\x1b[58:2::255:0:0m",
+            b"\x1b[99999999999;0010H",
+            b"\x1b[?25l\x1b[?2026h",
+            b"\x1b[ q\x1b[2 q",
+            b"\x1b[1;\x0a2m",
+            b"\x1b[1;3",
+            b"\x1b[0;1;2;3;4;5;6;7;8;9;0;1;2;3;4;5;6;7;8;9;0;1;2;3;4;5;6;7;8;9;0;1;2m",
+        ];
+
+        for input in INPUTS {
+            let mut bulk = Dispatcher::default();
+            let mut parser = Parser::new();
+            parser.advance(&mut bulk, input);
+
+            // Feeding one byte at a time never sees `ESC [` in ground state.
+            let mut bytewise = Dispatcher::default();
+            let mut parser = Parser::new();
+            for byte in input.iter() {
+                parser.advance(&mut bytewise, &[*byte]);
+            }
+
+            assert_eq!(bulk.dispatched, bytewise.dispatched, "input: {:?}", input);
+        }
+    }
+
+    #[test]
+    fn partial_utf8_c1_control() {
+        let mut dispatcher = Dispatcher::default();
+        let mut parser = Parser::new();
+
+        parser.advance(&mut dispatcher, b"\xc2");
+        parser.advance(&mut dispatcher, b"\x85a");
+
+        assert_eq!(
+            dispatcher.dispatched,
+            [Sequence::Execute(0x85), Sequence::Print('a')]
+        );
+    }
+
+    #[test]
+    fn partial_utf8_followed_by_partial_utf8() {
+        let mut dispatcher = Dispatcher::default();
+        let mut parser = Parser::new();
+
+        // Completing `\u{301}` copies `w` and half of `ö` into the partial buffer.
+        parser.advance(&mut dispatcher, b"\xcc");
+        parser.advance(&mut dispatcher, "\u{301}wö".as_bytes().split_at(1).1);
+
+        assert_eq!(
+            dispatcher.dispatched,
+            [
+                Sequence::Print('\u{301}'),
+                Sequence::Print('w'),
+                Sequence::Print('ö')
+            ]
+        );
+    }
+
+    /// Xorshift generator, so differential runs are reproducible from a seed
+    /// without a fuzzing dependency.
+    struct Rng(u64);
+
+    impl Rng {
+        fn next(&mut self) -> u64 {
+            self.0 ^= self.0 << 13;
+            self.0 ^= self.0 >> 7;
+            self.0 ^= self.0 << 17;
+            self.0
+        }
+
+        fn below(&mut self, n: usize) -> usize {
+            (self.next() % n as u64) as usize
+        }
+    }
+
+    /// Building blocks biased towards the fast paths and their edges.
+    const FRAGMENTS: &[&[u8]] = &[
+        b"hello world ",
+        b"\r\n",
+        b"\t",
+        b"\x08",
+        "wörld ".as_bytes(),
+        "漢字".as_bytes(),
+        "👍🏽".as_bytes(),
+        "e\u{301}".as_bytes(),
+        b"\xc2\x85",
+        b"\xc2\x9b1m",
+        b"\xff",
+        b"\xe6\xbc",
+        b"\x1b[m",
+        b"\x1b[1;31m",
+        b"\x1b[38;5;196m",
+        b"\x1b[48;2;1;2;3m",
+        b"\x1b[4:3m",
+        b"\x1b[58:2::255:0:0m",
+        b"\x1b[99999999999;7H",
+        b"\x1b[;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;m",
+        b"\x1b[?25l",
+        b"\x1b[?2026h",
+        b"\x1b[?2026l",
+        b"\x1b[ q",
+        b"\x1b[>c",
+        b"\x1b[1;\x0a2m",
+        b"\x1b[",
+        b"\x1b",
+        b"\x1b7\x1b8",
+        b"\x1b(0",
+        b"\x1b]0;title\x07",
+        b"\x1b]8;;https://example.com\x1b\\",
+        b"\x1bP1$r0m\x1b\\",
+        b"\x1b_apc\x1b\\",
+        b"\x18",
+    ];
+
+    fn random_stream(rng: &mut Rng, len: usize) -> Vec<u8> {
+        let mut stream = Vec::with_capacity(len + 64);
+        while stream.len() < len {
+            if rng.below(8) == 0 {
+                stream.push(rng.next() as u8);
+            } else {
+                stream.extend_from_slice(FRAGMENTS[rng.below(FRAGMENTS.len())]);
+            }
+        }
+        stream
+    }
+
+    /// Flip, insert and delete a few bytes of a real capture.
+    fn mutate(rng: &mut Rng, input: &[u8]) -> Vec<u8> {
+        let start = rng.below(input.len());
+        let end = (start + 1 + rng.below(1024)).min(input.len());
+        let mut stream = input[start..end].to_vec();
+        for _ in 0..1 + rng.below(8) {
+            let at = rng.below(stream.len() + 1);
+            match rng.below(3) {
+                0 if at < stream.len() => stream[at] ^= 1 << rng.below(8),
+                1 if at < stream.len() => {
+                    stream.remove(at);
+                }
+                _ => stream.insert(at, rng.next() as u8),
+            }
+        }
+        stream
+    }
+
+    fn dispatch_chunked(input: &[u8], chunks: &[usize]) -> Vec<Sequence> {
+        let mut dispatcher = Dispatcher::default();
+        let mut parser = Parser::new();
+        let mut rest = input;
+        for &len in chunks {
+            let (chunk, tail) = rest.split_at(len.min(rest.len()));
+            parser.advance(&mut dispatcher, chunk);
+            rest = tail;
+        }
+        parser.advance(&mut dispatcher, rest);
+        dispatcher.dispatched
+    }
+
+    #[test]
+    fn differential_random_streams() {
+        let demo = include_bytes!("../tests/demo.vte");
+        let mut rng = Rng(0x9E37_79B9_7F4A_7C15);
+
+        for case in 0..2000 {
+            let input = if case % 4 == 0 {
+                mutate(&mut rng, demo)
+            } else {
+                let len = 1 + rng.below(512);
+                random_stream(&mut rng, len)
+            };
+
+            // Byte-at-a-time never takes the bulk ground or CSI fast paths.
+            let bytewise = dispatch_chunked(&input, &vec![1; input.len()]);
+
+            let bulk = dispatch_chunked(&input, &[]);
+            assert_eq!(bulk, bytewise, "case {case}, bulk: {input:?}");
+
+            let chunks: Vec<usize> =
+                (0..1 + rng.below(16)).map(|_| rng.below(64)).collect();
+            let chunked = dispatch_chunked(&input, &chunks);
+            assert_eq!(
+                chunked, bytewise,
+                "case {case}, chunks {chunks:?}: {input:?}"
+            );
+        }
+    }
 }
@@ -1,5 +1,7 @@
 extern crate corcovado;
 extern crate criterion;
+#[cfg(unix)]
+extern crate libc;
 
 use corcovado::*;
 use criterion::{criterion_group, criterion_main, Criterion};
@@ -47,5 +49,175 @@ fn bench_poll(c: &mut Criterion) {
     });
 }
 
-criterion_group!(benches, bench_poll);
+/// Many PTY-like fds (nonblocking pipes) registered on a single `Poll`.
+///
+/// Every iteration writes a small chunk into each pipe and then harvests the
+/// readiness of all of them, comparing the oneshot + reregister pattern against
+/// the re-arm-free edge and level modes, and a single large `Events` batch
+/// against harvesting one event per `epoll_wait`.
+#[cfg(unix)]
+mod many_fds {
+    use corcovado::unix::EventedFd;
+    use corcovado::*;
+    use criterion::Criterion;
+    use libc;
+    use std::io;
+
+    const FDS: usize = 256;
+    const CHUNK: &[u8] = &[b'x'; 64];
+
+    struct Pipe {
+        read: libc::c_int,
+        write: libc::c_int,
+    }
+
+    impl Pipe {
+        fn new() -> Pipe {
+            let mut fds = [0; 2];
+            unsafe {
+                assert_eq!(libc::pipe(fds.as_mut_ptr()), 0);
+                for fd in &fds {
+                    let flags = libc::fcntl(*fd, libc::F_GETFL);
+                    libc::fcntl(*fd, libc::F_SETFL, flags | libc::O_NONBLOCK);
+                }
+            }
+            Pipe {
+                read: fds[0],
+                write: fds[1],
+            }
+        }
+
+        fn feed(&self) {
+            let n = unsafe {
+                libc::write(self.write, CHUNK.as_ptr() as *const _, CHUNK.len())
+            };
+            assert_eq!(n, CHUNK.len() as isize);
+        }
+
+        /// Read until the pipe would block, like `Machine::pty_read` does.
+        fn drain(&self, buf: &mut [u8]) {
+            loop {
+                let n = unsafe {
+                    libc::read(self.read, buf.as_mut_ptr() as *mut _, buf.len())
+                };
+                if n < 0 {
+                    let err = io::Error::last_os_error();
+                    assert_eq!(err.kind(), io::ErrorKind::WouldBlock);
+                    return;
+                }
+            }
+        }
+
+        /// A single read, enough to empty the pipe with a large buffer.
+        fn read_once(&self, buf: &mut [u8]) {
+            let n =
+                unsafe { libc::read(self.read, buf.as_mut_ptr() as *mut _, buf.len()) };
+            assert_eq!(n, CHUNK.len() as isize);
+        }
+    }
+
+    impl Drop for Pipe {
+        fn drop(&mut self) {
+            unsafe {
+                libc::close(self.read);
+                libc::close(self.write);
+            }
+        }
+    }
+
+    #[derive(Clone, Copy)]
+    enum Mode {
+        /// `edge | oneshot`, drain and reregister after every event.
+        Oneshot,
+        /// `edge`, drain until `WouldBlock`, never reregister.
+        Edge,
+        /// `level`, one read per event, never reregister.
+        Level,
+    }
+
+    impl Mode {
+        fn opts(self) -> PollOpt {
+            match self {
+                Mode::Oneshot => PollOpt::edge() | PollOpt::oneshot(),
+                Mode::Edge => PollOpt::edge(),
+                Mode::Level => PollOpt::level(),
+            }
+        }
+    }
+
+    fn setup(mode: Mode) -> (Poll, Vec<Pipe>) {
+        let poll = Poll::new().unwrap();
+        let pipes: Vec<Pipe> = (0..FDS).map(|_| Pipe::new()).collect();
+        for (i, pipe) in pipes.iter().enumerate() {
+            poll.register(
+                &EventedFd(&pipe.read),
+                Token(i),
+                Ready::readable(),
+                mode.opts(),
+            )
+            .unwrap();
+        }
+        (poll, pipes)
+    }
+
+    fn round(
+        poll: &Poll,
+        pipes: &[Pipe],
+        events: &mut Events,
+        mode: Mode,
+        buf: &mut [u8],
+    ) {
+        for pipe in pipes {
+            pipe.feed();
+        }
+
+        let mut n = 0;
+        while n < FDS {
+            poll.poll(events, None).unwrap();
+            for event in events.iter() {
+                let pipe = &pipes[event.token().0];
+                match mode {
+                    Mode::Oneshot => {
+                        pipe.drain(buf);
+                        poll.reregister(
+                            &EventedFd(&pipe.read),
+                            event.token(),
+                            Ready::readable(),
+                            mode.opts(),
+                        )
+                        .unwrap();
+                    }
+                    Mode::Edge => pipe.drain(buf),
+                    Mode::Level => pipe.read_once(buf),
+                }
+                n += 1;
+            }
+        }
+    }
+
+    fn bench_mode(c: &mut Criterion, name: &str, mode: Mode, capacity: usize) {
+        let (poll, pipes) = setup(mode);
+        let mut events = Events::with_capacity(capacity);
+        let mut buf = [0u8; 4096];
+
+        c.bench_function(name, |b| {
+            b.iter(|| round(&poll, &pipes, &mut events, mode, &mut buf))
+        });
+    }
+
+    pub fn bench_many_fds(c: &mut Criterion) {
+        bench_mode(c, "many_fds_oneshot_rearm", Mode::Oneshot, 1024);
+        bench_mode(c, "many_fds_edge", Mode::Edge, 1024);
+        bench_mode(c, "many_fds_level", Mode::Level, 1024);
+        bench_mode(c, "many_fds_edge_one_event_per_poll", Mode::Edge, 1);
+    }
+}
+
+#[cfg(unix)]
+use many_fds::bench_many_fds;
+
+#[cfg(not(unix))]
+fn bench_many_fds(_: &mut Criterion) {}
+
+criterion_group!(benches, bench_poll, bench_many_fds);
 criterion_main!(benches);
@@ -86,9 +86,11 @@ impl Selector {
             let cnt = cnt as usize;
             evts.events.set_len(cnt);
 
+            // Event order carries no meaning, so drop the awakener without
+            // shifting the rest of a large batch.
             for i in 0..cnt {
                 if evts.events[i].u64 as usize == awakener.into() {
-                    evts.events.remove(i);
+                    evts.events.swap_remove(i);
                     return Ok(true);
                 }
             }
@@ -0,0 +1,94 @@
+//! Benchmark the bulk `input_str` write path against per-char `input`
+//! on a plain-text flood (e.g. `cat` of a large log file).
+//!
+//! Run with: cargo run --release --example print_str_benchmark
+
+#![allow(clippy::uninlined_format_args)]
+
+use rio_backend::ansi::CursorShape;
+use rio_backend::crosswords::{Crosswords, CrosswordsSize};
+use rio_backend::event::{VoidListener, WindowId};
+use rio_backend::performer::handler::{Handler, Processor};
+use std::time::{Duration, Instant};
+
+const COLUMNS: usize = 120;
+const LINES: usize = 40;
+const FLOOD_LINES: usize = 20_000;
+const ITERATIONS: usize = 5;
+
+fn new_terminal() -> Crosswords<VoidListener> {
+    let size = CrosswordsSize::new(COLUMNS, LINES);
+    Crosswords::new(size, CursorShape::Block, VoidListener {}, WindowId::from(0), 0)
+}
+
+fn flood_lines() -> Vec<String> {
+    (0..FLOOD_LINES)
+        .map(|i| {
+            format!(
+                "{:>6} 2024-05-01T12:00:{:02}Z INFO request handled path=/api/v1/items/{} status=200 elapsed={}ms",
+                i,
+                i % 60,
+                i * 7,
+                i % 250
+            )
+        })
+        .collect()
+}
+
+fn run<F: FnMut()>(name: &str, bytes: usize, mut f: F) -> Duration {
+    let start = Instant::now();
+    for _ in 0..ITERATIONS {
+        f();
+    }
+    let elapsed = start.elapsed() / ITERATIONS as u32;
+    let throughput = bytes as f64 / elapsed.as_secs_f64() / (1024.0 * 1024.0);
+    println!("{:<24} {:>10.2?} {:>10.1} MB/s", name, elapsed, throughput);
+    elapsed
+}
+
+fn main() {
+    let lines = flood_lines();
+    let flood: String = lines.iter().map(|line| format!("{line}\r\n")).collect();
+    let bytes = flood.len();
+
+    println!(
+        "Plain-text flood: {} lines, {} KB, {}x{} grid\n",
+        FLOOD_LINES,
+        bytes / 1024,
+        COLUMNS,
+        LINES
+    );
+
+    let per_char = run("input (per char)", bytes, || {
+        let mut term = new_terminal();
+        for line in &lines {
+            for c in line.chars() {
+                term.input(c);
+            }
+            term.carriage_return();
+            term.linefeed();
+        }
+    });
+
+    let bulk = run("input_str (bulk)", bytes, || {
+        let mut term = new_terminal();
+        for line in &lines {
+            term.input_str(line);
+            term.carriage_return();
+            term.linefeed();
+        }
+    });
+
+    run("Processor::advance", bytes, || {
+        let mut term = new_terminal();
+        let mut processor: Processor = Processor::new();
+        for chunk in flood.as_bytes().chunks(4096) {
+            processor.advance(&mut term, chunk);
+        }
+    });
+
+    println!(
+        "\ninput_str speedup: {:.2}x",
+        per_char.as_secs_f64() / bulk.as_secs_f64()
+    );
+}
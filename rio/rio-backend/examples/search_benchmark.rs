@@ -0,0 +1,115 @@
+//! Benchmark the literal search fast path against the regex DFAs on a
+//! 1M-line scrollback, the way the find bar searches it.
+//!
+//! The grid is kept narrow, it still needs about 1GB of memory.
+//!
+//! Run with: cargo run --release --example search_benchmark
+
+#![allow(clippy::uninlined_format_args)]
+
+use rio_backend::ansi::CursorShape;
+use rio_backend::crosswords::grid::Dimensions;
+use rio_backend::crosswords::search::{RegexSearch, SearchQuery};
+use rio_backend::crosswords::{compile_search, Crosswords, SearchError};
+use rio_backend::event::{VoidListener, WindowId};
+use rio_backend::performer::handler::Handler;
+use std::time::{Duration, Instant};
+
+const COLUMNS: usize = 48;
+const SCREEN_LINES: usize = 40;
+const HISTORY_LINES: usize = 1_000_000;
+const ITERATIONS: usize = 3;
+
+struct Size;
+
+impl Dimensions for Size {
+    fn total_lines(&self) -> usize {
+        HISTORY_LINES + SCREEN_LINES
+    }
+
+    fn screen_lines(&self) -> usize {
+        SCREEN_LINES
+    }
+
+    fn columns(&self) -> usize {
+        COLUMNS
+    }
+}
+
+fn filled_terminal() -> Crosswords<VoidListener> {
+    let mut term = Crosswords::new(
+        Size,
+        CursorShape::Block,
+        VoidListener {},
+        WindowId::from(0),
+        0,
+    );
+    for i in 0..HISTORY_LINES + SCREEN_LINES {
+        let level = if i % 997 == 0 { "ERROR" } else { "INFO" };
+        term.input_str(&format!(
+            "{:>7} {} GET /api/v1/items/{} status=200",
+            i,
+            level,
+            i * 7
+        ));
+        term.carriage_return();
+        term.linefeed();
+    }
+    term
+}
+
+fn regex_query(pattern: &str, is_regex: bool) -> Result<SearchQuery, SearchError> {
+    let pattern = rio_backend::crosswords::search_pattern(pattern, is_regex, false);
+    RegexSearch::new(&pattern)
+        .map(|regex| SearchQuery::Regex(Box::new(regex)))
+        .map_err(|_| SearchError::InvalidPattern)
+}
+
+fn run(name: &str, term: &Crosswords<VoidListener>, query: &SearchQuery) -> Duration {
+    let mut count = 0;
+    let start = Instant::now();
+    for _ in 0..ITERATIONS {
+        let mut query = query.clone();
+        count = 0;
+        term.search_matches(
+            &mut query,
+            None,
+            |_| {
+                count += 1;
+                true
+            },
+            || false,
+        );
+    }
+    let elapsed = start.elapsed() / ITERATIONS as u32;
+    println!("{:<36} {:>10.2?} {:>8} matches", name, elapsed, count);
+    elapsed
+}
+
+fn main() {
+    println!(
+        "Filling {} lines of scrollback ({} columns)...",
+        HISTORY_LINES, COLUMNS
+    );
+    let term = filled_terminal();
+    println!();
+
+    for query in ["error", "items/7000", "no such text"] {
+        let literal = compile_search(query, false, false).unwrap();
+        assert!(matches!(literal, SearchQuery::Literal(_)));
+        let regex = regex_query(query, false).unwrap();
+
+        let literal = run(&format!("literal  {:?}", query), &term, &literal);
+        let regex = run(&format!("regex    {:?}", query), &term, &regex);
+        println!(
+            "{:<36} {:>9.2}x\n",
+            "speedup",
+            regex.as_secs_f64() / literal.as_secs_f64()
+        );
+    }
+
+    // Real patterns still go through the DFAs.
+    let pattern = compile_search(r"status=\d{3}", true, false).unwrap();
+    assert!(matches!(pattern, SearchQuery::Regex(_)));
+    run("regex    \"status=\\d{3}\"", &term, &pattern);
+}
@@ -140,6 +140,25 @@ impl Graphics {
         !self.pending.is_empty() || !self.texture_operations.lock().is_empty()
     }
 
+    /// Bytes held on the heap by graphics not handed to the renderer yet and
+    /// by the Sixel picture being parsed.
+    pub fn heap_size(&self) -> usize {
+        self.pending.capacity() * mem::size_of::<GraphicData>()
+            + self
+                .pending
+                .iter()
+                .map(|graphic| graphic.pixels.capacity())
+                .sum::<usize>()
+            + self
+                .sixel_shared_palette
+                .as_ref()
+                .map_or(0, |palette| palette.capacity() * mem::size_of::<ColorRgb>())
+            + self
+                .sixel_parser
+                .as_ref()
+                .map_or(0, |parser| parser.heap_size())
+    }
+
     pub fn take_queues(&mut self) -> Option<UpdateQueues> {
         let remove_queue = {
             let mut queue = self.texture_operations.lock();
@@ -509,6 +509,12 @@ impl Parser {
         Ok(())
     }
 
+    /// Bytes held on the heap by the picture being parsed.
+    pub fn heap_size(&self) -> usize {
+        self.pixels.capacity() * mem::size_of::<ColorRegister>()
+            + self.color_registers.capacity() * mem::size_of::<ColorRgb>()
+    }
+
     /// Returns the final graphic to append to the grid, with the palette
     /// built in the process.
     pub fn finish(mut self) -> Result<(GraphicData, Vec<ColorRgb>), Error> {
@@ -137,19 +137,12 @@ impl<const OSC_RAW_BUF_SIZE: usize> BatchedParser<OSC_RAW_BUF_SIZE> {
             return self.parser.advance_until_terminated(performer, bytes);
         }
 
-        // For large inputs, use batching
-        self.input_buffer.extend_from_slice(bytes);
-        let bytes_added = bytes.len();
-
-        // Process immediately if we have a large batch
-        if self.input_buffer.len() >= self.batch_threshold {
-            let batch_size = self.input_buffer.len();
-            self.stats.record_batch(batch_size);
-            self.flush_batch(performer);
-        }
-
-        // Always return the number of bytes we just processed
-        bytes_added
+        // Large inputs are already a batch, parse them in place. This must
+        // still stop at termination: a synchronized update starting inside the
+        // batch has to leave the remaining bytes to the caller.
+        self.stats.record_batch(bytes.len());
+        self.flush(performer);
+        self.parser.advance_until_terminated(performer, bytes)
     }
 }
 
@@ -266,6 +259,37 @@ mod tests {
         assert!(performer.chars_received.iter().all(|&c| c == 'A'));
     }
 
+    #[test]
+    fn test_batched_parser_large_input_stops_when_terminated() {
+        struct StopAfter {
+            chars_received: Vec<char>,
+            limit: usize,
+        }
+
+        impl Perform for StopAfter {
+            fn print(&mut self, c: char) {
+                self.chars_received.push(c);
+            }
+
+            fn terminated(&self) -> bool {
+                self.chars_received.len() >= self.limit
+            }
+        }
+
+        let mut parser = BatchedParser::<1024>::new();
+        let mut performer = StopAfter {
+            chars_received: Vec::new(),
+            limit: 3,
+        };
+
+        // Termination is checked between escapes, one char per ground run.
+        let input = "A\x1b[m".repeat(256);
+        let processed = parser.advance_until_terminated(&mut performer, input.as_bytes());
+
+        assert_eq!(performer.chars_received.len(), 3);
+        assert!(processed < input.len());
+    }
+
     #[test]
     fn test_batch_stats() {
         let mut stats = BatchStats::default();
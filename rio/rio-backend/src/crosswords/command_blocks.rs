@@ -0,0 +1,326 @@
+//! Command blocks recorded from shell integration marks (OSC 133).
+//!
+//! Every prompt the shell draws starts a [`CommandBlock`]. The block records
+//! where the prompt, the command input and the command output are, together
+//! with the command line, exit code and timing reported by the shell.
+//!
+//! Positions are absolute lines (see [`Grid::absolute_line`]), so they stay
+//! attached to their content while the storage rotates lines into history.
+//! Blocks are kept in prompt order, which makes jumping between prompts a
+//! binary search and the last command a lookup at the back of the index.
+//!
+//! [`Grid::absolute_line`]: super::grid::Grid::absolute_line
+
+use crate::crosswords::pos::Column;
+use std::collections::VecDeque;
+use std::time::{Duration, Instant};
+
+/// Blocks kept per terminal, the oldest ones are dropped first.
+pub const MAX_COMMAND_BLOCKS: usize = 1024;
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct CommandBlock {
+    /// Line of the prompt (OSC 133;A).
+    pub prompt_line: usize,
+    /// Where the command input starts, after the prompt (OSC 133;B).
+    pub input_start: Option<(usize, Column)>,
+    /// Command line reported by the shell (OSC 133;C).
+    pub command: Option<String>,
+    /// First line of output (OSC 133;C).
+    pub output_start: Option<usize>,
+    /// End of the output, exclusive (OSC 133;D).
+    pub output_end: Option<usize>,
+    /// Exit code reported by the shell (OSC 133;D).
+    pub exit_code: Option<u8>,
+    pub started_at: Option<Instant>,
+    pub finished_at: Option<Instant>,
+}
+
+impl CommandBlock {
+    fn new(prompt_line: usize) -> CommandBlock {
+        CommandBlock {
+            prompt_line,
+            input_start: None,
+            command: None,
+            output_start: None,
+            output_end: None,
+            exit_code: None,
+            started_at: None,
+            finished_at: None,
+        }
+    }
+
+    /// Whether the command was executed, a prompt that was abandoned with
+    /// Ctrl-C or an empty line never is.
+    #[inline]
+    pub fn is_executed(&self) -> bool {
+        self.output_start.is_some()
+    }
+
+    #[inline]
+    pub fn is_finished(&self) -> bool {
+        self.finished_at.is_some()
+    }
+
+    /// Output lines, `None` until the command has been executed. A running
+    /// command's output ends at `current_line`.
+    pub fn output_lines(&self, current_line: usize) -> Option<(usize, usize)> {
+        let start = self.output_start?;
+        let end = self.output_end.unwrap_or(current_line + 1);
+        Some((start, end.max(start)))
+    }
+
+    /// Time between execution and completion.
+    pub fn duration(&self) -> Option<Duration> {
+        Some(
+            self.finished_at?
+                .saturating_duration_since(self.started_at?),
+        )
+    }
+
+    /// Last line that belongs to this block.
+    fn last_line(&self) -> usize {
+        let input = self.input_start.map_or(self.prompt_line, |(line, _)| line);
+        let output = self.output_end.map(|end| end.saturating_sub(1));
+        [
+            Some(self.prompt_line),
+            Some(input),
+            self.output_start,
+            output,
+        ]
+        .into_iter()
+        .flatten()
+        .max()
+        .unwrap_or(self.prompt_line)
+    }
+}
+
+/// Command blocks of a terminal, in prompt order.
+#[derive(Debug, Default)]
+pub struct CommandBlocks {
+    blocks: VecDeque<CommandBlock>,
+}
+
+impl CommandBlocks {
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.blocks.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.blocks.is_empty()
+    }
+
+    #[inline]
+    pub fn iter(&self) -> impl DoubleEndedIterator<Item = &CommandBlock> {
+        self.blocks.iter()
+    }
+
+    #[inline]
+    pub fn last(&self) -> Option<&CommandBlock> {
+        self.blocks.back()
+    }
+
+    /// Most recent command that ran to completion.
+    pub fn last_finished(&self) -> Option<&CommandBlock> {
+        self.blocks
+            .iter()
+            .rev()
+            .find(|block| block.is_executed() && block.is_finished())
+    }
+
+    pub fn clear(&mut self) {
+        self.blocks.clear();
+    }
+
+    /// OSC 133;A, a new prompt was drawn at `line`.
+    pub fn prompt_start(&mut self, line: usize) {
+        // Prompts are redrawn in place (resize, `zle reset-prompt`), or above
+        // an older one after the screen was cleared. Either way, whatever was
+        // recorded at or below the new prompt is gone.
+        while self
+            .blocks
+            .back()
+            .is_some_and(|block| block.prompt_line >= line)
+        {
+            self.blocks.pop_back();
+        }
+
+        if self.blocks.len() == MAX_COMMAND_BLOCKS {
+            self.blocks.pop_front();
+        }
+        self.blocks.push_back(CommandBlock::new(line));
+    }
+
+    /// OSC 133;B, the command input starts at `line` and `column`.
+    pub fn command_start(&mut self, line: usize, column: Column) {
+        if let Some(block) = self.current() {
+            block.input_start = Some((line, column));
+        }
+    }
+
+    /// OSC 133;C, the command was executed and its output starts at `line`.
+    pub fn command_execute(&mut self, line: usize, command: Option<&str>, now: Instant) {
+        if let Some(block) = self.current() {
+            block.command = command.map(str::to_owned);
+            block.output_start = Some(line);
+            block.started_at = Some(now);
+        }
+    }
+
+    /// OSC 133;D, the command finished with the cursor at `line` and `column`.
+    pub fn command_finished(
+        &mut self,
+        line: usize,
+        column: Column,
+        exit_code: Option<u8>,
+        now: Instant,
+    ) {
+        if let Some(block) = self.current() {
+            // Output without a trailing newline still owns the cursor line.
+            let end = if column.0 > 0 { line + 1 } else { line };
+            if block.is_executed() {
+                block.output_end = Some(end);
+            }
+            block.exit_code = exit_code;
+            block.finished_at = Some(now);
+        }
+    }
+
+    /// Drop blocks that lie entirely above `first_line`, the oldest line still
+    /// in the grid.
+    pub fn prune(&mut self, first_line: usize) {
+        while self
+            .blocks
+            .front()
+            .is_some_and(|block| block.last_line() < first_line)
+        {
+            self.blocks.pop_front();
+        }
+    }
+
+    /// Closest prompt above `line`.
+    pub fn previous_prompt(&self, line: usize) -> Option<usize> {
+        let index = self
+            .blocks
+            .partition_point(|block| block.prompt_line < line);
+        index
+            .checked_sub(1)
+            .map(|index| self.blocks[index].prompt_line)
+    }
+
+    /// Closest prompt below `line`.
+    pub fn next_prompt(&self, line: usize) -> Option<usize> {
+        let index = self
+            .blocks
+            .partition_point(|block| block.prompt_line <= line);
+        self.blocks.get(index).map(|block| block.prompt_line)
+    }
+
+    /// Block `line` belongs to, from its prompt up to the next prompt.
+    pub fn block_at(&self, line: usize) -> Option<&CommandBlock> {
+        let index = self
+            .blocks
+            .partition_point(|block| block.prompt_line <= line);
+        self.blocks.get(index.checked_sub(1)?)
+    }
+
+    /// Block the shell is reporting on, marks for an already finished
+    /// command are ignored.
+    #[inline]
+    fn current(&mut self) -> Option<&mut CommandBlock> {
+        self.blocks.back_mut().filter(|block| !block.is_finished())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn run(blocks: &mut CommandBlocks, prompt: usize, output: usize, end: usize) {
+        let now = Instant::now();
+        blocks.prompt_start(prompt);
+        blocks.command_start(prompt, Column(2));
+        blocks.command_execute(output, Some("ls"), now);
+        blocks.command_finished(end, Column(0), Some(0), now);
+    }
+
+    #[test]
+    fn records_command_lifecycle() {
+        let mut blocks = CommandBlocks::default();
+        let now = Instant::now();
+
+        blocks.prompt_start(3);
+        blocks.command_start(3, Column(2));
+        blocks.command_execute(4, Some("make"), now);
+        assert_eq!(blocks.last().unwrap().output_lines(9), Some((4, 10)));
+        assert!(blocks.last_finished().is_none());
+
+        blocks.command_finished(7, Column(5), Some(2), now + Duration::from_secs(1));
+        let block = blocks.last_finished().unwrap();
+        assert_eq!(block.command.as_deref(), Some("make"));
+        assert_eq!(block.input_start, Some((3, Column(2))));
+        assert_eq!(block.output_lines(20), Some((4, 8)));
+        assert_eq!(block.exit_code, Some(2));
+        assert_eq!(block.duration(), Some(Duration::from_secs(1)));
+
+        // Ctrl-C at the prompt: finished but never executed.
+        blocks.prompt_start(8);
+        blocks.command_finished(8, Column(4), Some(130), now);
+        assert_eq!(blocks.len(), 2);
+        assert_eq!(blocks.last().unwrap().output_lines(20), None);
+        assert_eq!(blocks.last_finished().unwrap().prompt_line, 3);
+    }
+
+    #[test]
+    fn jumps_between_prompts() {
+        let mut blocks = CommandBlocks::default();
+        run(&mut blocks, 0, 1, 5);
+        run(&mut blocks, 5, 6, 10);
+        run(&mut blocks, 10, 11, 11);
+
+        assert_eq!(blocks.previous_prompt(7), Some(5));
+        assert_eq!(blocks.previous_prompt(5), Some(0));
+        assert_eq!(blocks.previous_prompt(0), None);
+        assert_eq!(blocks.next_prompt(5), Some(10));
+        assert_eq!(blocks.next_prompt(10), None);
+        assert_eq!(blocks.block_at(8).unwrap().prompt_line, 5);
+        assert_eq!(blocks.block_at(11).unwrap().prompt_line, 10);
+    }
+
+    #[test]
+    fn redrawn_prompt_replaces_stale_blocks() {
+        let mut blocks = CommandBlocks::default();
+        run(&mut blocks, 0, 1, 5);
+        run(&mut blocks, 5, 6, 10);
+        blocks.prompt_start(10);
+        blocks.prompt_start(10);
+        assert_eq!(blocks.len(), 3);
+
+        // `clear` moved the prompt back up over the old blocks.
+        blocks.prompt_start(4);
+        assert_eq!(
+            blocks.iter().map(|b| b.prompt_line).collect::<Vec<_>>(),
+            [0, 4]
+        );
+    }
+
+    #[test]
+    fn prunes_blocks_rotated_out_of_history() {
+        let mut blocks = CommandBlocks::default();
+        run(&mut blocks, 0, 1, 5);
+        run(&mut blocks, 5, 6, 10);
+
+        blocks.prune(4);
+        assert_eq!(blocks.len(), 2);
+        blocks.prune(5);
+        assert_eq!(blocks.len(), 1);
+        assert_eq!(blocks.previous_prompt(100), Some(5));
+
+        for line in 0..MAX_COMMAND_BLOCKS + 10 {
+            blocks.prompt_start(100 + line);
+        }
+        assert_eq!(blocks.len(), MAX_COMMAND_BLOCKS);
+    }
+}
@@ -0,0 +1,447 @@
+//! Differential conformance tests for the parser and performer fast paths.
+//!
+//! The bulk paths (copa's ground and CSI scans, `BatchedParser`, and
+//! `Crosswords::input_str`) must leave the terminal in exactly the state the
+//! byte-at-a-time, char-at-a-time path produces. Every case feeds the same
+//! stream through the reference path and through the fast path with a few
+//! chunkings, then compares grids, cursors and modes cell by cell.
+//!
+//! Streams come from a seeded generator biased towards escape sequences and
+//! from mutated real captures, so failures are reproducible. Soak locally with
+//! more cases or another seed:
+//!
+//! ```sh
+//! RIO_CONFORMANCE_CASES=100000 RIO_CONFORMANCE_SEED=7 \
+//!     cargo test --release -p rio-backend conformance
+//! ```
+
+use super::*;
+use crate::crosswords::grid::Dimensions;
+use crate::crosswords::pos::{Column, Line};
+use crate::crosswords::CrosswordsSize;
+use crate::event::VoidListener;
+use crate::performer::handler::{Processor, Timeout};
+use std::fmt::Write as _;
+
+const DEFAULT_CASES: usize = 500;
+const DEFAULT_SEED: u64 = 0x2545_F491_4F6C_DD1D;
+
+/// Xorshift generator, so failures reproduce from the printed seed.
+struct Rng(u64);
+
+impl Rng {
+    fn new(seed: u64) -> Rng {
+        Rng(seed.max(1))
+    }
+
+    fn next(&mut self) -> u64 {
+        self.0 ^= self.0 << 13;
+        self.0 ^= self.0 >> 7;
+        self.0 ^= self.0 << 17;
+        self.0
+    }
+
+    fn below(&mut self, n: usize) -> usize {
+        (self.next() % n as u64) as usize
+    }
+
+    fn pick<'a, T>(&mut self, items: &'a [T]) -> &'a T {
+        &items[self.below(items.len())]
+    }
+}
+
+const TEXT: &[&str] = &[
+    "hello",
+    "the quick brown fox jumps over the lazy dog ",
+    " ",
+    "wörld",
+    "漢字テスト",
+    "👍🏽",
+    "❤\u{fe0f}",
+    "e\u{301}",
+    "👨\u{200d}👩\u{200d}👧",
+    "\u{7f}",
+    "─│┌┐",
+];
+
+const CONTROLS: &[&[u8]] = &[
+    b"\r", b"\n", b"\r\n", b"\x08", b"\t", b"\x0b", b"\x0c", b"\x0e", b"\x0f", b"\x07",
+];
+
+const ESCAPES: &[&[u8]] = &[
+    b"\x1b7",
+    b"\x1b8",
+    b"\x1bD",
+    b"\x1bM",
+    b"\x1bE",
+    b"\x1bH",
+    b"\x1bc",
+    b"\x1b(0",
+    b"\x1b(B",
+    b"\x1b)0",
+    b"\x1b#8",
+    b"\x1b[s",
+    b"\x1b[u",
+    b"\x1b[g",
+    b"\x1b[3g",
+    b"\x1b[4h",
+    b"\x1b[4l",
+    b"\x1b[20h",
+    b"\x1b[20l",
+    b"\x1b[?6h",
+    b"\x1b[?6l",
+    b"\x1b[?7h",
+    b"\x1b[?7l",
+    b"\x1b[?25l",
+    b"\x1b[?47h",
+    b"\x1b[?47l",
+    b"\x1b[?1049h",
+    b"\x1b[?1049l",
+    b"\x1b[?2026h",
+    b"\x1b[?2026l",
+    b"\x1b[>1u",
+    b"\x1b[<u",
+    b"\x1b]0;title\x07",
+    b"\x1b]2;other title\x1b\\",
+    // Hyperlinks without an id get a process-wide unique one, which would
+    // differ between the two runs.
+    b"\x1b]8;id=1;https://example.com\x1b\\",
+    b"\x1b]8;;\x1b\\",
+    b"\x1b]7;file:///tmp\x07",
+    b"\x1b[",
+    b"\x1b",
+];
+
+const SGR: &[&str] = &[
+    "0",
+    "1",
+    "2",
+    "3",
+    "4",
+    "4:3",
+    "5",
+    "7",
+    "8",
+    "9",
+    "22",
+    "23",
+    "24",
+    "27",
+    "29",
+    "31",
+    "39",
+    "42",
+    "49",
+    "38;5;196",
+    "48;5;21",
+    "38;2;1;2;3",
+    "48;2;200;100;0",
+    "58:5:9",
+    "59",
+    "91",
+    "104",
+];
+
+fn push_csi(stream: &mut Vec<u8>, params: &[usize], action: char) {
+    stream.extend_from_slice(b"\x1b[");
+    let mut text = String::new();
+    for (i, param) in params.iter().enumerate() {
+        if i > 0 {
+            text.push(';');
+        }
+        let _ = write!(text, "{param}");
+    }
+    text.push(action);
+    stream.extend_from_slice(text.as_bytes());
+}
+
+/// Random PTY stream biased towards the sequences the fast paths special-case.
+fn random_stream(rng: &mut Rng, len: usize, columns: usize, lines: usize) -> Vec<u8> {
+    let mut stream = Vec::with_capacity(len + 64);
+    while stream.len() < len {
+        match rng.below(16) {
+            0..=4 => stream.extend_from_slice(rng.pick(TEXT).as_bytes()),
+            5 => {
+                // Long printable runs wrap and scroll.
+                let run = 1 + rng.below(columns * 3);
+                stream.extend((0..run).map(|i| b'a' + (i % 26) as u8));
+            }
+            6 | 7 => stream.extend_from_slice(rng.pick(CONTROLS)),
+            8 | 9 => stream.extend_from_slice(rng.pick(ESCAPES)),
+            10 | 11 => {
+                let count = 1 + rng.below(3);
+                let sgr: Vec<&str> = (0..count).map(|_| *rng.pick(SGR)).collect();
+                stream.extend_from_slice(format!("\x1b[{}m", sgr.join(";")).as_bytes());
+            }
+            12 => {
+                let action = *rng.pick(&[
+                    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'd', 'J', 'K', 'X', 'P', '@', 'L',
+                    'M', 'S', 'T', 'b', 'I', 'Z',
+                ]);
+                let param = rng.below(columns.max(lines) + 2);
+                push_csi(&mut stream, &[param], action);
+            }
+            13 => {
+                let line = rng.below(lines + 2);
+                let column = rng.below(columns + 2);
+                push_csi(&mut stream, &[line, column], 'H');
+            }
+            14 => {
+                let top = rng.below(lines + 1);
+                let bottom = top + rng.below(lines + 1);
+                push_csi(&mut stream, &[top, bottom], 'r');
+            }
+            _ => stream.push(rng.next() as u8),
+        }
+    }
+    stream
+}
+
+/// Flip, insert and delete a few bytes of a slice of a real capture.
+fn mutate(rng: &mut Rng, input: &[u8]) -> Vec<u8> {
+    let start = rng.below(input.len());
+    let end = (start + 1 + rng.below(2048)).min(input.len());
+    let mut stream = input[start..end].to_vec();
+    for _ in 0..rng.below(8) {
+        let at = rng.below(stream.len() + 1);
+        match rng.below(3) {
+            0 if at < stream.len() => stream[at] ^= 1 << rng.below(8),
+            1 if at < stream.len() => {
+                stream.remove(at);
+            }
+            _ => stream.insert(at, rng.next() as u8),
+        }
+    }
+    stream
+}
+
+/// How the stream is handed to the processor.
+#[derive(Debug)]
+enum Feed {
+    /// One byte per `advance`, with `input_str` forced through `input`.
+    Reference,
+    /// The whole stream in one `advance`, hitting the batched path.
+    Whole,
+    /// `advance` per chunk of the given lengths, the rest in one go.
+    Chunks(Vec<usize>),
+}
+
+fn run(
+    feed: &Feed,
+    input: &[u8],
+    columns: usize,
+    lines: usize,
+) -> Crosswords<VoidListener> {
+    let size = CrosswordsSize::new(columns, lines);
+    let window_id = crate::event::WindowId::from(0);
+    let mut cw = Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+    let mut processor: Processor = Processor::new();
+
+    match feed {
+        Feed::Reference => {
+            cw.reference_input = true;
+            for byte in input {
+                processor.advance(&mut cw, std::slice::from_ref(byte));
+            }
+        }
+        Feed::Whole => processor.advance(&mut cw, input),
+        Feed::Chunks(chunks) => {
+            let mut rest = input;
+            for &len in chunks {
+                let (chunk, tail) = rest.split_at(len.min(rest.len()));
+                processor.advance(&mut cw, chunk);
+                rest = tail;
+            }
+            processor.advance(&mut cw, rest);
+        }
+    }
+
+    // Flush an unterminated synchronized update the same way on every path.
+    if processor.sync_timeout().pending_timeout() {
+        processor.stop_sync(&mut cw);
+    }
+
+    cw
+}
+
+fn diff_grids(
+    name: &str,
+    expected: &Grid<Square>,
+    actual: &Grid<Square>,
+) -> Option<String> {
+    if expected.cursor != actual.cursor {
+        return Some(format!(
+            "{name} cursor: expected {:?}, got {:?}",
+            expected.cursor, actual.cursor
+        ));
+    }
+    if expected.saved_cursor != actual.saved_cursor {
+        return Some(format!(
+            "{name} saved cursor: expected {:?}, got {:?}",
+            expected.saved_cursor, actual.saved_cursor
+        ));
+    }
+    if expected.history_size() != actual.history_size()
+        || expected.display_offset() != actual.display_offset()
+    {
+        return Some(format!(
+            "{name} history: expected {}+{}, got {}+{}",
+            expected.history_size(),
+            expected.display_offset(),
+            actual.history_size(),
+            actual.display_offset()
+        ));
+    }
+
+    let top = expected.topmost_line().0;
+    let bottom = expected.bottommost_line().0;
+    for line in top..=bottom {
+        for column in 0..expected.columns() {
+            let expected = &expected[Line(line)][Column(column)];
+            let actual = &actual[Line(line)][Column(column)];
+            if expected != actual {
+                return Some(format!(
+                    "{name} cell {line}:{column}: expected {expected:?}, got {actual:?}"
+                ));
+            }
+        }
+    }
+
+    None
+}
+
+/// First difference between the terminal states, if any.
+fn diff(
+    expected: &Crosswords<VoidListener>,
+    actual: &Crosswords<VoidListener>,
+) -> Option<String> {
+    if expected.mode.bits() != actual.mode.bits() {
+        return Some(format!(
+            "mode: expected {:?}, got {:?}",
+            expected.mode, actual.mode
+        ));
+    }
+    if expected.scroll_region != actual.scroll_region {
+        return Some(format!(
+            "scroll region: expected {:?}, got {:?}",
+            expected.scroll_region, actual.scroll_region
+        ));
+    }
+    if expected.active_charset != actual.active_charset {
+        return Some(format!(
+            "active charset: expected {:?}, got {:?}",
+            expected.active_charset, actual.active_charset
+        ));
+    }
+    if expected.tabs.tabs != actual.tabs.tabs {
+        return Some("tab stops differ".to_string());
+    }
+    if expected.title != actual.title || expected.title_stack != actual.title_stack {
+        return Some(format!(
+            "title: expected {:?}, got {:?}",
+            expected.title, actual.title
+        ));
+    }
+    if expected.keyboard_mode_stack != actual.keyboard_mode_stack
+        || expected.keyboard_mode_idx != actual.keyboard_mode_idx
+    {
+        return Some("keyboard mode stack differs".to_string());
+    }
+
+    diff_grids("grid", &expected.grid, &actual.grid).or_else(|| {
+        diff_grids(
+            "inactive grid",
+            &expected.inactive_grid,
+            &actual.inactive_grid,
+        )
+    })
+}
+
+fn check(input: &[u8], feed: &Feed, columns: usize, lines: usize) -> Option<String> {
+    let expected = run(&Feed::Reference, input, columns, lines);
+    let actual = run(feed, input, columns, lines);
+    diff(&expected, &actual)
+}
+
+/// Drop chunks of the input while the divergence persists, to get a
+/// reproducer small enough to read.
+fn minimize(input: &[u8], feed: &Feed, columns: usize, lines: usize) -> Vec<u8> {
+    let mut input = input.to_vec();
+    let mut window = input.len() / 2;
+    while window > 0 {
+        let mut start = 0;
+        while start < input.len() {
+            let end = (start + window).min(input.len());
+            let mut candidate = input[..start].to_vec();
+            candidate.extend_from_slice(&input[end..]);
+            if check(&candidate, feed, columns, lines).is_some() {
+                input = candidate;
+            } else {
+                start += window;
+            }
+        }
+        window /= 2;
+    }
+    input
+}
+
+fn env_or<T: std::str::FromStr>(name: &str, default: T) -> T {
+    std::env::var(name)
+        .ok()
+        .and_then(|value| value.parse().ok())
+        .unwrap_or(default)
+}
+
+#[test]
+fn fast_paths_match_reference() {
+    let cases = env_or("RIO_CONFORMANCE_CASES", DEFAULT_CASES);
+    let seed = env_or("RIO_CONFORMANCE_SEED", DEFAULT_SEED);
+    let corpus: &[u8] = include_bytes!("../../../copa/tests/demo.vte");
+    let mut rng = Rng::new(seed);
+
+    for case in 0..cases {
+        let columns = 1 + rng.below(40);
+        let lines = 1 + rng.below(12);
+        let input = if case % 4 == 0 {
+            mutate(&mut rng, corpus)
+        } else {
+            let len = 1 + rng.below(2048);
+            random_stream(&mut rng, len, columns, lines)
+        };
+
+        // Mix tiny chunks, which split sequences and codepoints, with chunks
+        // over the 1KB batching threshold.
+        let chunks = (0..1 + rng.below(16))
+            .map(|_| {
+                let max = if rng.below(2) == 0 { 8 } else { 1500 };
+                rng.below(max)
+            })
+            .collect();
+
+        for feed in [Feed::Whole, Feed::Chunks(chunks)] {
+            if let Some(difference) = check(&input, &feed, columns, lines) {
+                let minimized = minimize(&input, &feed, columns, lines);
+                panic!(
+                    "seed {seed} case {case} ({columns}x{lines}, {feed:?}): {difference}\n\
+                     minimized input: b\"{}\"",
+                    minimized.escape_ascii()
+                );
+            }
+        }
+    }
+}
+
+#[test]
+fn reference_input_is_per_char() {
+    // The reference path itself has to agree with plain `input` calls.
+    let size = CrosswordsSize::new(10, 3);
+    let window_id = crate::event::WindowId::from(0);
+    let mut expected =
+        Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+    for c in "abcdefghijklmnö漢".chars() {
+        expected.input(c);
+    }
+
+    let actual = run(&Feed::Reference, "abcdefghijklmnö漢".as_bytes(), 10, 3);
+    assert_eq!(diff(&expected, &actual), None);
+}
@@ -0,0 +1,228 @@
+//! Compact encoding of grid rows.
+//!
+//! A square takes the same space whatever it holds, while scrollback is
+//! mostly plain text in a handful of styles followed by blank columns.
+//! [`CompactRows`] stores the characters as UTF-8, the attributes as runs and
+//! drops trailing default squares, which shrinks typical history more than
+//! ten times. Squares with extra storage (zero-width characters, underline
+//! colors, graphics) are rare and kept as they are.
+//!
+//! Used to hibernate the scrollback of terminals that are not shown, see
+//! [`crate::crosswords::Crosswords::hibernate`].
+
+use crate::config::colors::AnsiColor;
+use crate::crosswords::grid::row::Row;
+use crate::crosswords::hyperlink::HyperlinkId;
+use crate::crosswords::square::{Flags, Square};
+use std::mem;
+
+/// Attributes shared by consecutive squares of a row.
+#[derive(Debug, Clone, Copy)]
+struct StyleRun {
+    len: u32,
+    fg: AnsiColor,
+    bg: AnsiColor,
+    flags: Flags,
+    hyperlink: Option<HyperlinkId>,
+}
+
+impl StyleRun {
+    #[inline]
+    fn new(square: &Square) -> StyleRun {
+        StyleRun {
+            len: 1,
+            fg: square.fg,
+            bg: square.bg,
+            flags: square.flags,
+            hyperlink: square.hyperlink,
+        }
+    }
+
+    #[inline]
+    fn matches(&self, square: &Square) -> bool {
+        self.fg == square.fg
+            && self.bg == square.bg
+            && self.flags == square.flags
+            && self.hyperlink == square.hyperlink
+    }
+}
+
+#[derive(Debug, Clone, Copy)]
+struct RowHeader {
+    columns: u32,
+    occ: u32,
+    /// Style runs of the row, covering every encoded square.
+    runs: u32,
+    /// Squares of the row stored in `extras`.
+    extras: u32,
+}
+
+/// Rows encoded by [`CompactRows::push`], decoded in the same order.
+#[derive(Debug, Default)]
+pub struct CompactRows {
+    rows: Vec<RowHeader>,
+    /// One char per encoded square.
+    text: String,
+    runs: Vec<StyleRun>,
+    /// Squares with extra storage and their column.
+    extras: Vec<(u32, Square)>,
+}
+
+impl CompactRows {
+    pub fn with_capacity(rows: usize) -> CompactRows {
+        CompactRows {
+            rows: Vec::with_capacity(rows),
+            ..Default::default()
+        }
+    }
+
+    pub fn push(&mut self, row: &Row<Square>) {
+        let default = Square::default();
+        let squares = &row[..];
+        let encoded = squares
+            .iter()
+            .rposition(|square| *square != default)
+            .map_or(0, |last| last + 1);
+
+        let runs = self.runs.len();
+        let extras = self.extras.len();
+        for (column, square) in squares[..encoded].iter().enumerate() {
+            self.text.push(square.c);
+            match self.runs[runs..].last_mut() {
+                Some(run) if run.matches(square) => run.len += 1,
+                _ => self.runs.push(StyleRun::new(square)),
+            }
+            if square.extra.is_some() {
+                self.extras.push((column as u32, square.clone()));
+            }
+        }
+
+        self.rows.push(RowHeader {
+            columns: squares.len() as u32,
+            occ: row.occ as u32,
+            runs: (self.runs.len() - runs) as u32,
+            extras: (self.extras.len() - extras) as u32,
+        });
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.rows.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.rows.is_empty()
+    }
+
+    /// Hyperlinks referenced by the encoded squares.
+    pub fn hyperlinks(&self) -> impl Iterator<Item = HyperlinkId> + '_ {
+        self.runs.iter().filter_map(|run| run.hyperlink)
+    }
+
+    /// Bytes held on the heap by the encoding.
+    pub fn heap_size(&self) -> usize {
+        self.rows.capacity() * mem::size_of::<RowHeader>()
+            + self.text.capacity()
+            + self.runs.capacity() * mem::size_of::<StyleRun>()
+            + self.extras.capacity() * mem::size_of::<(u32, Square)>()
+    }
+
+    pub fn shrink_to_fit(&mut self) {
+        self.rows.shrink_to_fit();
+        self.text.shrink_to_fit();
+        self.runs.shrink_to_fit();
+        self.extras.shrink_to_fit();
+    }
+
+    /// Decode the rows in the order they were pushed.
+    pub fn into_rows(self) -> Vec<Row<Square>> {
+        let CompactRows {
+            rows,
+            text,
+            runs,
+            extras,
+        } = self;
+        let mut chars = text.chars();
+        let mut runs = runs.into_iter();
+        let mut extras = extras.into_iter();
+
+        rows.iter()
+            .map(|header| {
+                let mut squares = Vec::with_capacity(header.columns as usize);
+                for run in runs.by_ref().take(header.runs as usize) {
+                    for c in chars.by_ref().take(run.len as usize) {
+                        squares.push(Square {
+                            c,
+                            fg: run.fg,
+                            bg: run.bg,
+                            extra: None,
+                            flags: run.flags,
+                            hyperlink: run.hyperlink,
+                        });
+                    }
+                }
+                for (column, square) in extras.by_ref().take(header.extras as usize) {
+                    squares[column as usize] = square;
+                }
+                squares.resize_with(header.columns as usize, Square::default);
+                Row::from_vec(squares, header.occ as usize)
+            })
+            .collect()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::config::colors::NamedColor;
+    use crate::crosswords::pos::Column;
+
+    fn row(text: &str, columns: usize) -> Row<Square> {
+        let mut row = Row::<Square>::new(columns);
+        for (column, c) in text.chars().enumerate() {
+            row[Column(column)].c = c;
+        }
+        row
+    }
+
+    #[test]
+    fn rows_round_trip() {
+        let mut styled = row("error: 中 e", 16);
+        for column in 0..6 {
+            styled[Column(column)].fg = AnsiColor::Named(NamedColor::Red);
+            styled[Column(column)].flags.insert(Flags::BOLD);
+        }
+        styled[Column(7)].flags.insert(Flags::WIDE_CHAR);
+        styled[Column(8)].c = ' ';
+        styled[Column(8)].flags.insert(Flags::WIDE_CHAR_SPACER);
+        styled[Column(9)].c = 'e';
+        styled[Column(9)].push_zerowidth('\u{301}');
+        styled[Column(12)].bg = AnsiColor::Indexed(4);
+
+        let rows = vec![row("$ cargo build", 16), Row::new(16), styled];
+        let mut compact = CompactRows::with_capacity(rows.len());
+        for row in &rows {
+            compact.push(row);
+        }
+        assert_eq!(compact.len(), 3);
+
+        let decoded = compact.into_rows();
+        assert_eq!(decoded, rows);
+        for (decoded, row) in decoded.iter().zip(&rows) {
+            assert_eq!(decoded.occ, row.occ);
+        }
+    }
+
+    #[test]
+    fn plain_history_is_small() {
+        let mut compact = CompactRows::with_capacity(1000);
+        for line in 0..1000 {
+            compact.push(&row(&format!("{line:>6} GET /api/v1/items ok"), 120));
+        }
+        compact.shrink_to_fit();
+
+        let squares = 1000 * 120 * mem::size_of::<Square>();
+        assert!(compact.heap_size() * 10 < squares);
+    }
+}
@@ -2,8 +2,10 @@
 // https://github.com/alacritty/alacritty/blob/e35e5ad14fce8456afdd89f2b392b9924bb27471/alacritty_terminal/src/grid/mod.rs
 // which is licensed under Apache 2.0 license.
 
+pub mod compact;
 pub mod resize;
 pub mod row;
+pub mod row_text;
 pub mod storage;
 
 #[cfg(test)]
@@ -16,6 +18,7 @@ use crate::crosswords::Cursor;
 use crate::crosswords::{Column, Line};
 use row::Row;
 use std::cmp::{max, min};
+use std::mem;
 use std::ops::{Bound, Deref, Index, IndexMut, Range, RangeBounds};
 use storage::Storage;
 
@@ -62,6 +65,12 @@ pub struct Grid<T> {
 
     /// Maximum number of lines in history.
     max_scroll_limit: usize,
+
+    /// Lines rotated into history since the grid was created.
+    ///
+    /// This is the absolute line of `Line(0)`. Absolute lines stay attached to
+    /// their content while the storage rotates, see [`Grid::absolute_line`].
+    scrolled_lines: usize,
 }
 
 impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
@@ -70,6 +79,7 @@ impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
             raw: Storage::with_capacity(lines, columns),
             max_scroll_limit,
             display_offset: 0,
+            scrolled_lines: 0,
             saved_cursor: Cursor::default(),
             cursor: Cursor::default(),
             lines,
@@ -100,6 +110,48 @@ impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
         };
     }
 
+    /// Remove the scrollback history, newest line first.
+    ///
+    /// The storage drops the removed rows instead of keeping them around for
+    /// reuse, see [`Grid::restore_history`] to put them back.
+    pub fn take_history(&mut self) -> Vec<Row<T>> {
+        let history_size = self.history_size();
+        let rows = (1..=history_size)
+            .map(|line| mem::take(&mut self.raw[Line(-(line as i32))]))
+            .collect();
+
+        self.raw.shrink_lines(history_size);
+        self.raw.shrink_to_fit();
+        self.display_offset = 0;
+        rows
+    }
+
+    /// Put rows removed by [`Grid::take_history`] back above the current
+    /// history, newest line first.
+    ///
+    /// Rows beyond the scrollback limit are dropped, rows of a different width
+    /// are cut or padded without reflow.
+    pub fn restore_history(&mut self, rows: Vec<Row<T>>) {
+        let history_size = self.history_size();
+        let count = min(
+            rows.len(),
+            self.max_scroll_limit.saturating_sub(history_size),
+        );
+        if count == 0 {
+            return;
+        }
+
+        self.raw.initialize(count, self.columns);
+        for (offset, mut row) in rows.into_iter().take(count).enumerate() {
+            if row.len() < self.columns {
+                row.grow(self.columns);
+            } else if row.len() > self.columns {
+                row.shrink(self.columns);
+            }
+            self.raw[Line(-((history_size + offset + 1) as i32))] = row;
+        }
+    }
+
     fn increase_scroll_limit(&mut self, count: usize) {
         let count = min(count, self.max_scroll_limit - self.history_size());
         if count != 0 {
@@ -204,6 +256,8 @@ impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
 
         // Only rotate the entire history if the active region starts at the top.
         if region.start == 0 {
+            self.scrolled_lines += positions;
+
             // Create scrollback for the new lines.
             self.increase_scroll_limit(positions);
 
@@ -227,6 +281,11 @@ impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
             for i in (region.end.0..screen_lines).rev().map(Line::from) {
                 self.raw.swap(i, i - positions);
             }
+
+            // Text cached while the rows were on screen is rarely needed again.
+            for i in 1..=min(positions, self.history_size()) {
+                self.raw[Line(-(i as i32))].drop_text();
+            }
         } else {
             // Rotate lines without moving anything into history.
             for i in (region.start.0..region.end.0 - positions as i32).map(Line::from) {
@@ -313,6 +372,44 @@ impl<T> Grid<T> {
         }
     }
 
+    /// Bytes held on the heap by the rows, see [`Grid::screen_heap_size`] for
+    /// the visible part.
+    #[inline]
+    pub fn heap_size(&self) -> usize {
+        self.raw.heap_size()
+    }
+
+    /// Bytes held on the heap by the visible rows.
+    pub fn screen_heap_size(&self) -> usize {
+        (0..self.screen_lines())
+            .map(|line| {
+                mem::size_of::<Row<T>>() + self.raw[Line(line as i32)].heap_size()
+            })
+            .sum()
+    }
+
+    /// Drop the rows buffered for reuse, the text cached by history rows and
+    /// the spare capacity.
+    ///
+    /// Returns the number of heap bytes released.
+    pub fn shrink_to_fit(&mut self) -> usize {
+        let before = self.heap_size();
+        self.drop_history_text();
+        self.raw.shrink_to_fit();
+        before.saturating_sub(self.heap_size())
+    }
+
+    /// Drop the text cached by the history rows.
+    ///
+    /// History rows hardly change, so text cached by selection or hints would
+    /// otherwise stay until the row is reused. Returns the number of heap
+    /// bytes released.
+    pub fn drop_history_text(&mut self) -> usize {
+        (1..=self.history_size())
+            .map(|line| self.raw[Line(-(line as i32))].drop_text())
+            .sum()
+    }
+
     #[inline]
     pub fn clear_history(&mut self) {
         // Explicitly purge all lines from history.
@@ -379,6 +476,33 @@ impl<T> Grid<T> {
         self.display_offset
     }
 
+    /// Lines rotated into history since the grid was created.
+    #[inline]
+    pub fn scrolled_lines(&self) -> usize {
+        self.scrolled_lines
+    }
+
+    /// Absolute line of `line`, which does not change when lines are rotated
+    /// into history.
+    #[inline]
+    pub fn absolute_line(&self, line: Line) -> usize {
+        (self.scrolled_lines as isize + line.0 as isize).max(0) as usize
+    }
+
+    /// Line currently holding the absolute line `line`, `None` when it was
+    /// dropped from history or is below the screen.
+    #[inline]
+    pub fn line_from_absolute(&self, line: usize) -> Option<Line> {
+        let line = Line((line as isize - self.scrolled_lines as isize) as i32);
+        (line >= self.topmost_line() && line <= self.bottommost_line()).then_some(line)
+    }
+
+    /// Oldest absolute line still in the grid.
+    #[inline]
+    pub fn first_absolute_line(&self) -> usize {
+        self.absolute_line(self.topmost_line())
+    }
+
     #[inline]
     pub fn cursor_cell(&mut self) -> &mut T {
         let point = self.cursor.pos;
@@ -20,6 +20,10 @@ impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
         // Use empty template cell for resetting cells due to resize.
         let template = mem::take(&mut self.cursor.template);
 
+        // Content moves between the screen and history, keep absolute lines
+        // anchored at the cursor.
+        let cursor_line = self.absolute_line(self.cursor.pos.row);
+
         match self.lines.cmp(&lines) {
             Ordering::Less => self.grow_lines(lines),
             Ordering::Greater => self.shrink_lines(lines),
@@ -34,6 +38,9 @@ impl<T: GridSquare + Default + PartialEq + Clone> Grid<T> {
 
         // Restore template cell.
         self.cursor.template = template;
+
+        self.scrolled_lines = (cursor_line as isize - self.cursor.pos.row.0 as isize)
+            .max(self.history_size() as isize) as usize;
     }
 
     /// Add lines to the visible area.
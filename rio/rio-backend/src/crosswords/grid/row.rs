@@ -2,6 +2,7 @@
 // https://github.com/alacritty/alacritty/blob/e35e5ad14fce8456afdd89f2b392b9924bb27471/alacritty_terminal/src/grid/row.rs
 // which is licensed under Apache 2.0 license.
 
+use crate::crosswords::grid::row_text::RowText;
 use crate::crosswords::grid::GridSquare;
 use crate::crosswords::square::Flags;
 use crate::crosswords::square::ResetDiscriminant;
@@ -9,6 +10,7 @@ use crate::crosswords::Column;
 use core::cmp::min;
 use std::cmp::max;
 use std::ops::{Index, IndexMut, Range, RangeFrom, RangeFull, RangeTo, RangeToInclusive};
+use std::sync::OnceLock;
 use std::{ptr, slice};
 
 /// A row in the grid.
@@ -21,6 +23,9 @@ pub struct Row<T> {
     /// This is the upper bound on the number of elements in the row, which have been modified
     /// since the last reset. All cells after this point are guaranteed to be equal.
     pub(crate) occ: usize,
+
+    /// Packed text of the row, dropped whenever the row is modified.
+    pub(super) text: OnceLock<Box<RowText>>,
 }
 
 impl<T: PartialEq> PartialEq for Row<T> {
@@ -51,7 +56,11 @@ impl<T: Clone + Default> Row<T> {
             inner.set_len(columns);
         }
 
-        Row { inner, occ: 0 }
+        Row {
+            inner,
+            occ: 0,
+            text: OnceLock::new(),
+        }
     }
 
     /// Increase the number of columns in the row.
@@ -61,6 +70,7 @@ impl<T: Clone + Default> Row<T> {
             return;
         }
 
+        self.invalidate_text();
         self.inner.resize_with(columns, T::default);
     }
 
@@ -72,6 +82,8 @@ impl<T: Clone + Default> Row<T> {
             return None;
         }
 
+        self.invalidate_text();
+
         // Split off cells for a new row.
         let mut new_row = self.inner.split_off(columns);
         let index = new_row
@@ -102,6 +114,8 @@ impl<T: Clone + Default> Row<T> {
     {
         debug_assert!(!self.inner.is_empty());
 
+        self.invalidate_text();
+
         // Mark all cells as dirty if template cell changed.
         let len = self.inner.len();
         if self.inner[len - 1].discriminant() != template.discriminant() {
@@ -121,7 +135,11 @@ impl<T: Clone + Default> Row<T> {
 impl<T> Row<T> {
     #[inline]
     pub fn from_vec(vec: Vec<T>, occ: usize) -> Row<T> {
-        Row { inner: vec, occ }
+        Row {
+            inner: vec,
+            occ,
+            text: OnceLock::new(),
+        }
     }
 
     #[inline]
@@ -136,6 +154,7 @@ impl<T> Row<T> {
 
     #[inline]
     pub fn last_mut(&mut self) -> Option<&mut T> {
+        self.invalidate_text();
         self.occ = self.inner.len();
         self.inner.last_mut()
     }
@@ -145,12 +164,14 @@ impl<T> Row<T> {
     where
         T: GridSquare,
     {
+        self.invalidate_text();
         self.occ += vec.len();
         self.inner.append(vec);
     }
 
     #[inline]
     pub fn append_front(&mut self, mut vec: Vec<T>) {
+        self.invalidate_text();
         self.occ += vec.len();
 
         vec.append(&mut self.inner);
@@ -159,6 +180,7 @@ impl<T> Row<T> {
 
     #[inline]
     pub fn front_split_off(&mut self, at: usize) -> Vec<T> {
+        self.invalidate_text();
         self.occ = self.occ.saturating_sub(at);
 
         let mut split = self.inner.split_off(at);
@@ -166,6 +188,27 @@ impl<T> Row<T> {
         split
     }
 
+    /// Bytes held on the heap by the row, including its cached text.
+    #[inline]
+    pub fn heap_size(&self) -> usize {
+        self.inner.capacity() * std::mem::size_of::<T>()
+            + self.text.get().map_or(0, |text| text.heap_size())
+    }
+
+    /// Drop the cached text, the next [`Row::text`] packs it again.
+    ///
+    /// Returns the number of heap bytes released.
+    #[inline]
+    pub fn drop_text(&mut self) -> usize {
+        self.text.take().map_or(0, |text| text.heap_size())
+    }
+
+    /// Drop the cached text after the row was modified.
+    #[inline]
+    fn invalidate_text(&mut self) {
+        self.drop_text();
+    }
+
     #[inline]
     pub fn is_clear(&self) -> bool
     where
@@ -191,6 +234,7 @@ impl<'a, T> IntoIterator for &'a mut Row<T> {
 
     #[inline]
     fn into_iter(self) -> slice::IterMut<'a, T> {
+        self.invalidate_text();
         self.occ = self.len();
         self.inner.iter_mut()
     }
@@ -208,6 +252,7 @@ impl<T> Index<Column> for Row<T> {
 impl<T> IndexMut<Column> for Row<T> {
     #[inline]
     fn index_mut(&mut self, index: Column) -> &mut T {
+        self.invalidate_text();
         self.occ = max(self.occ, *index + 1);
         &mut self.inner[index.0]
     }
@@ -225,6 +270,7 @@ impl<T> Index<Range<Column>> for Row<T> {
 impl<T> IndexMut<Range<Column>> for Row<T> {
     #[inline]
     fn index_mut(&mut self, index: Range<Column>) -> &mut [T] {
+        self.invalidate_text();
         self.occ = max(self.occ, *index.end);
         &mut self.inner[(index.start.0)..(index.end.0)]
     }
@@ -242,6 +288,7 @@ impl<T> Index<RangeTo<Column>> for Row<T> {
 impl<T> IndexMut<RangeTo<Column>> for Row<T> {
     #[inline]
     fn index_mut(&mut self, index: RangeTo<Column>) -> &mut [T] {
+        self.invalidate_text();
         self.occ = max(self.occ, *index.end);
         &mut self.inner[..(index.end.0)]
     }
@@ -259,6 +306,7 @@ impl<T> Index<RangeFrom<Column>> for Row<T> {
 impl<T> IndexMut<RangeFrom<Column>> for Row<T> {
     #[inline]
     fn index_mut(&mut self, index: RangeFrom<Column>) -> &mut [T] {
+        self.invalidate_text();
         self.occ = self.len();
         &mut self.inner[(index.start.0)..]
     }
@@ -276,6 +324,7 @@ impl<T> Index<RangeFull> for Row<T> {
 impl<T> IndexMut<RangeFull> for Row<T> {
     #[inline]
     fn index_mut(&mut self, _: RangeFull) -> &mut [T] {
+        self.invalidate_text();
         self.occ = self.len();
         &mut self.inner[..]
     }
@@ -293,6 +342,7 @@ impl<T> Index<RangeToInclusive<Column>> for Row<T> {
 impl<T> IndexMut<RangeToInclusive<Column>> for Row<T> {
     #[inline]
     fn index_mut(&mut self, index: RangeToInclusive<Column>) -> &mut [T] {
+        self.invalidate_text();
         self.occ = max(self.occ, *index.end);
         &mut self.inner[..=(index.end.0)]
     }
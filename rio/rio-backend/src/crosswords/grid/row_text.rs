@@ -0,0 +1,247 @@
+//! Packed UTF-8 text of grid rows.
+//!
+//! Search, selection, log export and URL detection all want the text of a
+//! row rather than its squares. [`Row::text`] converts a row once, skipping
+//! wide char spacers and keeping zero-width characters, and caches the result
+//! on the row until the row is modified. The column to byte offset map lets
+//! consumers translate positions in the text back to grid columns.
+//!
+//! One-off scans over rows nobody else reads, such as a search through the
+//! scrollback, pack them with [`pack_row`] into a buffer of their own, so
+//! every history row does not end up with a cached copy of its text.
+//!
+//! The cached text also carries the row's [`HyperlinkSpan`]s, so hover
+//! hit-testing binary-searches an index that is rebuilt only after the row
+//! changed.
+
+use crate::crosswords::grid::row::Row;
+use crate::crosswords::hyperlink::{self, HyperlinkSpan};
+use crate::crosswords::pos::Column;
+use crate::crosswords::square::{Flags, Square};
+use std::ops::Range;
+
+/// Text of a single row, see [`Row::text`].
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct RowText {
+    text: String,
+    /// Byte offset of every column, followed by the length of the text.
+    ///
+    /// `None` while every column is exactly one byte, which is the common
+    /// case of ASCII output and keeps cached scrollback small.
+    offsets: Option<Box<[u32]>>,
+    columns: usize,
+    has_tabs: bool,
+    /// Hyperlink spans in column order, empty for rows without links.
+    hyperlinks: Box<[HyperlinkSpan]>,
+}
+
+impl RowText {
+    pub fn new(row: &Row<Square>) -> RowText {
+        let columns = row.len();
+        let mut text = String::with_capacity(columns);
+        let mut offsets: Option<Vec<u32>> = None;
+
+        let has_tabs = pack_row(row, &mut text, |column, start, end| {
+            // All columns so far were a single byte, start the map now.
+            if offsets.is_none() && end != column + 1 {
+                let mut map = Vec::with_capacity(columns + 1);
+                map.extend(0..column as u32);
+                offsets = Some(map);
+            }
+            if let Some(offsets) = offsets.as_mut() {
+                offsets.push(start as u32);
+            }
+        });
+
+        if let Some(offsets) = offsets.as_mut() {
+            offsets.push(text.len() as u32);
+        }
+
+        RowText {
+            text,
+            offsets: offsets.map(Vec::into_boxed_slice),
+            columns,
+            has_tabs,
+            hyperlinks: hyperlink::row_spans(row).into_boxed_slice(),
+        }
+    }
+
+    #[inline]
+    pub fn as_str(&self) -> &str {
+        &self.text
+    }
+
+    #[inline]
+    pub fn as_bytes(&self) -> &[u8] {
+        self.text.as_bytes()
+    }
+
+    #[inline]
+    pub fn columns(&self) -> usize {
+        self.columns
+    }
+
+    /// Whether the row contains a tab, which selections expand differently.
+    #[inline]
+    pub fn has_tabs(&self) -> bool {
+        self.has_tabs
+    }
+
+    /// Hyperlink spans of the row, in column order.
+    #[inline]
+    pub fn hyperlinks(&self) -> &[HyperlinkSpan] {
+        &self.hyperlinks
+    }
+
+    /// Byte offset where `column` starts, the text length past the last one.
+    ///
+    /// Spacers of wide chars have no text and start where the next column
+    /// starts.
+    #[inline]
+    pub fn byte_offset(&self, column: Column) -> usize {
+        let column = column.0.min(self.columns);
+        match &self.offsets {
+            Some(offsets) => offsets[column] as usize,
+            None => column,
+        }
+    }
+
+    /// Column whose text contains byte `offset`, clamped to the last column.
+    #[inline]
+    pub fn column_at(&self, offset: usize) -> Column {
+        let last = self.columns.saturating_sub(1);
+        let column = match &self.offsets {
+            Some(offsets) => offsets
+                .partition_point(|&start| start as usize <= offset)
+                .saturating_sub(1),
+            None => offset,
+        };
+        Column(column.min(last))
+    }
+
+    /// Bytes held on the heap, including the box of the cached text itself.
+    pub fn heap_size(&self) -> usize {
+        std::mem::size_of::<RowText>()
+            + self.text.capacity()
+            + self.offsets.as_ref().map_or(0, |offsets| offsets.len() * 4)
+            + std::mem::size_of_val(&*self.hyperlinks)
+    }
+
+    /// Text of the columns in `columns`.
+    #[inline]
+    pub fn slice(&self, columns: Range<Column>) -> &str {
+        let start = self.byte_offset(columns.start);
+        let end = self.byte_offset(columns.end).max(start);
+        &self.text[start..end]
+    }
+}
+
+/// Append the text of `row` to `text`, the way [`RowText::new`] packs it.
+///
+/// `column` is called after each column with the column and the range of
+/// `text` it produced, empty for wide char spacers. Returns whether the row
+/// contains a tab.
+pub fn pack_row(
+    row: &Row<Square>,
+    text: &mut String,
+    mut column: impl FnMut(usize, usize, usize),
+) -> bool {
+    let mut has_tabs = false;
+    for (index, square) in row[..].iter().enumerate() {
+        let start = text.len();
+        if !square
+            .flags
+            .intersects(Flags::WIDE_CHAR_SPACER | Flags::LEADING_WIDE_CHAR_SPACER)
+        {
+            text.push(square.c);
+            if let Some(zerowidth) = square.zerowidth() {
+                text.extend(zerowidth);
+            }
+            has_tabs |= square.c == '\t';
+        }
+        column(index, start, text.len());
+    }
+    has_tabs
+}
+
+impl Row<Square> {
+    /// Packed text of the row.
+    ///
+    /// Built on first use and kept until the row is modified, so every text
+    /// consumer shares one conversion per change of the row.
+    #[inline]
+    pub fn text(&self) -> &RowText {
+        self.text.get_or_init(|| Box::new(RowText::new(self)))
+    }
+
+    /// Packed text of the row if it is already cached.
+    #[inline]
+    pub fn cached_text(&self) -> Option<&RowText> {
+        self.text.get().map(|text| &**text)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn row(text: &str) -> Row<Square> {
+        let mut row = Row::<Square>::new(8);
+        for (column, c) in text.chars().enumerate() {
+            row[Column(column)].c = c;
+        }
+        row
+    }
+
+    #[test]
+    fn ascii_rows_map_columns_to_bytes() {
+        let row = row("ls -la");
+        let text = row.text();
+        assert_eq!(text.as_str(), "ls -la  ");
+        assert!(text.offsets.is_none());
+        assert_eq!(text.byte_offset(Column(3)), 3);
+        assert_eq!(text.byte_offset(Column(100)), 8);
+        assert_eq!(text.column_at(4), Column(4));
+        assert_eq!(text.slice(Column(3)..Column(6)), "-la");
+    }
+
+    #[test]
+    fn wide_and_zerowidth_chars() {
+        let mut row = row("a");
+        row[Column(1)].c = '中';
+        row[Column(1)].flags.insert(Flags::WIDE_CHAR);
+        row[Column(2)].flags.insert(Flags::WIDE_CHAR_SPACER);
+        row[Column(3)].c = 'e';
+        row[Column(3)].push_zerowidth('\u{301}');
+        row[Column(4)].c = 'z';
+
+        let text = row.text();
+        assert_eq!(text.as_str(), "a中e\u{301}z   ");
+        assert_eq!(text.byte_offset(Column(1)), 1);
+        assert_eq!(text.byte_offset(Column(2)), 4);
+        assert_eq!(text.byte_offset(Column(3)), 4);
+        assert_eq!(text.byte_offset(Column(4)), 7);
+        assert_eq!(text.column_at(2), Column(1));
+        assert_eq!(text.column_at(4), Column(3));
+        assert_eq!(text.column_at(5), Column(3));
+        assert_eq!(text.column_at(7), Column(4));
+        assert_eq!(text.column_at(100), Column(7));
+        assert_eq!(text.slice(Column(1)..Column(4)), "中e\u{301}");
+        assert_eq!(text.slice(Column(2)..Column(3)), "");
+    }
+
+    #[test]
+    fn writes_invalidate_text() {
+        let mut row = row("cargo");
+        assert_eq!(row.text().as_str(), "cargo   ");
+
+        row[Column(0)].c = 'C';
+        assert_eq!(row.text().as_str(), "Cargo   ");
+
+        row.reset(&Square::default());
+        assert_eq!(row.text().as_str(), "        ");
+
+        row.grow(10);
+        assert_eq!(row.text().columns(), 10);
+    }
+}
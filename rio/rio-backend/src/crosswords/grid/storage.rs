@@ -126,6 +126,13 @@ impl<T> Storage<T> {
         self.inner.truncate(self.len);
     }
 
+    /// Truncate the invisible elements and release the spare capacity.
+    #[inline]
+    pub fn shrink_to_fit(&mut self) {
+        self.truncate();
+        self.inner.shrink_to_fit();
+    }
+
     /// Dynamically grow the storage buffer at runtime.
     #[inline]
     pub fn initialize(&mut self, additional_rows: usize, columns: usize)
@@ -147,6 +154,12 @@ impl<T> Storage<T> {
         self.len
     }
 
+    /// Bytes held on the heap, including rows buffered outside of the grid.
+    pub fn heap_size(&self) -> usize {
+        self.inner.capacity() * mem::size_of::<Row<T>>()
+            + self.inner.iter().map(Row::heap_size).sum::<usize>()
+    }
+
     #[inline]
     pub fn is_empty(&self) -> bool {
         self.len == 0
@@ -157,11 +170,11 @@ impl<T> Storage<T> {
     /// Exploits the known size of Row<T> to produce a slightly more efficient
     /// swap than going through slice::swap.
     ///
-    /// The default implementation from swap generates 8 movups and 4 movaps
-    /// instructions. This implementation achieves the swap in only 8 movups
-    /// instructions.
+    /// The default implementation from swap goes through a temporary row,
+    /// copying qwords directly lets the optimizer vectorize the swap.
     pub fn swap(&mut self, a: Line, b: Line) {
-        debug_assert_eq!(mem::size_of::<Row<T>>(), mem::size_of::<usize>() * 4);
+        debug_assert_eq!(mem::size_of::<Row<T>>() % mem::size_of::<usize>(), 0);
+        let qwords = mem::size_of::<Row<T>>() / mem::size_of::<usize>();
 
         let a = self.compute_index(a);
         let b = self.compute_index(b);
@@ -177,7 +190,7 @@ impl<T> Storage<T> {
             //
             // The optimizer unrolls this loop and vectorizes it.
             let mut tmp: MaybeUninit<usize>;
-            for i in 0..4 {
+            for i in 0..qwords as isize {
                 tmp = *a_ptr.offset(i);
                 *a_ptr.offset(i) = *b_ptr.offset(i);
                 *b_ptr.offset(i) = tmp;
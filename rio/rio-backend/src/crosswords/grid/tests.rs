@@ -120,6 +120,31 @@ fn scroll_down_with_history() {
     assert_eq!(grid[Line(9)].occ, 1);
 }
 
+// Absolute lines stay on their content while lines rotate into history.
+#[test]
+fn absolute_lines_follow_content() {
+    let mut grid = Grid::<Square>::new(3, 1, 2);
+    grid[Line(2)][Column(0)] = cell('x');
+    let line = grid.absolute_line(Line(2));
+    assert_eq!(line, 2);
+
+    grid.scroll_up(&(Line(0)..Line(3)), 1);
+    assert_eq!(grid.scrolled_lines(), 1);
+    assert_eq!(grid.line_from_absolute(line), Some(Line(1)));
+
+    // Shrinking the screen pushes lines above the cursor into history.
+    grid.cursor.pos.row = Line(2);
+    grid.resize(true, 1, 1);
+    assert_eq!(grid.line_from_absolute(line), Some(Line(-1)));
+    assert_eq!(grid[Line(-1)][Column(0)], cell('x'));
+    assert_eq!(grid.first_absolute_line(), 1);
+
+    grid.scroll_up(&(Line(0)..Line(1)), 1);
+    assert_eq!(grid.line_from_absolute(line), Some(Line(-2)));
+    grid.scroll_up(&(Line(0)..Line(1)), 1);
+    assert_eq!(grid.line_from_absolute(line), None);
+}
+
 // Test that GridIterator works.
 #[test]
 fn test_iter() {
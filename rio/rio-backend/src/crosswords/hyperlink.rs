@@ -0,0 +1,363 @@
+//! Interned OSC 8 hyperlinks.
+//!
+//! Linked output such as `ls --hyperlink` or compiler diagnostics marks every
+//! square of a file name. Instead of sharing a `CellExtra` per square, each
+//! terminal interns the links it has seen and squares store a two byte
+//! [`HyperlinkId`]. Printing linked text is then a plain copy, and comparing
+//! the links of two squares never touches the URI.
+//!
+//! Links without an explicit id get a unique generated one, so they are
+//! interned by URI instead: printing the same anonymous link over and over
+//! takes a single slot. Once the table is full, the owner collects the ids no
+//! square refers to anymore. Collections that free nothing back off, so a
+//! terminal full of distinct live links does not rescan its grids for every
+//! new link.
+//!
+//! Linked squares of a row are grouped into [`HyperlinkSpan`]s, sorted by
+//! column, so hover hit-testing and underline drawing look up a column with a
+//! binary search instead of walking squares left and right.
+
+use crate::crosswords::grid::row::Row;
+use crate::crosswords::pos::Column;
+use crate::crosswords::square::{Hyperlink, Square};
+use rustc_hash::FxHashMap;
+use std::num::NonZeroU16;
+
+/// Upper bound of live hyperlinks, ids must fit in a `NonZeroU16`.
+pub const MAX_HYPERLINKS: usize = u16::MAX as usize;
+
+/// Compact handle of an interned [`Hyperlink`].
+///
+/// Ids are only meaningful for the table that produced them. An id is reused
+/// once [`HyperlinkTable::retain`] dropped its link.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct HyperlinkId(NonZeroU16);
+
+impl HyperlinkId {
+    #[inline]
+    pub fn index(self) -> usize {
+        self.0.get() as usize - 1
+    }
+
+    #[inline]
+    fn from_index(index: usize) -> HyperlinkId {
+        debug_assert!(index < MAX_HYPERLINKS);
+        HyperlinkId(NonZeroU16::new(index as u16 + 1).unwrap())
+    }
+}
+
+/// Largest number of refused links between two collections of a full table.
+const MAX_COLLECT_BACKOFF: usize = 4096;
+
+/// A collection has to free at least this many ids to reset the backoff.
+const MIN_COLLECTED: usize = MAX_HYPERLINKS / 64;
+
+/// Per-terminal table of interned hyperlinks.
+#[derive(Debug)]
+pub struct HyperlinkTable {
+    links: Vec<Option<Hyperlink>>,
+    ids: FxHashMap<Hyperlink, HyperlinkId>,
+    /// Ids of links without an explicit id, keyed by URI.
+    anonymous: FxHashMap<String, HyperlinkId>,
+    /// Slots released by [`Self::retain`].
+    free: Vec<HyperlinkId>,
+    /// Links refused since the last [`Self::retain`].
+    refused: usize,
+    /// Refused links to wait for before the next collection.
+    collect_backoff: usize,
+}
+
+impl Default for HyperlinkTable {
+    fn default() -> HyperlinkTable {
+        HyperlinkTable {
+            links: Vec::new(),
+            ids: FxHashMap::default(),
+            anonymous: FxHashMap::default(),
+            free: Vec::new(),
+            refused: 0,
+            collect_backoff: 1,
+        }
+    }
+}
+
+impl HyperlinkTable {
+    pub fn new() -> HyperlinkTable {
+        HyperlinkTable::default()
+    }
+
+    /// Resolve a hyperlink to its id, interning it if it was not seen before.
+    ///
+    /// Links without an explicit id resolve to the first link seen with the
+    /// same URI. Returns `None` when the table is full, see
+    /// [`Self::should_collect`].
+    pub fn intern(&mut self, link: Hyperlink) -> Option<HyperlinkId> {
+        let existing = if link.has_explicit_id() {
+            self.ids.get(&link)
+        } else {
+            self.anonymous.get(link.uri())
+        };
+        if let Some(id) = existing {
+            return Some(*id);
+        }
+
+        let id = match self.free.pop() {
+            Some(id) => id,
+            None if self.links.len() < MAX_HYPERLINKS => {
+                self.links.push(None);
+                HyperlinkId::from_index(self.links.len() - 1)
+            }
+            None => {
+                self.refused += 1;
+                return None;
+            }
+        };
+        if !link.has_explicit_id() {
+            self.anonymous.insert(link.uri().to_owned(), id);
+        }
+        self.links[id.index()] = Some(link.clone());
+        self.ids.insert(link, id);
+        Some(id)
+    }
+
+    /// Whether the owner should [`Self::retain`] the live links before
+    /// interning again, after [`Self::intern`] refused a link.
+    ///
+    /// The first refusal always collects. While collections keep freeing
+    /// next to nothing, the number of refusals between them doubles up to
+    /// `MAX_COLLECT_BACKOFF`, and refused links are left unlinked.
+    #[inline]
+    pub fn should_collect(&self) -> bool {
+        self.refused >= self.collect_backoff
+    }
+
+    /// Hyperlink behind an id.
+    #[inline]
+    pub fn get(&self, id: HyperlinkId) -> Option<&Hyperlink> {
+        self.links.get(id.index())?.as_ref()
+    }
+
+    /// Number of live hyperlinks.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.ids.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.ids.is_empty()
+    }
+
+    /// Drop every hyperlink `live` returns false for, their ids are reused by
+    /// later calls to [`Self::intern`].
+    pub fn retain(&mut self, mut live: impl FnMut(HyperlinkId) -> bool) {
+        let mut collected = 0;
+        for (index, slot) in self.links.iter_mut().enumerate() {
+            let id = HyperlinkId::from_index(index);
+            if slot.is_none() || live(id) {
+                continue;
+            }
+            if let Some(link) = slot.take() {
+                if !link.has_explicit_id() {
+                    self.anonymous.remove(link.uri());
+                }
+                self.ids.remove(&link);
+                self.free.push(id);
+                collected += 1;
+            }
+        }
+
+        self.refused = 0;
+        self.collect_backoff = if collected >= MIN_COLLECTED {
+            1
+        } else {
+            (self.collect_backoff * 2).min(MAX_COLLECT_BACKOFF)
+        };
+    }
+
+    /// Forget every hyperlink. Previously returned ids become invalid.
+    pub fn clear(&mut self) {
+        self.links.clear();
+        self.ids.clear();
+        self.anonymous.clear();
+        self.free.clear();
+        self.refused = 0;
+        self.collect_backoff = 1;
+    }
+}
+
+/// Run of adjacent squares linked to the same hyperlink.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct HyperlinkSpan {
+    pub start: Column,
+    /// Last column of the span, inclusive.
+    pub end: Column,
+    pub id: HyperlinkId,
+}
+
+impl HyperlinkSpan {
+    #[inline]
+    pub fn contains(&self, column: Column) -> bool {
+        self.start <= column && column <= self.end
+    }
+}
+
+/// Hyperlink spans of a row, in column order.
+pub fn row_spans(row: &Row<Square>) -> Vec<HyperlinkSpan> {
+    let mut spans: Vec<HyperlinkSpan> = Vec::new();
+    for (column, square) in row[..].iter().enumerate() {
+        let id = match square.hyperlink {
+            Some(id) => id,
+            None => continue,
+        };
+        let column = Column(column);
+        match spans.last_mut() {
+            Some(span) if span.id == id && span.end + 1 == column => {
+                span.end = column;
+            }
+            _ => spans.push(HyperlinkSpan {
+                start: column,
+                end: column,
+                id,
+            }),
+        }
+    }
+    spans
+}
+
+/// Span covering `column`, `spans` as returned by [`row_spans`].
+pub fn span_at(spans: &[HyperlinkSpan], column: Column) -> Option<&HyperlinkSpan> {
+    let index = spans.partition_point(|span| span.end < column);
+    spans.get(index).filter(|span| span.contains(column))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn intern_is_stable() {
+        let mut table = HyperlinkTable::new();
+        let a = Hyperlink::new(Some("a"), "https://example.com/a");
+        let b = Hyperlink::new(Some("b"), "https://example.com/b");
+
+        let a_id = table.intern(a.clone()).unwrap();
+        let b_id = table.intern(b.clone()).unwrap();
+        assert_ne!(a_id, b_id);
+        assert_eq!(table.intern(a.clone()), Some(a_id));
+        assert_eq!(table.len(), 2);
+        assert_eq!(table.get(b_id), Some(&b));
+    }
+
+    #[test]
+    fn retain_reuses_dead_ids() {
+        let mut table = HyperlinkTable::new();
+        let ids: Vec<_> = (0..MAX_HYPERLINKS)
+            .map(|i| {
+                let uri = format!("file:///{i}");
+                table.intern(Hyperlink::new(None, uri.as_str())).unwrap()
+            })
+            .collect();
+        let extra = Hyperlink::new(Some("extra"), "file:///extra");
+        assert_eq!(table.intern(extra.clone()), None);
+
+        // Only the last link is still on screen.
+        let last = *ids.last().unwrap();
+        table.retain(|id| id == last);
+        assert_eq!(table.len(), 1);
+        let extra_id = table.intern(extra.clone()).unwrap();
+        assert_ne!(extra_id, last);
+        assert_eq!(table.get(extra_id), Some(&extra));
+        assert_eq!(
+            table.get(last).unwrap().uri(),
+            format!("file:///{}", MAX_HYPERLINKS - 1)
+        );
+    }
+
+    #[test]
+    fn links_without_id_are_interned_by_uri() {
+        let mut table = HyperlinkTable::new();
+        let a = table.intern(Hyperlink::new(None, "file:///a")).unwrap();
+        assert_eq!(table.intern(Hyperlink::new(None, "file:///a")), Some(a));
+        assert_ne!(
+            table.intern(Hyperlink::new(Some("a"), "file:///a")),
+            Some(a)
+        );
+        assert_ne!(table.intern(Hyperlink::new(None, "file:///b")), Some(a));
+        assert_eq!(table.len(), 3);
+
+        table.retain(|id| id != a);
+        let again = table.intern(Hyperlink::new(None, "file:///a")).unwrap();
+        assert_eq!(table.len(), 3);
+        assert_eq!(table.intern(Hyperlink::new(None, "file:///a")), Some(again));
+    }
+
+    #[test]
+    fn full_table_backs_off_collection() {
+        let mut table = HyperlinkTable::new();
+        for i in 0..MAX_HYPERLINKS {
+            let uri = format!("file:///{i}");
+            table.intern(Hyperlink::new(None, uri.as_str())).unwrap();
+        }
+        assert_eq!(table.len(), MAX_HYPERLINKS);
+        let extra = Hyperlink::new(None, "file:///extra");
+        assert!(!table.should_collect());
+        assert_eq!(table.intern(extra.clone()), None);
+        assert!(table.should_collect());
+
+        // Every link is still on screen, each empty collection waits twice as
+        // long for the next one.
+        let mut refusals = Vec::new();
+        for _ in 0..14 {
+            table.retain(|_| true);
+            let mut refused = 0;
+            while !table.should_collect() {
+                assert_eq!(table.intern(extra.clone()), None);
+                refused += 1;
+            }
+            refusals.push(refused);
+        }
+        assert_eq!(refusals[..4], [2, 4, 8, 16]);
+        assert_eq!(*refusals.last().unwrap(), MAX_COLLECT_BACKOFF);
+
+        // A collection that frees ids resets the backoff.
+        table.retain(|id| id.index() >= MIN_COLLECTED);
+        assert_eq!(table.len(), MAX_HYPERLINKS - MIN_COLLECTED);
+        assert!(table.intern(extra.clone()).is_some());
+        for i in 1..MIN_COLLECTED {
+            let uri = format!("file:///more/{i}");
+            table.intern(Hyperlink::new(None, uri.as_str())).unwrap();
+        }
+        assert_eq!(table.intern(Hyperlink::new(None, "file:///late")), None);
+        assert!(table.should_collect());
+    }
+
+    #[test]
+    fn spans_group_adjacent_squares() {
+        let mut table = HyperlinkTable::new();
+        let a = table.intern(Hyperlink::new(Some("a"), "a")).unwrap();
+        let b = table.intern(Hyperlink::new(Some("b"), "b")).unwrap();
+
+        let mut row = Row::<Square>::new(12);
+        for column in [1, 2, 3, 5, 6, 7, 8] {
+            row[Column(column)].hyperlink = Some(a);
+        }
+        for column in [9, 10] {
+            row[Column(column)].hyperlink = Some(b);
+        }
+
+        let spans = row_spans(&row);
+        assert_eq!(
+            spans
+                .iter()
+                .map(|span| (span.start.0, span.end.0, span.id))
+                .collect::<Vec<_>>(),
+            [(1, 3, a), (5, 8, a), (9, 10, b)]
+        );
+        assert_eq!(span_at(&spans, Column(0)), None);
+        assert_eq!(span_at(&spans, Column(2)).unwrap().start, Column(1));
+        assert_eq!(span_at(&spans, Column(4)), None);
+        assert_eq!(span_at(&spans, Column(8)).unwrap().id, a);
+        assert_eq!(span_at(&spans, Column(9)).unwrap().id, b);
+        assert_eq!(span_at(&spans, Column(11)), None);
+    }
+}
@@ -15,12 +15,18 @@
 */
 
 pub mod attr;
+pub mod command_blocks;
 pub mod grid;
+pub mod hyperlink;
 pub mod pos;
 pub mod search;
 pub mod square;
+pub mod sync;
 pub mod vi_mode;
 
+#[cfg(test)]
+mod conformance;
+
 use crate::ansi::graphics::GraphicCell;
 use crate::ansi::graphics::Graphics;
 use crate::ansi::graphics::TextureRef;
@@ -36,6 +42,8 @@ use crate::ansi::{
 use crate::clipboard::ClipboardType;
 use crate::config::colors::{self, AnsiColor, ColorRgb};
 use crate::crosswords::colors::term::TermColors;
+use crate::crosswords::command_blocks::{CommandBlock, CommandBlocks};
+use crate::crosswords::grid::compact::CompactRows;
 use crate::crosswords::grid::{Dimensions, Grid, Scroll};
 use crate::event::WindowId;
 use crate::event::{EventListener, RioEvent, TerminalDamage};
@@ -47,6 +55,7 @@ use base64::{engine::general_purpose, Engine as _};
 use bitflags::bitflags;
 use copa::Params;
 use grid::row::Row;
+use hyperlink::{HyperlinkId, HyperlinkSpan, HyperlinkTable};
 use pos::{
     Boundary, CharsetIndex, Column, Cursor, CursorState, Direction, Line, Pos, Side,
 };
@@ -58,6 +67,7 @@ use std::option::Option;
 use std::ptr;
 use std::sync::Arc;
 use sugarloaf::{GraphicData, MAX_GRAPHIC_DIMENSIONS};
+use sync::{SyncEnd, SyncStatus};
 use tracing::{debug, info, trace, warn};
 use unicode_width::UnicodeWidthChar;
 use vi_mode::{ViModeCursor, ViMotion};
@@ -402,6 +412,24 @@ const TITLE_STACK_MAX_DEPTH: usize = 4096;
 // Max size of the keyboard modes.
 const KEYBOARD_MODE_STACK_MAX_DEPTH: usize = 8;
 
+/// Heap bytes held by a terminal, see [`Crosswords::memory_usage`].
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct MemoryUsage {
+    /// Visible rows of the primary and alternate screens.
+    pub screen: usize,
+    /// Scrollback rows, rows buffered for reuse and hibernated history.
+    pub scrollback: usize,
+    /// Graphics not handed to the renderer yet and Sixel parsing state.
+    pub graphics: usize,
+}
+
+impl MemoryUsage {
+    #[inline]
+    pub fn total(&self) -> usize {
+        self.screen + self.scrollback + self.graphics
+    }
+}
+
 #[derive(Debug)]
 pub struct Crosswords<U>
 where
@@ -438,9 +466,23 @@ where
     /// Search state for this terminal.
     pub search_state: Option<crate::event::SearchState>,
 
-    /// DEC Synchronized Update state (mode 2026).
-    /// When true, rendering should be deferred until ESU is received.
-    pub is_syncing: bool,
+    /// DEC Synchronized Update state (mode 2026), shared with the renderer.
+    /// While syncing, rendering should be deferred until ESU is received.
+    sync_status: Arc<SyncStatus>,
+
+    /// Interned OSC 8 hyperlinks of this terminal, shared by both grids.
+    hyperlinks: HyperlinkTable,
+
+    /// Commands recorded from OSC 133 marks, on the primary screen.
+    command_blocks: CommandBlocks,
+
+    /// Scrollback of the primary screen while hibernated, newest line first.
+    hibernated_history: Option<CompactRows>,
+
+    /// Write printable runs one char at a time, the reference behavior the
+    /// conformance tests hold `input_str` to.
+    #[cfg(test)]
+    reference_input: bool,
 }
 
 impl<U: EventListener> Crosswords<U> {
@@ -494,7 +536,12 @@ impl<U: EventListener> Crosswords<U> {
             inactive_keyboard_mode_stack: Default::default(),
             inactive_keyboard_mode_idx: 0,
             search_state: None,
-            is_syncing: false,
+            sync_status: Arc::new(SyncStatus::default()),
+            hyperlinks: HyperlinkTable::new(),
+            command_blocks: CommandBlocks::default(),
+            hibernated_history: None,
+            #[cfg(test)]
+            reference_input: false,
         }
     }
 
@@ -628,6 +675,7 @@ impl<U: EventListener> Crosswords<U> {
 
     #[inline]
     pub fn scroll_display(&mut self, scroll: Scroll) {
+        self.wake();
         let old_display_offset = self.grid.display_offset();
         self.grid.scroll_display(scroll);
         self.event_proxy
@@ -665,6 +713,85 @@ impl<U: EventListener> Crosswords<U> {
         self.grid.bottommost_line()
     }
 
+    /// Commands recorded from OSC 133 marks, positions are absolute lines of
+    /// the primary screen.
+    #[inline]
+    pub fn command_blocks(&self) -> &CommandBlocks {
+        &self.command_blocks
+    }
+
+    /// Scroll the previous (`Direction::Left`) or next (`Direction::Right`)
+    /// prompt to the top of the viewport.
+    ///
+    /// Returns `false` when there is no prompt in that direction.
+    pub fn scroll_to_prompt(&mut self, direction: Direction) -> bool {
+        if self.mode.contains(Mode::ALT_SCREEN) {
+            return false;
+        }
+        self.wake();
+
+        let top = self
+            .grid
+            .absolute_line(Line(-(self.grid.display_offset() as i32)));
+        let prompt = match direction {
+            Direction::Left => self.command_blocks.previous_prompt(top),
+            Direction::Right => self.command_blocks.next_prompt(top),
+        };
+        let line = match prompt.and_then(|line| self.grid.line_from_absolute(line)) {
+            Some(line) => line,
+            None => return false,
+        };
+
+        let display_offset = std::cmp::max(-line.0, 0);
+        self.scroll_display(Scroll::Delta(
+            display_offset - self.grid.display_offset() as i32,
+        ));
+        true
+    }
+
+    /// Line currently showing the prompt of a command, `None` when it was
+    /// dropped from history or the alternate screen is active.
+    pub fn command_prompt_line(&self, block: &CommandBlock) -> Option<Line> {
+        if self.mode.contains(Mode::ALT_SCREEN) {
+            return None;
+        }
+        self.grid.line_from_absolute(block.prompt_line)
+    }
+
+    /// Output of a command, `None` when it was not executed or its output
+    /// has been dropped from history.
+    pub fn command_output(&mut self, block: &CommandBlock) -> Option<String> {
+        if self.mode.contains(Mode::ALT_SCREEN) {
+            return None;
+        }
+        self.wake();
+
+        let cursor_line = self.grid.absolute_line(self.grid.cursor.pos.row);
+        let (start, end) = block.output_lines(cursor_line)?;
+        if start == end {
+            return Some(String::new());
+        }
+
+        // Output partially rotated out of history is cut at the oldest line.
+        let start = self
+            .grid
+            .line_from_absolute(start.max(self.grid.first_absolute_line()))?;
+        let end = self.grid.line_from_absolute(end - 1)?;
+        if start > end {
+            return None;
+        }
+        Some(self.bounds_to_string(
+            Pos::new(start, Column(0)),
+            Pos::new(end, self.grid.last_column()),
+        ))
+    }
+
+    /// Output of the last command that finished.
+    pub fn last_command_output(&mut self) -> Option<String> {
+        let block = self.command_blocks.last_finished()?.clone();
+        self.command_output(&block)
+    }
+
     #[inline]
     pub fn colors(&self) -> &TermColors {
         &self.colors
@@ -711,6 +838,8 @@ impl<U: EventListener> Crosswords<U> {
             info!("Crosswords::resize dimensions unchanged");
             return;
         }
+        // Hibernated rows have the old width, reflow them with the rest.
+        self.wake();
         // Move vi mode cursor with the content.
         let history_size = self.history_size();
         let mut delta = num_lines as i32 - old_lines as i32;
@@ -930,6 +1059,111 @@ impl<U: EventListener> Crosswords<U> {
             .saturating_sub(self.grid.screen_lines())
     }
 
+    /// Compact the scrollback of the primary screen until [`Self::wake`].
+    ///
+    /// Meant for terminals that are not shown: the screen keeps working and
+    /// new output still scrolls into a fresh history, but anything reading
+    /// older lines needs to wake the terminal first. Scrolling, resizing,
+    /// searching and reading command output wake it on their own.
+    ///
+    /// Returns the number of heap bytes released.
+    pub fn hibernate(&mut self) -> usize {
+        self.wake();
+
+        let alt = self.mode.contains(Mode::ALT_SCREEN);
+        let primary = if alt {
+            &mut self.inactive_grid
+        } else {
+            &mut self.grid
+        };
+        let rows = primary.take_history();
+        if rows.is_empty() {
+            return 0;
+        }
+
+        let mut compact = CompactRows::with_capacity(rows.len());
+        let mut released = 0;
+        for row in &rows {
+            compact.push(row);
+            released += mem::size_of::<Row<Square>>() + row.heap_size();
+        }
+        drop(rows);
+        compact.shrink_to_fit();
+        let released = released.saturating_sub(compact.heap_size());
+        self.hibernated_history = Some(compact);
+
+        if !alt {
+            self.vi_mode_cursor.pos.row = self
+                .vi_mode_cursor
+                .pos
+                .row
+                .grid_clamp(&self.grid, Boundary::Cursor);
+            self.selection = self
+                .selection
+                .take()
+                .filter(|s| !s.intersects_range(..Line(0)));
+            self.mark_fully_damaged();
+        }
+
+        released
+    }
+
+    /// Restore the scrollback compacted by [`Self::hibernate`].
+    ///
+    /// Returns `false` when the terminal was not hibernated.
+    pub fn wake(&mut self) -> bool {
+        let Some(compact) = self.hibernated_history.take() else {
+            return false;
+        };
+
+        let alt = self.mode.contains(Mode::ALT_SCREEN);
+        let primary = if alt {
+            &mut self.inactive_grid
+        } else {
+            &mut self.grid
+        };
+        primary.restore_history(compact.into_rows());
+
+        if !alt {
+            self.mark_fully_damaged();
+        }
+        true
+    }
+
+    #[inline]
+    pub fn is_hibernated(&self) -> bool {
+        self.hibernated_history.is_some()
+    }
+
+    /// Heap bytes of the compacted scrollback, zero unless hibernated.
+    #[inline]
+    pub fn hibernated_size(&self) -> usize {
+        self.hibernated_history
+            .as_ref()
+            .map_or(0, CompactRows::heap_size)
+    }
+
+    /// Heap bytes held by the grids and graphics.
+    ///
+    /// Walks every row, so the cost grows with the scrollback.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        let screen = self.grid.screen_heap_size() + self.inactive_grid.screen_heap_size();
+        let rows = self.grid.heap_size() + self.inactive_grid.heap_size();
+        MemoryUsage {
+            screen,
+            scrollback: rows.saturating_sub(screen) + self.hibernated_size(),
+            graphics: self.graphics.heap_size(),
+        }
+    }
+
+    /// Release the rows the grids buffer for reuse, the text cached by history
+    /// rows and the spare capacity.
+    ///
+    /// Nothing visible changes. Returns the number of heap bytes released.
+    pub fn shrink_to_fit(&mut self) -> usize {
+        self.grid.shrink_to_fit() + self.inactive_grid.shrink_to_fit()
+    }
+
     /// Damage the entire line at the cursor position
     #[inline]
     pub fn damage_cursor_line(&mut self) {
@@ -1056,6 +1290,65 @@ impl<U: EventListener> Crosswords<U> {
         self.mark_fully_damaged();
     }
 
+    /// Whether a DEC synchronized update (mode 2026) is in progress.
+    #[inline]
+    pub fn is_syncing(&self) -> bool {
+        self.sync_status.is_syncing()
+    }
+
+    /// Shared synchronized update status, readable without the terminal lock.
+    #[inline]
+    pub fn sync_status(&self) -> Arc<SyncStatus> {
+        self.sync_status.clone()
+    }
+
+    /// Hyperlink behind the id stored in a square.
+    #[inline]
+    pub fn hyperlink(&self, id: HyperlinkId) -> Option<&Hyperlink> {
+        self.hyperlinks.get(id)
+    }
+
+    /// Hyperlink spans of a row, in column order.
+    ///
+    /// Cached with the row text, so repeated lookups on an unchanged row do
+    /// not walk its squares again.
+    pub fn hyperlink_spans(&self, line: Line) -> &[HyperlinkSpan] {
+        if line < self.grid.topmost_line() || line > self.grid.bottommost_line() {
+            return &[];
+        }
+        self.grid[line].text().hyperlinks()
+    }
+
+    /// Hyperlinked span under `pos`, with the link it points to.
+    pub fn hyperlink_at(&self, pos: Pos) -> Option<(HyperlinkSpan, &Hyperlink)> {
+        if pos.col >= self.grid.columns() {
+            return None;
+        }
+        let span = *hyperlink::span_at(self.hyperlink_spans(pos.row), pos.col)?;
+        Some((span, self.hyperlinks.get(span.id)?))
+    }
+
+    /// Release the hyperlinks no square or cursor template refers to anymore.
+    fn collect_hyperlinks(&mut self) {
+        let mut live = vec![false; hyperlink::MAX_HYPERLINKS];
+        if let Some(history) = &self.hibernated_history {
+            for id in history.hyperlinks() {
+                live[id.index()] = true;
+            }
+        }
+        for grid in [&self.grid, &self.inactive_grid] {
+            let templates = [&grid.cursor.template, &grid.saved_cursor.template];
+            let rows = (grid.topmost_line().0..=grid.bottommost_line().0)
+                .flat_map(|line| grid[Line(line)][..].iter());
+            for square in templates.into_iter().chain(rows) {
+                if let Some(id) = square.hyperlink {
+                    live[id.index()] = true;
+                }
+            }
+        }
+        self.hyperlinks.retain(|id| live[id.index()]);
+    }
+
     #[inline(always)]
     pub fn write_at_cursor(&mut self, c: char) {
         let c = self.grid.cursor.charsets[self.active_charset].map(c);
@@ -1063,6 +1356,7 @@ impl<U: EventListener> Crosswords<U> {
         let bg = self.grid.cursor.template.bg;
         let flags = self.grid.cursor.template.flags;
         let extra = self.grid.cursor.template.extra.clone();
+        let hyperlink = self.grid.cursor.template.hyperlink;
 
         let mut cursor_square = self.grid.cursor_square();
         if cursor_square
@@ -1096,12 +1390,80 @@ impl<U: EventListener> Crosswords<U> {
         cursor_square.bg = bg;
         cursor_square.flags = flags;
         cursor_square.extra = extra;
+        cursor_square.hyperlink = hyperlink;
 
         // 标记当前行为 damaged
         let line = self.grid.cursor.pos.row.0 as usize;
         self.damage.damage_line(line);
     }
 
+    /// Write a run of printable ASCII at the cursor.
+    ///
+    /// Equivalent to calling `input` for every byte, but the wrap and bounds
+    /// checks are done once per row segment and cells are filled in one pass.
+    fn write_ascii_run(&mut self, mut run: &[u8]) {
+        while !run.is_empty() {
+            if self.grid.cursor.should_wrap {
+                self.wrapline();
+
+                // Line wrapping is disabled: every remaining char overwrites
+                // the last column, so only the final one is visible.
+                if self.grid.cursor.should_wrap {
+                    self.write_at_cursor(run[run.len() - 1] as char);
+                    return;
+                }
+            }
+
+            let columns = self.grid.columns();
+            let point = self.grid.cursor.pos;
+            let count = run.len().min(columns - point.col.0);
+            let (segment, rest) = run.split_at(count);
+            run = rest;
+
+            let end = Column(point.col.0 + count);
+            let overwrites_wide =
+                self.grid[point.row][point.col..end].iter().any(|cell| {
+                    cell.flags.intersects(
+                        square::Flags::WIDE_CHAR | square::Flags::WIDE_CHAR_SPACER,
+                    )
+                });
+
+            if overwrites_wide {
+                // Wide char cleanup touches neighbouring cells and rows, keep
+                // it on the per-char path.
+                for &byte in segment {
+                    self.input(byte as char);
+                }
+                continue;
+            }
+
+            let charset = self.grid.cursor.charsets[self.active_charset];
+            let template = &self.grid.cursor.template;
+            let (fg, bg, flags) = (template.fg, template.bg, template.flags);
+            let extra = template.extra.clone();
+            let hyperlink = template.hyperlink;
+
+            let cells = &mut self.grid[point.row][point.col..end];
+            for (cell, &byte) in cells.iter_mut().zip(segment) {
+                cell.c = charset.map(byte as char);
+                cell.fg = fg;
+                cell.bg = bg;
+                cell.flags = flags;
+                cell.extra = extra.clone();
+                cell.hyperlink = hyperlink;
+            }
+
+            self.damage.damage_line(point.row.0 as usize);
+
+            if end.0 < columns {
+                self.grid.cursor.pos.col = end;
+            } else {
+                self.grid.cursor.pos.col = Column(columns - 1);
+                self.grid.cursor.should_wrap = true;
+            }
+        }
+    }
+
     #[inline]
     pub fn visible_rows(&self) -> Vec<Row<Square>> {
         let mut start = self.scroll_region.start.0;
@@ -1344,32 +1706,40 @@ impl<U: EventListener> Crosswords<U> {
             cols.start -= 1;
         }
 
-        let mut tab_mode = false;
-        for column in (cols.start.0..line_length.0).map(Column::from) {
-            let cell = &grid_line[column];
-
-            // Skip over cells until next tab-stop once a tab was found.
-            if tab_mode {
-                if self.tabs[column] || cell.c != ' ' {
-                    tab_mode = false;
-                } else {
-                    continue;
+        // Rows without tabs are copied from the cached row text, tabs expand
+        // up to the next tab stop and need the squares.
+        let row_text = grid_line.text();
+        if !row_text.has_tabs() {
+            text.push_str(row_text.slice(cols.start..line_length));
+        } else {
+            let mut tab_mode = false;
+            for column in (cols.start.0..line_length.0).map(Column::from) {
+                let cell = &grid_line[column];
+
+                // Skip over cells until next tab-stop once a tab was found.
+                if tab_mode {
+                    if self.tabs[column] || cell.c != ' ' {
+                        tab_mode = false;
+                    } else {
+                        continue;
+                    }
                 }
-            }
 
-            if cell.c == '\t' {
-                tab_mode = true;
-            }
+                if cell.c == '\t' {
+                    tab_mode = true;
+                }
 
-            if !cell.flags.intersects(
-                square::Flags::WIDE_CHAR_SPACER | square::Flags::LEADING_WIDE_CHAR_SPACER,
-            ) {
-                // Push cells primary character.
-                text.push(cell.c);
+                if !cell.flags.intersects(
+                    square::Flags::WIDE_CHAR_SPACER
+                        | square::Flags::LEADING_WIDE_CHAR_SPACER,
+                ) {
+                    // Push cells primary character.
+                    text.push(cell.c);
 
-                // Push zero-width characters.
-                for c in cell.zerowidth().into_iter().flatten() {
-                    text.push(*c);
+                    // Push zero-width characters.
+                    for c in cell.zerowidth().into_iter().flatten() {
+                        text.push(*c);
+                    }
                 }
             }
         }
@@ -1448,7 +1818,15 @@ impl<U: EventListener> Crosswords<U> {
 impl<U: EventListener> Handler for Crosswords<U> {
     #[inline]
     fn set_syncing(&mut self, syncing: bool) {
-        self.is_syncing = syncing;
+        self.sync_status.set_syncing(syncing);
+    }
+
+    #[inline]
+    fn sync_ended(&mut self, end: SyncEnd) {
+        if end != SyncEnd::Completed {
+            debug!("Synchronized update aborted: {:?}", end);
+        }
+        self.sync_status.record_end(end);
     }
 
     #[inline]
@@ -2004,6 +2382,8 @@ impl<U: EventListener> Handler for Crosswords<U> {
         self.cursor_shape = self.default_cursor_shape;
         self.grid.reset();
         self.inactive_grid.reset();
+        self.hibernated_history = None;
+        self.hyperlinks.clear();
         self.scroll_region = Line(0)..Line(self.grid.screen_lines() as i32);
         self.tabs = TabStops::new(self.grid.columns());
         self.title_stack = Vec::new();
@@ -2013,6 +2393,7 @@ impl<U: EventListener> Handler for Crosswords<U> {
         self.inactive_keyboard_mode_idx = 0;
         self.title = String::from("");
         self.selection = None;
+        self.command_blocks.clear();
         self.vi_mode_cursor = Default::default();
         self.keyboard_mode_stack = Default::default();
         self.inactive_keyboard_mode_stack = Default::default();
@@ -2109,7 +2490,36 @@ impl<U: EventListener> Handler for Crosswords<U> {
             .send_event(RioEvent::CurrentDirectoryChanged(path), self.window_id);
     }
 
+    fn shell_prompt_start(&mut self) {
+        if self.mode.contains(Mode::ALT_SCREEN) {
+            return;
+        }
+
+        // Lines of a hibernated history are still above the grid's oldest one.
+        let hibernated = self.hibernated_history.as_ref().map_or(0, CompactRows::len);
+        self.command_blocks
+            .prune(self.grid.first_absolute_line().saturating_sub(hibernated));
+        let line = self.grid.absolute_line(self.grid.cursor.pos.row);
+        self.command_blocks.prompt_start(line);
+    }
+
+    fn shell_command_start(&mut self) {
+        if self.mode.contains(Mode::ALT_SCREEN) {
+            return;
+        }
+
+        let pos = self.grid.cursor.pos;
+        self.command_blocks
+            .command_start(self.grid.absolute_line(pos.row), pos.col);
+    }
+
     fn shell_command_execute(&mut self, command: Option<&str>) {
+        if !self.mode.contains(Mode::ALT_SCREEN) {
+            let line = self.grid.absolute_line(self.grid.cursor.pos.row);
+            self.command_blocks
+                .command_execute(line, command, std::time::Instant::now());
+        }
+
         if let Some(cmd) = command {
             trace!("Shell command execute: {}", cmd);
             // 发送命令执行事件（实时通知 Swift 侧更新 Tab Title）
@@ -2118,6 +2528,20 @@ impl<U: EventListener> Handler for Crosswords<U> {
         }
     }
 
+    fn shell_command_finished(&mut self, exit_code: Option<u8>) {
+        if self.mode.contains(Mode::ALT_SCREEN) {
+            return;
+        }
+
+        let pos = self.grid.cursor.pos;
+        self.command_blocks.command_finished(
+            self.grid.absolute_line(pos.row),
+            pos.col,
+            exit_code,
+            std::time::Instant::now(),
+        );
+    }
+
     #[inline]
     fn set_cursor_style(&mut self, style: Option<CursorShape>, blinking: bool) {
         if let Some(cursor_shape) = style {
@@ -2229,6 +2653,7 @@ impl<U: EventListener> Handler for Crosswords<U> {
                         self.grid[row][next_col].fg = fg;
                         self.grid[row][next_col].flags = square::Flags::WIDE_CHAR_SPACER;
                         self.grid[row][next_col].extra = None;
+                        self.grid[row][next_col].hyperlink = None;
 
                         // 更新光标位置（跳过 spacer）
                         if self.grid.cursor.pos.col.0 <= column.0 + 1 {
@@ -2321,6 +2746,45 @@ impl<U: EventListener> Handler for Crosswords<U> {
         }
     }
 
+    #[inline(never)]
+    fn input_str(&mut self, text: &str) {
+        #[cfg(test)]
+        if self.reference_input {
+            for c in text.chars() {
+                self.input(c);
+            }
+            return;
+        }
+
+        let bytes = text.as_bytes();
+        let mut i = 0;
+
+        while i < bytes.len() {
+            // Printable ASCII is always a single narrow cell, anything else
+            // (wide, zero-width, DEL) takes the per-char path.
+            let run = bytes[i..]
+                .iter()
+                .position(|byte| !(0x20..0x7F).contains(byte))
+                .unwrap_or(bytes.len() - i);
+
+            if run == 0 {
+                let c = unsafe { text.get_unchecked(i..) }.chars().next().unwrap();
+                self.input(c);
+                i += c.len_utf8();
+                continue;
+            }
+
+            if self.mode.contains(Mode::INSERT) {
+                for &byte in &bytes[i..i + run] {
+                    self.input(byte as char);
+                }
+            } else {
+                self.write_ascii_run(&bytes[i..i + run]);
+            }
+            i += run;
+        }
+    }
+
     #[inline]
     fn identify_terminal(&mut self, intermediate: Option<char>) {
         match intermediate {
@@ -2445,6 +2909,10 @@ impl<U: EventListener> Handler for Crosswords<U> {
     fn clear_screen(&mut self, mode: ClearMode) {
         let bg = self.grid.cursor.template.bg;
 
+        if matches!(mode, ClearMode::Saved) && !self.mode.contains(Mode::ALT_SCREEN) {
+            self.hibernated_history = None;
+        }
+
         let screen_lines = self.grid.screen_lines();
 
         match mode {
@@ -2550,7 +3018,17 @@ impl<U: EventListener> Handler for Crosswords<U> {
 
     #[inline]
     fn set_hyperlink(&mut self, hyperlink: Option<Hyperlink>) {
-        self.grid.cursor.template.set_hyperlink(hyperlink);
+        let id = match hyperlink {
+            Some(link) => match self.hyperlinks.intern(link.clone()) {
+                None if self.hyperlinks.should_collect() => {
+                    self.collect_hyperlinks();
+                    self.hyperlinks.intern(link)
+                }
+                id => id,
+            },
+            None => None,
+        };
+        self.grid.cursor.template.hyperlink = id;
     }
 
     /// Set the indexed color value.
@@ -3216,6 +3694,50 @@ pub enum SearchError {
     InvalidPattern,
 }
 
+/// Lines scanned between two cancellation checks of
+/// [`Crosswords::search_matches`].
+const SEARCH_CHUNK_LINES: usize = 1024;
+
+/// Turn a user query into the pattern compiled by [`search::RegexSearch`].
+pub fn search_pattern(pattern: &str, is_regex: bool, case_sensitive: bool) -> String {
+    // Process pattern: escape if not regex
+    let pattern = if is_regex {
+        pattern.to_string()
+    } else {
+        regex::escape(pattern)
+    };
+
+    // RegexSearch on its own is smart-case, pin the requested case
+    // sensitivity so regex queries agree with literal ones
+    if case_sensitive {
+        format!("(?-i){}", pattern)
+    } else {
+        format!("(?i){}", pattern)
+    }
+}
+
+/// Compile a user query once, the result can be cloned to search several
+/// terminals.
+///
+/// Plain text, and regex input without metacharacters, becomes a
+/// [`search::LiteralSearch`]. Only real patterns build the regex DFAs.
+pub fn compile_search(
+    pattern: &str,
+    is_regex: bool,
+    case_sensitive: bool,
+) -> Result<search::SearchQuery, SearchError> {
+    let is_literal = !is_regex || regex::escape(pattern) == pattern;
+    if is_literal {
+        if let Some(literal) = search::LiteralSearch::new(pattern, case_sensitive) {
+            return Ok(search::SearchQuery::Literal(literal));
+        }
+    }
+
+    search::RegexSearch::new(&search_pattern(pattern, is_regex, case_sensitive))
+        .map(|regex| search::SearchQuery::Regex(Box::new(regex)))
+        .map_err(|_| SearchError::InvalidPattern)
+}
+
 impl<U: EventListener> Crosswords<U> {
     /// Start a new search with the given pattern.
     pub fn start_search(
@@ -3225,29 +3747,11 @@ impl<U: EventListener> Crosswords<U> {
         case_sensitive: bool,
         max_lines: Option<usize>,
     ) -> Result<SearchInfo, SearchError> {
-        // Process pattern: escape if not regex
-        let pattern = if is_regex {
-            pattern.to_string()
-        } else {
-            regex::escape(pattern)
-        };
-
-        // Create case-insensitive pattern if needed
-        let pattern = if !case_sensitive && !pattern.chars().any(|c| c.is_uppercase()) {
-            pattern
-        } else if !case_sensitive {
-            // Convert to case-insensitive regex
-            format!("(?i){}", pattern)
-        } else {
-            pattern
-        };
-
-        // Create RegexSearch
-        let mut regex = search::RegexSearch::new(&pattern)
-            .map_err(|_| SearchError::InvalidPattern)?;
+        self.wake();
+        let mut query = compile_search(pattern, is_regex, case_sensitive)?;
 
         // Find all matches
-        let all_matches = self.find_all_matches(&mut regex, max_lines);
+        let all_matches = self.find_all_matches(&mut query, max_lines);
 
         if all_matches.is_empty() {
             self.search_state = None;
@@ -3265,9 +3769,13 @@ impl<U: EventListener> Crosswords<U> {
         self.search_state = Some(crate::event::SearchState {
             all_matches: all_matches.clone(),
             focused_index: 0,
-            dfas: Some(regex),
+            dfas: match query {
+                search::SearchQuery::Regex(regex) => Some(*regex),
+                search::SearchQuery::Literal(_) => None,
+            },
             direction: Direction::Right,
-            history: std::collections::VecDeque::from([pattern]),
+            // Raw query, resize searches it again with the same options.
+            history: std::collections::VecDeque::from([pattern.to_string()]),
             history_index: Some(0),
             origin: Pos::default(),
             display_offset_delta: 0,
@@ -3321,11 +3829,37 @@ impl<U: EventListener> Crosswords<U> {
     /// Internal method: find all matches within the specified line limit.
     fn find_all_matches(
         &self,
-        regex: &mut search::RegexSearch,
+        query: &mut search::SearchQuery,
         max_lines: Option<usize>,
     ) -> Vec<search::Match> {
         let mut matches = Vec::new();
+        self.search_matches(
+            query,
+            max_lines,
+            |m| {
+                matches.push(m);
+                // 安全保护：超过 10000 个匹配就停止
+                matches.len() < 10000
+            },
+            || false,
+        );
+        matches
+    }
 
+    /// Report every match from the top of the history down to the bottom of
+    /// the screen, or only within the last `max_lines` lines.
+    ///
+    /// `visit` returns false to stop. The grid is scanned in chunks of about
+    /// [`SEARCH_CHUNK_LINES`] lines that end on an unwrapped line, matches
+    /// never cross those, and the search stops before the next chunk once
+    /// `cancelled` returns true.
+    pub fn search_matches(
+        &self,
+        query: &mut search::SearchQuery,
+        max_lines: Option<usize>,
+        mut visit: impl FnMut(search::Match) -> bool,
+        cancelled: impl Fn() -> bool,
+    ) {
         // 计算搜索范围
         // Line 坐标系：Line(0) = 屏幕顶部, Line(-N) = 历史记录
         let history_size = self.grid.history_size();
@@ -3343,19 +3877,63 @@ impl<U: EventListener> Crosswords<U> {
             start_line
         };
 
-        let start = Pos::new(Line(start_line), Column(0));
-        let end = Pos::new(Line(end_line), self.grid.last_column());
+        let mut from = self.grid.absolute_line(Line(start_line));
+        while !cancelled() {
+            match self.search_chunk(query, from, &mut visit) {
+                Some(next) => from = next,
+                None => return,
+            }
+        }
+    }
 
-        let iter = search::RegexIter::new(start, end, Direction::Right, self, regex);
-        for m in iter {
-            matches.push(m);
-            // 安全保护：超过 10000 个匹配就停止
-            if matches.len() >= 10000 {
-                break;
+    /// Report the matches of a single chunk of [`Self::search_matches`],
+    /// starting at absolute line `from` (see [`Grid::absolute_line`]).
+    ///
+    /// Returns the absolute line the next chunk starts at, or `None` once the
+    /// bottom of the screen was searched or `visit` returned false. A `from`
+    /// that was dropped from history meanwhile starts at the oldest line, so
+    /// callers can release the terminal between chunks and resume.
+    pub fn search_chunk(
+        &self,
+        query: &mut search::SearchQuery,
+        from: usize,
+        mut visit: impl FnMut(search::Match) -> bool,
+    ) -> Option<usize> {
+        let from = from.max(self.grid.first_absolute_line());
+        let chunk_start = self.grid.line_from_absolute(from)?.0;
+        let end_line = (self.grid.screen_lines() as i32) - 1;
+        let last_column = self.grid.last_column();
+
+        let mut chunk_end = (chunk_start + SEARCH_CHUNK_LINES as i32 - 1).min(end_line);
+        while chunk_end < end_line
+            && self.grid[Line(chunk_end)][last_column]
+                .flags
+                .contains(square::Flags::WRAPLINE)
+        {
+            chunk_end += 1;
+        }
+
+        match query {
+            search::SearchQuery::Literal(literal) => {
+                let (start, end) = (Line(chunk_start), Line(chunk_end));
+                if !self.literal_search(literal, start, end, &mut visit) {
+                    return None;
+                }
+            }
+            search::SearchQuery::Regex(regex) => {
+                let start = Pos::new(Line(chunk_start), Column(0));
+                let end = Pos::new(Line(chunk_end), last_column);
+                let iter =
+                    search::RegexIter::new(start, end, Direction::Right, self, regex);
+                for m in iter {
+                    if !visit(m) {
+                        return None;
+                    }
+                }
             }
         }
 
-        matches
+        (chunk_end < end_line).then(|| self.grid.absolute_line(Line(chunk_end + 1)))
     }
 }
 
@@ -4353,4 +4931,552 @@ mod tests {
             "mode() should not contain REPORT_EVENT_TYPES after replace"
         );
     }
+
+    fn assert_input_str_matches_input(
+        setup: impl Fn(&mut Crosswords<VoidListener>),
+        text: &str,
+    ) {
+        let size = CrosswordsSize::new(10, 4);
+        let window_id = WindowId::from(0);
+        let mut per_char =
+            Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let mut bulk =
+            Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+        setup(&mut per_char);
+        setup(&mut bulk);
+
+        for c in text.chars() {
+            per_char.input(c);
+        }
+        bulk.input_str(text);
+
+        assert!(per_char.grid == bulk.grid, "grid mismatch for {text:?}");
+        assert_eq!(per_char.grid.cursor.pos, bulk.grid.cursor.pos);
+        assert_eq!(
+            per_char.grid.cursor.should_wrap,
+            bulk.grid.cursor.should_wrap
+        );
+    }
+
+    #[test]
+    fn test_input_str_matches_input() {
+        // Wraps across rows and scrolls
+        assert_input_str_matches_input(
+            |_| {},
+            "the quick brown fox jumps over the lazy dog!",
+        );
+        // Mixed narrow, wide and zero-width
+        assert_input_str_matches_input(|_| {}, "ab中文cd\u{301}e😀fghijk");
+        // Overwriting a wide char with ASCII clears its spacer
+        assert_input_str_matches_input(
+            |term| {
+                term.input('中');
+                term.input('文');
+                term.goto(Line(0), Column(1));
+            },
+            "xyz",
+        );
+        // Insert mode shifts existing cells
+        assert_input_str_matches_input(
+            |term| {
+                term.input_str("0123456");
+                term.goto(Line(0), Column(2));
+                term.mode.insert(Mode::INSERT);
+            },
+            "ab",
+        );
+        // Line wrap disabled keeps overwriting the last column
+        assert_input_str_matches_input(
+            |term| term.mode.remove(Mode::LINE_WRAP),
+            "0123456789abcdef",
+        );
+        // Charset mapping and template attributes are applied
+        assert_input_str_matches_input(
+            |term| {
+                term.configure_charset(
+                    CharsetIndex::G0,
+                    pos::StandardCharset::SpecialCharacterAndLineDrawing,
+                );
+                term.grid.cursor.template.flags.insert(square::Flags::BOLD);
+            },
+            "lqqk",
+        );
+    }
+
+    #[test]
+    fn test_hyperlink_keeps_template_extra() {
+        let size = CrosswordsSize::new(10, 4);
+        let window_id = WindowId::from(0);
+        let mut term =
+            Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+
+        term.terminal_attribute(Attr::UnderlineColor(Some(AnsiColor::Indexed(4))));
+        term.input('a');
+        let a = term.grid[Line(0)][Column(0)].clone();
+
+        // Hyperlinks live outside the extra, linked text shares it as well
+        term.set_hyperlink(Some(Hyperlink::new(None, "https://example.com")));
+        term.input('d');
+        let d = term.grid[Line(0)][Column(1)].clone();
+        assert!(d.hyperlink.is_some());
+        assert!(Arc::ptr_eq(
+            a.extra.as_ref().unwrap(),
+            d.extra.as_ref().unwrap()
+        ));
+    }
+
+    #[test]
+    fn test_hyperlinks_are_interned() {
+        let size = CrosswordsSize::new(20, 4);
+        let window_id = WindowId::from(0);
+        let mut term =
+            Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let mut processor: crate::performer::handler::Processor =
+            crate::performer::handler::Processor::new();
+        processor.advance(
+            &mut term,
+            b"ab\x1b]8;id=x;https://a.example\x1b\\link\x1b]8;;\x1b\\ \
+              \x1b]8;id=x;https://a.example\x1b\\again\x1b]8;;\x1b\\",
+        );
+
+        let first = term.grid[Line(0)][Column(2)].hyperlink.unwrap();
+        assert_eq!(term.grid[Line(0)][Column(10)].hyperlink, Some(first));
+        assert_eq!(term.grid[Line(0)][Column(6)].hyperlink, None);
+        assert_eq!(term.hyperlink(first).unwrap().uri(), "https://a.example");
+
+        let spans = term.hyperlink_spans(Line(0));
+        assert_eq!(spans.len(), 2);
+        let (span, link) = term.hyperlink_at(Pos::new(Line(0), Column(4))).unwrap();
+        assert_eq!((span.start, span.end), (Column(2), Column(5)));
+        assert_eq!(link.id(), "x");
+        assert!(term.hyperlink_at(Pos::new(Line(0), Column(6))).is_none());
+        assert!(term.hyperlink_at(Pos::new(Line(0), Column(40))).is_none());
+
+        // Collection keeps only links still referenced by squares or templates
+        processor.advance(&mut term, b"\x1b]8;id=y;https://b.example\x1b\\b");
+        for column in 2..12 {
+            term.grid[Line(0)][Column(column)].hyperlink = None;
+        }
+        term.collect_hyperlinks();
+        assert_eq!(term.hyperlinks.len(), 1);
+        assert!(term.hyperlink(first).is_none());
+        // The cached span index follows writes to the row
+        assert_eq!(term.hyperlink_spans(Line(0)).len(), 1);
+        processor.advance(&mut term, b"\r\x1b]8;;https://c.example\x1b\\cc");
+        assert_eq!(term.hyperlink_spans(Line(0)).len(), 2);
+        assert!(term.hyperlink_at(Pos::new(Line(0), Column(1))).is_some());
+    }
+
+    #[test]
+    fn test_full_hyperlink_table_is_collected() {
+        let size = CrosswordsSize::new(20, 4);
+        let window_id = WindowId::from(0);
+        let mut term =
+            Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+
+        // Links without an id share a slot per URI
+        term.set_hyperlink(Some(Hyperlink::new(None, "file:///a")));
+        let a = term.grid.cursor.template.hyperlink;
+        term.input('a');
+        term.set_hyperlink(Some(Hyperlink::new(None, "file:///a")));
+        term.input('a');
+        assert_eq!(term.grid[Line(0)][Column(1)].hyperlink, a);
+        assert_eq!(term.hyperlinks.len(), 1);
+
+        // Fill the table with links nothing refers to anymore
+        for i in 1..hyperlink::MAX_HYPERLINKS {
+            let uri = format!("file:///{i}");
+            term.hyperlinks
+                .intern(Hyperlink::new(None, uri.as_str()))
+                .unwrap();
+        }
+        assert_eq!(term.hyperlinks.len(), hyperlink::MAX_HYPERLINKS);
+
+        term.set_hyperlink(Some(Hyperlink::new(Some("b"), "file:///b")));
+        let b = term.grid.cursor.template.hyperlink.unwrap();
+        assert_eq!(term.hyperlink(b).unwrap().id(), "b");
+        assert_eq!(term.hyperlinks.len(), 2);
+        assert_eq!(term.grid[Line(0)][Column(0)].hyperlink, a);
+    }
+
+    #[test]
+    fn hibernate_compacts_and_restores_history() {
+        struct Size;
+        impl Dimensions for Size {
+            fn total_lines(&self) -> usize {
+                104
+            }
+            fn screen_lines(&self) -> usize {
+                4
+            }
+            fn columns(&self) -> usize {
+                20
+            }
+        }
+
+        let window_id = crate::event::WindowId::from(0);
+        let mut cw =
+            Crosswords::new(Size, CursorShape::Block, VoidListener {}, window_id, 0);
+        for line in 0..50 {
+            cw.input_str(&format!("line {line}"));
+            cw.carriage_return();
+            cw.linefeed();
+        }
+        let history = cw.history_size();
+        let rows: Vec<_> = (1..=history as i32)
+            .map(|line| cw.grid[Line(-line)].clone())
+            .collect();
+
+        assert!(cw.hibernate() > 0);
+        assert!(cw.is_hibernated());
+        assert_eq!(cw.history_size(), 0);
+        assert!(cw.hibernated_size() > 0);
+
+        // Output keeps scrolling into a fresh history while hibernated.
+        cw.input_str("new");
+        cw.carriage_return();
+        cw.linefeed();
+        assert_eq!(cw.history_size(), 1);
+
+        assert!(cw.wake());
+        assert!(!cw.is_hibernated());
+        assert_eq!(cw.history_size(), history + 1);
+        assert_eq!(cw.grid[Line(-2)].text().as_str().trim_end(), "line 46");
+        for (offset, row) in rows.iter().enumerate() {
+            assert_eq!(&cw.grid[Line(-(offset as i32) - 2)], row);
+        }
+
+        // Scrolling wakes a hibernated terminal by itself.
+        cw.hibernate();
+        cw.scroll_display(Scroll::Top);
+        assert_eq!(cw.history_size(), history + 1);
+        assert_eq!(cw.grid.display_offset(), history + 1);
+    }
+
+    #[test]
+    fn memory_usage_tracks_scrollback() {
+        struct Size;
+        impl Dimensions for Size {
+            fn total_lines(&self) -> usize {
+                104
+            }
+            fn screen_lines(&self) -> usize {
+                4
+            }
+            fn columns(&self) -> usize {
+                20
+            }
+        }
+
+        let window_id = crate::event::WindowId::from(0);
+        let mut cw =
+            Crosswords::new(Size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let empty = cw.memory_usage();
+        assert!(empty.screen > 0);
+        assert_eq!(empty.graphics, 0);
+
+        for line in 0..50 {
+            cw.input_str(&format!("line {line}"));
+            cw.carriage_return();
+            cw.linefeed();
+        }
+        let usage = cw.memory_usage();
+        assert_eq!(usage.screen, empty.screen);
+        assert!(usage.scrollback > 50 * 20 * mem::size_of::<Square>());
+
+        // Rows buffered for reuse go away, the history stays.
+        let history = cw.history_size();
+        assert!(cw.shrink_to_fit() > 0);
+        assert_eq!(cw.history_size(), history);
+        let shrunk = cw.memory_usage();
+        assert!(shrunk.scrollback < usage.scrollback);
+
+        // Hibernated history is accounted in its compact form.
+        cw.hibernate();
+        assert!(cw.memory_usage().scrollback < shrunk.scrollback);
+    }
+
+    #[test]
+    fn history_rows_drop_cached_text() {
+        struct Size;
+        impl Dimensions for Size {
+            fn total_lines(&self) -> usize {
+                104
+            }
+            fn screen_lines(&self) -> usize {
+                4
+            }
+            fn columns(&self) -> usize {
+                20
+            }
+        }
+
+        let window_id = crate::event::WindowId::from(0);
+        let mut cw =
+            Crosswords::new(Size, CursorShape::Block, VoidListener {}, window_id, 0);
+        cw.input_str("first");
+        assert_eq!(cw.grid[Line(0)].text().as_str().trim_end(), "first");
+        cw.carriage_return();
+        for line in 0..50 {
+            cw.linefeed();
+            cw.input_str(&format!("line {line}"));
+            cw.carriage_return();
+        }
+
+        // Scrolled into history without its text.
+        let history = cw.history_size() as i32;
+        assert_eq!(cw.grid[Line(-history)][Column(0)].c, 'f');
+        assert_eq!(cw.grid[Line(-history)].drop_text(), 0);
+
+        // A search reads history rows without caching their text.
+        let info = cw.start_search("line 4", false, true, None).unwrap();
+        assert_eq!(info.total_count, 11);
+        assert!((1..=history).all(|line| cw.grid[Line(-line)].drop_text() == 0));
+        assert!(cw.grid[Line(0)].drop_text() > 0);
+
+        // Columns of uncached history rows still map back through wide chars.
+        cw.linefeed();
+        cw.input_str("中文 Wide");
+        cw.carriage_return();
+        for _ in 0..4 {
+            cw.linefeed();
+        }
+        let mut query = compile_search("wide", false, false).unwrap();
+        let mut matches = Vec::new();
+        cw.search_matches(
+            &mut query,
+            None,
+            |m| {
+                matches.push(m);
+                true
+            },
+            || false,
+        );
+        assert_eq!(matches.len(), 1);
+        let (start, end) = (*matches[0].start(), *matches[0].end());
+        assert!(start.row < Line(0));
+        assert_eq!((start.col, end.col), (Column(5), Column(8)));
+        assert_eq!(cw.grid[start.row][Column(5)].c, 'W');
+        assert!(cw.grid[start.row].cached_text().is_none());
+    }
+
+    #[test]
+    fn command_blocks_from_osc_133() {
+        struct Size;
+        impl Dimensions for Size {
+            fn total_lines(&self) -> usize {
+                104
+            }
+            fn screen_lines(&self) -> usize {
+                4
+            }
+            fn columns(&self) -> usize {
+                20
+            }
+        }
+
+        let window_id = crate::event::WindowId::from(0);
+        let mut cw = Crosswords::new(Size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let mut processor: crate::performer::handler::Processor =
+            crate::performer::handler::Processor::new();
+
+        processor.advance(
+            &mut cw,
+            b"\x1b]133;A\x07$ \x1b]133;B\x07seq 3\r\n\x1b]133;C;seq 3\x07\
+              1\r\n2\r\n3\r\n\x1b]133;D;0\x07",
+        );
+        processor.advance(
+            &mut cw,
+            b"\x1b]133;A\x07$ \x1b]133;B\x07false\r\n\x1b]133;C;false\x07\
+              \x1b]133;D;1\x07\x1b]133;A\x07$ ",
+        );
+
+        let blocks: Vec<_> = cw.command_blocks().iter().cloned().collect();
+        assert_eq!(blocks.len(), 3);
+        assert_eq!(blocks[0].command.as_deref(), Some("seq 3"));
+        assert_eq!(blocks[0].exit_code, Some(0));
+        assert_eq!(cw.command_output(&blocks[0]).as_deref(), Some("1\n2\n3"));
+        assert_eq!(blocks[1].exit_code, Some(1));
+        assert_eq!(cw.last_command_output().as_deref(), Some(""));
+
+        // Prompts stay findable after they scrolled into history.
+        assert_eq!(cw.grid.scrolled_lines(), 2);
+        assert!(cw.scroll_to_prompt(Direction::Left));
+        assert_eq!(cw.grid.display_offset(), 2);
+        assert!(!cw.scroll_to_prompt(Direction::Left));
+        assert!(cw.scroll_to_prompt(Direction::Right));
+        assert_eq!(cw.grid.display_offset(), 0);
+
+        // RIS forgets everything.
+        processor.advance(&mut cw, b"\x1bc");
+        assert!(cw.command_blocks().is_empty());
+    }
+
+    #[test]
+    fn command_blocks_survive_hibernation() {
+        struct Size;
+        impl Dimensions for Size {
+            fn total_lines(&self) -> usize {
+                104
+            }
+            fn screen_lines(&self) -> usize {
+                4
+            }
+            fn columns(&self) -> usize {
+                20
+            }
+        }
+
+        let window_id = crate::event::WindowId::from(0);
+        let mut cw =
+            Crosswords::new(Size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let mut processor: crate::performer::handler::Processor =
+            crate::performer::handler::Processor::new();
+
+        processor.advance(
+            &mut cw,
+            b"\x1b]133;A\x07$ \x1b]133;B\x07seq 10\r\n\x1b]133;C;seq 10\x07\
+              1\r\n2\r\n3\r\n4\r\n5\r\n6\r\n7\r\n8\r\n9\r\n10\r\n\x1b]133;D;0\x07\
+              \r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n",
+        );
+        // The whole block is in the history that gets hibernated.
+        assert_eq!(cw.grid.scrolled_lines(), 16);
+        assert!(cw.hibernate() > 0);
+
+        // The next prompt keeps the block whose lines are hibernated.
+        processor.advance(&mut cw, b"\x1b]133;A\x07$ ");
+        assert!(cw.is_hibernated());
+        assert_eq!(cw.command_blocks().len(), 2);
+
+        // Reading the output wakes the terminal.
+        assert_eq!(
+            cw.last_command_output().as_deref(),
+            Some("1\n2\n3\n4\n5\n6\n7\n8\n9\n10")
+        );
+        assert!(!cw.is_hibernated());
+
+        // So does jumping to a prompt in the hibernated history.
+        cw.hibernate();
+        assert!(cw.scroll_to_prompt(Direction::Left));
+        assert!(!cw.is_hibernated());
+        assert_eq!(cw.grid.display_offset(), cw.history_size());
+    }
+
+    #[test]
+    fn search_matches_in_chunks() {
+        struct Size;
+        impl Dimensions for Size {
+            fn total_lines(&self) -> usize {
+                3004
+            }
+            fn screen_lines(&self) -> usize {
+                4
+            }
+            fn columns(&self) -> usize {
+                10
+            }
+        }
+
+        let window_id = crate::event::WindowId::from(0);
+        let mut cw =
+            Crosswords::new(Size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let mut processor: crate::performer::handler::Processor =
+            crate::performer::handler::Processor::new();
+
+        // The wrapped line straddles the end of the first chunk.
+        processor.advance(&mut cw, &b"foo\r\n".repeat(SEARCH_CHUNK_LINES - 1));
+        processor.advance(&mut cw, b"abcdefghijklmno\r\n");
+        processor.advance(&mut cw, &b"foo\r\n".repeat(1500));
+
+        let search = |cw: &Crosswords<VoidListener>, pattern, cancel_after: usize| {
+            let mut query = compile_search(pattern, false, false).unwrap();
+            let mut matches = Vec::new();
+            let chunks = std::cell::Cell::new(0);
+            cw.search_matches(
+                &mut query,
+                None,
+                |m| {
+                    matches.push(m);
+                    true
+                },
+                || {
+                    chunks.set(chunks.get() + 1);
+                    chunks.get() > cancel_after
+                },
+            );
+            matches
+        };
+
+        // Literal and regex both find the match across the wrap.
+        let history = cw.grid.history_size() as i32;
+        for pattern in ["jk", "j[k]"] {
+            let mut query = compile_search(pattern, true, false).unwrap();
+            let mut matches = Vec::new();
+            cw.search_matches(
+                &mut query,
+                None,
+                |m| {
+                    matches.push(m);
+                    true
+                },
+                || false,
+            );
+            assert_eq!(matches.len(), 1);
+            assert_eq!(
+                matches[0].start().row.0 + history,
+                SEARCH_CHUNK_LINES as i32 - 1
+            );
+            assert_eq!(matches[0].start().col, Column(9));
+            assert_eq!(matches[0].end().col, Column(0));
+        }
+
+        assert_eq!(
+            search(&cw, "FOO", usize::MAX).len(),
+            1500 + SEARCH_CHUNK_LINES - 1
+        );
+        // Cancelled after the first chunk.
+        assert_eq!(search(&cw, "foo", 1).len(), SEARCH_CHUNK_LINES - 1);
+    }
+
+    #[test]
+    fn literal_and_regex_search_agree_on_case() {
+        let size = CrosswordsSize::new(20, 4);
+        let window_id = WindowId::from(0);
+        let mut cw =
+            Crosswords::new(size, CursorShape::Block, VoidListener {}, window_id, 0);
+        let mut processor: crate::performer::handler::Processor =
+            crate::performer::handler::Processor::new();
+        processor.advance(&mut cw, b"foo Foo FOO");
+
+        let match_columns = |mut query: search::SearchQuery| {
+            let mut columns = Vec::new();
+            cw.search_matches(
+                &mut query,
+                None,
+                |m| {
+                    columns.push(m.start().col.0);
+                    true
+                },
+                || false,
+            );
+            columns
+        };
+
+        for (pattern, case_sensitive, expected) in [
+            ("foo", true, vec![0]),
+            ("Foo", true, vec![4]),
+            ("foo", false, vec![0, 4, 8]),
+            ("Foo", false, vec![0, 4, 8]),
+        ] {
+            let literal = compile_search(pattern, false, case_sensitive).unwrap();
+            assert!(matches!(literal, search::SearchQuery::Literal(_)));
+            let regex =
+                search::RegexSearch::new(&search_pattern(pattern, false, case_sensitive))
+                    .unwrap();
+            let regex = search::SearchQuery::Regex(Box::new(regex));
+
+            assert_eq!(match_columns(literal), expected, "literal {pattern}");
+            assert_eq!(match_columns(regex), expected, "regex {pattern}");
+        }
+    }
 }
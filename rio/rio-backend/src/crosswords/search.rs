@@ -7,6 +7,7 @@ use std::error::Error;
 use std::mem;
 use std::ops::RangeInclusive;
 
+use memchr::memmem;
 use regex_automata::hybrid::dfa::{Builder, Cache, Config, DFA};
 pub use regex_automata::hybrid::BuildError;
 use regex_automata::nfa::thompson::Config as ThompsonConfig;
@@ -14,7 +15,12 @@ use regex_automata::util::syntax::Config as SyntaxConfig;
 use regex_automata::{Anchored, Input, MatchKind};
 use tracing::{debug, warn};
 
-use crate::crosswords::grid::{BidirectionalIterator, Dimensions, GridIterator, Indexed};
+use crate::crosswords::grid::row::Row;
+use crate::crosswords::grid::row_text::{self, RowText};
+use crate::crosswords::grid::{
+    BidirectionalIterator, Dimensions, Grid, GridIterator, Indexed,
+};
+use crate::crosswords::pos::Line;
 use crate::crosswords::square::{Flags, Square};
 use crate::crosswords::Crosswords;
 use crate::crosswords::{Boundary, Column, Direction, Pos, Side};
@@ -94,6 +100,122 @@ impl RegexSearch {
     }
 }
 
+/// Plain text query, matched with a substring search instead of DFAs.
+///
+/// Case-insensitive literals only fold ASCII letters. Queries with other
+/// cased letters keep using the regex engine and its Unicode case folding.
+#[derive(Clone, Debug)]
+pub struct LiteralSearch {
+    /// UTF-8 needle, lowercase when `fold_case` is set.
+    needle: Box<[u8]>,
+    fold_case: bool,
+}
+
+impl LiteralSearch {
+    /// Literal search for `query`, `None` when it has to go through
+    /// [`RegexSearch`].
+    pub fn new(query: &str, case_sensitive: bool) -> Option<LiteralSearch> {
+        if query.is_empty() {
+            return None;
+        }
+
+        let fold_case = !case_sensitive;
+        if fold_case
+            && !query.chars().all(|c| {
+                c.is_ascii() || (c.to_lowercase().eq([c]) && c.to_uppercase().eq([c]))
+            })
+        {
+            return None;
+        }
+
+        let mut needle = query.as_bytes().to_vec();
+        if fold_case {
+            needle.make_ascii_lowercase();
+        }
+        Some(LiteralSearch {
+            needle: needle.into_boxed_slice(),
+            fold_case,
+        })
+    }
+}
+
+/// Compiled search query.
+///
+/// Most queries typed into the find bar are plain text, those are searched
+/// as [`LiteralSearch`] and never build the regex DFAs.
+#[derive(Clone, Debug)]
+pub enum SearchQuery {
+    Literal(LiteralSearch),
+    Regex(Box<RegexSearch>),
+}
+
+/// Text of a logical line for [`LiteralSearch`], reused from line to line.
+///
+/// Rows with cached text are copied from it. Other rows, usually the
+/// scrollback, are packed straight from their squares together with a column
+/// map, so a search does not leave cached text on every history row.
+#[derive(Default)]
+struct PackedLine {
+    text: String,
+    /// Byte offset where each row starts, with the row's line and, for rows
+    /// packed from squares, its range of `columns`.
+    rows: Vec<(usize, Line, Option<(usize, usize)>)>,
+    /// Byte offset of every column of the rows packed from squares.
+    columns: Vec<u32>,
+}
+
+impl PackedLine {
+    fn push_text(&mut self, text: &RowText, line: Line, fold_case: bool) {
+        let start = self.text.len();
+        self.rows.push((start, line, None));
+        self.text.push_str(text.as_str());
+        if fold_case {
+            self.text[start..].make_ascii_lowercase();
+        }
+    }
+
+    fn push_squares(&mut self, row: &Row<Square>, line: Line, fold_case: bool) {
+        let start = self.text.len();
+        let map_start = self.columns.len();
+        let columns = &mut self.columns;
+        row_text::pack_row(row, &mut self.text, |_, column_start, _| {
+            columns.push((column_start - start) as u32);
+        });
+        self.rows
+            .push((start, line, Some((map_start, self.columns.len()))));
+        if fold_case {
+            self.text[start..].make_ascii_lowercase();
+        }
+    }
+
+    /// Grid position of byte `offset`, or of byte `offset` of `line` when
+    /// the line was searched in place.
+    fn position(&self, grid: &Grid<Square>, line: Line, offset: usize) -> Pos {
+        let row = self.rows.partition_point(|(start, _, _)| *start <= offset);
+        let (line, offset, map) = match row.checked_sub(1).map(|row| self.rows[row]) {
+            Some((start, line, map)) => (line, offset - start, map),
+            None => (line, offset, None),
+        };
+        let column = match map {
+            Some((map_start, map_end)) => {
+                let columns = &self.columns[map_start..map_end];
+                let column = columns
+                    .partition_point(|&start| start as usize <= offset)
+                    .saturating_sub(1);
+                Column(column.min(columns.len().saturating_sub(1)))
+            }
+            None => grid[line].text().column_at(offset),
+        };
+        Pos::new(line, column)
+    }
+
+    fn clear(&mut self) {
+        self.text.clear();
+        self.rows.clear();
+        self.columns.clear();
+    }
+}
+
 /// Runtime-evaluated DFA.
 #[derive(Clone, Debug)]
 struct LazyDfa {
@@ -672,6 +794,76 @@ impl<T: event::EventListener> Crosswords<T> {
     }
 }
 
+impl<T: event::EventListener> Crosswords<T> {
+    /// Report the matches of a literal from line `start` through `end`, in
+    /// order, until `visit` returns false.
+    ///
+    /// Both bounds have to be on logical line boundaries: `start` not a
+    /// continuation of a wrapped line and `end` not wrapped. Returns false if
+    /// `visit` stopped the search.
+    pub fn literal_search(
+        &self,
+        literal: &LiteralSearch,
+        start: Line,
+        end: Line,
+        mut visit: impl FnMut(Match) -> bool,
+    ) -> bool {
+        let finder = memmem::Finder::new(&literal.needle);
+        let last_column = self.grid.last_column();
+        let mut text = PackedLine::default();
+
+        let mut line = start;
+        while line <= end {
+            let row = &self.grid[line];
+            let wrapped = line != end && row[last_column].flags.contains(Flags::WRAPLINE);
+            // Screen rows are cheap to keep and read by hints and selection,
+            // history rows are only cached if something else asked for them.
+            let cached = match row.cached_text() {
+                Some(cached) => Some(cached),
+                None if line >= Line(0) => Some(row.text()),
+                None => None,
+            };
+
+            // Single cached rows are searched in place, anything else is
+            // copied first.
+            if wrapped || literal.fold_case || !text.rows.is_empty() || cached.is_none() {
+                match cached {
+                    Some(cached) => text.push_text(cached, line, literal.fold_case),
+                    None => text.push_squares(row, line, literal.fold_case),
+                }
+                if wrapped {
+                    line += 1;
+                    continue;
+                }
+            }
+
+            let haystack = match cached {
+                Some(cached) if text.rows.is_empty() => cached.as_bytes(),
+                _ => text.text.as_bytes(),
+            };
+            for index in finder.find_iter(haystack) {
+                let match_start = text.position(&self.grid, line, index);
+                let mut match_end =
+                    text.position(&self.grid, line, index + literal.needle.len() - 1);
+                // Like the regex search, a match ends on the spacer of a
+                // trailing wide char.
+                if match_end.col < last_column
+                    && self.grid[match_end].flags.contains(Flags::WIDE_CHAR)
+                {
+                    match_end.col += 1;
+                }
+                if !visit(match_start..=match_end) {
+                    return false;
+                }
+            }
+            text.clear();
+            line += 1;
+        }
+
+        true
+    }
+}
+
 /// Iterator over regex matches.
 pub struct RegexIter<'a, T: event::EventListener> {
     pos: Pos,
@@ -1491,4 +1683,76 @@ mod tests {
             Some(match_end..=match_start)
         );
     }
+
+    fn literal_matches(
+        term: &Crosswords<VoidListener>,
+        query: &str,
+        case_sensitive: bool,
+    ) -> Vec<Match> {
+        let literal = LiteralSearch::new(query, case_sensitive).unwrap();
+        let end = Line(term.grid.screen_lines() as i32 - 1);
+        let mut matches = Vec::new();
+        term.literal_search(&literal, Line(0), end, |m| {
+            matches.push(m);
+            true
+        });
+        matches
+    }
+
+    fn regex_matches(term: &Crosswords<VoidListener>, regex: &str) -> Vec<Match> {
+        let mut regex = RegexSearch::new(regex).unwrap();
+        let start = Pos::new(Line(0), Column(0));
+        let end = Pos::new(
+            Line(term.grid.screen_lines() as i32 - 1),
+            term.grid.last_column(),
+        );
+        RegexIter::new(start, end, Direction::Right, term, &mut regex).collect()
+    }
+
+    #[test]
+    fn literal_search_matches_regex() {
+        #[rustfmt::skip]
+        let term = mock_term("\
+            Rio terminal rio\r\n\
+            检索rio 测试RIO\n\
+            rio 检索\
+        ");
+
+        let matches = literal_matches(&term, "rio", false);
+        assert_eq!(matches.len(), 5);
+        assert_eq!(matches, regex_matches(&term, "rio"));
+        assert_eq!(
+            matches[2],
+            Pos::new(Line(1), Column(4))..=Pos::new(Line(1), Column(6))
+        );
+
+        assert_eq!(
+            literal_matches(&term, "RIO", true),
+            regex_matches(&term, "RIO")
+        );
+        assert_eq!(literal_matches(&term, "RIO", true).len(), 1);
+
+        // Wide chars map back to their cells, across the wrapped line.
+        let matches = literal_matches(&term, "rio 检索", false);
+        assert_eq!(matches, regex_matches(&term, "rio 检索"));
+        assert_eq!(
+            matches,
+            [Pos::new(Line(2), Column(0))..=Pos::new(Line(2), Column(7))]
+        );
+        let matches = literal_matches(&term, "rio rio", false);
+        assert_eq!(matches, regex_matches(&term, "rio rio"));
+        assert_eq!(
+            matches,
+            [Pos::new(Line(1), Column(12))..=Pos::new(Line(2), Column(2))]
+        );
+    }
+
+    #[test]
+    fn literal_search_fallback() {
+        assert!(LiteralSearch::new("", false).is_none());
+        // Non-ASCII letters need Unicode case folding.
+        assert!(LiteralSearch::new("straße", false).is_none());
+        assert!(LiteralSearch::new("straße", true).is_some());
+        assert!(LiteralSearch::new("检索", false).is_some());
+    }
 }
@@ -4,6 +4,7 @@
 use crate::ansi::graphics::GraphicsCell;
 use crate::config::colors::{AnsiColor, NamedColor};
 use crate::crosswords::grid::GridSquare;
+use crate::crosswords::hyperlink::HyperlinkId;
 use crate::crosswords::Column;
 use crate::crosswords::Row;
 use bitflags::bitflags;
@@ -55,6 +56,11 @@ impl Hyperlink {
         &self.inner.id
     }
 
+    /// Whether the id came from the OSC 8 parameters rather than a counter.
+    pub fn has_explicit_id(&self) -> bool {
+        self.inner.explicit_id
+    }
+
     pub fn uri(&self) -> &str {
         &self.inner.uri
     }
@@ -67,10 +73,14 @@ struct HyperlinkInner {
 
     /// Resource identifier of the hyperlink.
     uri: String,
+
+    /// Whether `id` was given by the application rather than generated.
+    explicit_id: bool,
 }
 
 impl HyperlinkInner {
     pub fn new<T: ToString>(id: Option<T>, uri: T) -> Self {
+        let explicit_id = id.is_some();
         let id = match id {
             Some(id) => id.to_string(),
             None => {
@@ -85,6 +95,7 @@ impl HyperlinkInner {
         Self {
             id,
             uri: uri.to_string(),
+            explicit_id,
         }
     }
 }
@@ -99,8 +110,6 @@ pub struct CellExtra {
     zerowidth: Vec<char>,
     underline_color: Option<crate::config::colors::AnsiColor>,
 
-    hyperlink: Option<Hyperlink>,
-
     graphics: Option<GraphicsCell>,
 }
 
@@ -112,6 +121,8 @@ pub struct Square {
     pub bg: AnsiColor,
     pub extra: Option<Arc<CellExtra>>,
     pub flags: Flags,
+    /// OSC 8 hyperlink, interned in the terminal's hyperlink table.
+    pub hyperlink: Option<HyperlinkId>,
 }
 
 impl Default for Square {
@@ -123,6 +134,7 @@ impl Default for Square {
             fg: AnsiColor::Named(NamedColor::Foreground),
             extra: None,
             flags: Flags::empty(),
+            hyperlink: None,
         }
     }
 }
@@ -184,9 +196,10 @@ impl Square {
     ) {
         // If we reset color and we don't have zerowidth we should drop extra storage.
         if color.is_none()
-            && self.extra.as_ref().is_none_or(|extra| {
-                extra.zerowidth.is_empty() && extra.hyperlink.is_none()
-            })
+            && self
+                .extra
+                .as_ref()
+                .is_none_or(|extra| extra.zerowidth.is_empty())
         {
             self.extra = None;
         } else {
@@ -200,27 +213,6 @@ impl Square {
     pub fn underline_color(&self) -> Option<crate::config::colors::AnsiColor> {
         self.extra.as_ref()?.underline_color
     }
-
-    /// Set hyperlink.
-    pub fn set_hyperlink(&mut self, hyperlink: Option<Hyperlink>) {
-        let should_drop = hyperlink.is_none()
-            && self.extra.as_ref().is_none_or(|extra| {
-                extra.zerowidth.is_empty() && extra.underline_color.is_none()
-            });
-
-        if should_drop {
-            self.extra = None;
-        } else {
-            let extra = self.extra.get_or_insert(Default::default());
-            Arc::make_mut(extra).hyperlink = hyperlink;
-        }
-    }
-
-    /// Hyperlink stored in this cell.
-    #[inline]
-    pub fn hyperlink(&self) -> Option<Hyperlink> {
-        self.extra.as_ref()?.hyperlink.clone()
-    }
 }
 
 impl GridSquare for Square {
@@ -0,0 +1,126 @@
+//! DEC synchronized update (mode 2026) status.
+//!
+//! The parser buffers everything between BSU and ESU, but the renderer runs on
+//! another thread and would otherwise have to take the terminal lock just to find
+//! out that there is nothing worth drawing yet. [`SyncStatus`] is shared through an
+//! `Arc` so the render path can skip pending-sync terminals lock-free, notice that
+//! a synchronized update just finished and keep track of updates that had to be
+//! aborted.
+
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+
+/// How a synchronized update ended.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum SyncEnd {
+    /// ESU received.
+    Completed,
+    /// No ESU before the sync timeout.
+    Timeout,
+    /// The sync buffer limit was reached.
+    Overflow,
+}
+
+/// Snapshot of the synchronized update counters of a terminal.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SyncStats {
+    pub started: u64,
+    pub completed: u64,
+    pub timed_out: u64,
+    pub overflowed: u64,
+}
+
+impl SyncStats {
+    /// Synchronized updates that ended without an ESU.
+    #[inline]
+    pub fn aborted(&self) -> u64 {
+        self.timed_out + self.overflowed
+    }
+}
+
+/// Lock-free synchronized update state of a terminal.
+#[derive(Debug, Default)]
+pub struct SyncStatus {
+    syncing: AtomicBool,
+    started: AtomicU64,
+    completed: AtomicU64,
+    timed_out: AtomicU64,
+    overflowed: AtomicU64,
+}
+
+impl SyncStatus {
+    /// Whether a synchronized update is in progress.
+    #[inline]
+    pub fn is_syncing(&self) -> bool {
+        self.syncing.load(Ordering::Acquire)
+    }
+
+    /// Number of synchronized updates that have ended, however they ended.
+    ///
+    /// Renderers compare this against the value of their last frame to force a
+    /// frame right after an update is flushed.
+    #[inline]
+    pub fn generation(&self) -> u64 {
+        self.completed.load(Ordering::Acquire)
+            + self.timed_out.load(Ordering::Acquire)
+            + self.overflowed.load(Ordering::Acquire)
+    }
+
+    pub fn stats(&self) -> SyncStats {
+        SyncStats {
+            started: self.started.load(Ordering::Relaxed),
+            completed: self.completed.load(Ordering::Relaxed),
+            timed_out: self.timed_out.load(Ordering::Relaxed),
+            overflowed: self.overflowed.load(Ordering::Relaxed),
+        }
+    }
+
+    #[inline]
+    pub(crate) fn set_syncing(&self, syncing: bool) {
+        let was_syncing = self.syncing.swap(syncing, Ordering::AcqRel);
+        if syncing && !was_syncing {
+            self.started.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    #[inline]
+    pub(crate) fn record_end(&self, end: SyncEnd) {
+        let counter = match end {
+            SyncEnd::Completed => &self.completed,
+            SyncEnd::Timeout => &self.timed_out,
+            SyncEnd::Overflow => &self.overflowed,
+        };
+        counter.fetch_add(1, Ordering::AcqRel);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn counts_transitions_and_ends() {
+        let status = SyncStatus::default();
+        assert!(!status.is_syncing());
+
+        status.set_syncing(true);
+        // BSU while syncing only extends the current update
+        status.set_syncing(true);
+        assert!(status.is_syncing());
+        status.set_syncing(false);
+        status.record_end(SyncEnd::Completed);
+
+        status.set_syncing(true);
+        status.set_syncing(false);
+        status.record_end(SyncEnd::Timeout);
+
+        status.set_syncing(true);
+        status.set_syncing(false);
+        status.record_end(SyncEnd::Overflow);
+
+        let stats = status.stats();
+        assert_eq!(stats.started, 3);
+        assert_eq!(stats.completed, 1);
+        assert_eq!(stats.aborted(), 2);
+        assert_eq!(status.generation(), 3);
+    }
+}
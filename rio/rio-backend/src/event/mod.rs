@@ -1,3 +1,4 @@
+pub mod paste;
 pub mod sync;
 
 use crate::ansi::graphics::UpdateQueues;
@@ -53,6 +54,9 @@ pub enum Msg {
     /// Data that should be written to the PTY.
     Input(Cow<'static, [u8]>),
 
+    /// Pasted data, written to the PTY in chunks.
+    Paste(paste::Paste),
+
     #[allow(dead_code)]
     Shutdown,
 
@@ -0,0 +1,274 @@
+//! Streaming paste.
+//!
+//! A paste can be megabytes long. Instead of copying it into a single
+//! [`Msg::Input`](super::Msg::Input) that the PTY thread has to write in one
+//! go, the paste keeps the producer's buffer and is written in chunks, so the
+//! PTY thread can put interactive input in between.
+//!
+//! Bracketed pastes stay well formed: when input has to go first, the paste is
+//! closed with `ESC [ 201 ~`, the input is written, and the rest of the paste is
+//! sent as a new bracketed paste.
+
+use std::fmt;
+
+/// Start of a bracketed paste.
+pub const PASTE_START: &[u8] = b"\x1b[200~";
+/// End of a bracketed paste.
+pub const PASTE_END: &[u8] = b"\x1b[201~";
+
+/// Largest chunk of paste content handed out by [`Paste::chunk`].
+pub const PASTE_CHUNK_SIZE: usize = 16 * 1024;
+
+/// Bytes of a paste, owned by whoever produced them.
+pub type PasteData = Box<dyn AsRef<[u8]> + Send>;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Stage {
+    Start,
+    Body,
+    End,
+    Done,
+}
+
+/// A paste being written to the PTY.
+pub struct Paste {
+    data: PasteData,
+    bracketed: bool,
+    stage: Stage,
+    /// Bytes of the content already written.
+    offset: usize,
+    /// Bytes of the current marker already written.
+    marker_offset: usize,
+    /// Close the paste right after the start marker, input is waiting.
+    yielding: bool,
+}
+
+impl fmt::Debug for Paste {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("Paste")
+            .field("len", &self.len())
+            .field("bracketed", &self.bracketed)
+            .field("stage", &self.stage)
+            .field("offset", &self.offset)
+            .finish()
+    }
+}
+
+impl Paste {
+    pub fn new(data: PasteData, bracketed: bool) -> Paste {
+        let empty = (*data).as_ref().is_empty();
+        let stage = match (bracketed, empty) {
+            (true, _) => Stage::Start,
+            (false, false) => Stage::Body,
+            (false, true) => Stage::Done,
+        };
+        Paste {
+            data,
+            bracketed,
+            stage,
+            offset: 0,
+            marker_offset: 0,
+            yielding: false,
+        }
+    }
+
+    /// Content length, without bracketed paste markers.
+    #[inline]
+    pub fn len(&self) -> usize {
+        (*self.data).as_ref().len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    #[inline]
+    pub fn is_bracketed(&self) -> bool {
+        self.bracketed
+    }
+
+    /// Content bytes not written yet.
+    #[inline]
+    pub fn remaining(&self) -> usize {
+        self.len() - self.offset
+    }
+
+    #[inline]
+    pub fn is_finished(&self) -> bool {
+        self.stage == Stage::Done
+    }
+
+    /// Whether other input can be written now without ending up inside the
+    /// bracketed paste.
+    #[inline]
+    pub fn at_boundary(&self) -> bool {
+        match self.stage {
+            Stage::Start => self.marker_offset == 0,
+            Stage::Body => !self.bracketed,
+            Stage::End => false,
+            Stage::Done => true,
+        }
+    }
+
+    /// Let other input go first: a bracketed paste in progress is closed and
+    /// reopened after it. Call [`Paste::chunk`] until [`Paste::at_boundary`]
+    /// before writing the input.
+    pub fn yield_to_input(&mut self) {
+        if !self.bracketed {
+            return;
+        }
+        match self.stage {
+            Stage::Start if self.marker_offset > 0 => self.yielding = true,
+            Stage::Body => self.stage = Stage::End,
+            _ => {}
+        }
+    }
+
+    /// Next bytes to write, empty once the paste is finished.
+    #[inline]
+    pub fn chunk(&self) -> &[u8] {
+        match self.stage {
+            Stage::Start => &PASTE_START[self.marker_offset..],
+            Stage::Body => {
+                let data = (*self.data).as_ref();
+                let end = data.len().min(self.offset + PASTE_CHUNK_SIZE);
+                &data[self.offset..end]
+            }
+            Stage::End => &PASTE_END[self.marker_offset..],
+            Stage::Done => &[],
+        }
+    }
+
+    /// Mark `n` bytes of the last [`Paste::chunk`] as written.
+    pub fn advance(&mut self, n: usize) {
+        match self.stage {
+            Stage::Start => {
+                self.marker_offset += n;
+                if self.marker_offset == PASTE_START.len() {
+                    self.marker_offset = 0;
+                    self.stage = if self.remaining() > 0 && !self.yielding {
+                        Stage::Body
+                    } else {
+                        Stage::End
+                    };
+                    self.yielding = false;
+                }
+            }
+            Stage::Body => {
+                self.offset += n;
+                if self.remaining() == 0 {
+                    self.stage = if self.bracketed {
+                        Stage::End
+                    } else {
+                        Stage::Done
+                    };
+                }
+            }
+            Stage::End => {
+                self.marker_offset += n;
+                if self.marker_offset == PASTE_END.len() {
+                    self.marker_offset = 0;
+                    self.stage = if self.remaining() > 0 {
+                        Stage::Start
+                    } else {
+                        Stage::Done
+                    };
+                }
+            }
+            Stage::Done => {}
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn drain(paste: &mut Paste, max: usize) -> Vec<u8> {
+        let mut out = Vec::new();
+        while !paste.is_finished() {
+            let chunk = paste.chunk();
+            let n = chunk.len().min(max);
+            out.extend_from_slice(&chunk[..n]);
+            paste.advance(n);
+        }
+        out
+    }
+
+    #[test]
+    fn plain_paste_is_written_as_is() {
+        let data = vec![b'a'; PASTE_CHUNK_SIZE * 2 + 7];
+        let mut paste = Paste::new(Box::new(data.clone()), false);
+        assert_eq!(paste.chunk().len(), PASTE_CHUNK_SIZE);
+        assert_eq!(drain(&mut paste, usize::MAX), data);
+
+        assert!(Paste::new(Box::new(Vec::new()), false).is_finished());
+    }
+
+    #[test]
+    fn bracketed_paste_survives_partial_writes() {
+        let mut paste = Paste::new(Box::new(b"hello".to_vec()), true);
+        assert_eq!(drain(&mut paste, 1), b"\x1b[200~hello\x1b[201~");
+
+        let mut empty = Paste::new(Box::new(Vec::new()), true);
+        assert_eq!(drain(&mut empty, 3), b"\x1b[200~\x1b[201~");
+    }
+
+    #[test]
+    fn input_splits_bracketed_paste() {
+        let mut paste = Paste::new(Box::new(b"abcdef".to_vec()), true);
+        let mut out = Vec::new();
+
+        // Nothing written yet, input can go first without closing anything.
+        assert!(paste.at_boundary());
+        paste.advance(PASTE_START.len());
+        out.extend_from_slice(PASTE_START);
+        assert!(!paste.at_boundary());
+
+        paste.advance(3);
+        out.extend_from_slice(b"abc");
+        paste.yield_to_input();
+        while !paste.at_boundary() {
+            out.extend_from_slice(paste.chunk());
+            let n = paste.chunk().len();
+            paste.advance(n);
+        }
+        out.extend_from_slice(b"\r");
+        out.extend_from_slice(&drain(&mut paste, usize::MAX));
+
+        assert_eq!(out, b"\x1b[200~abc\x1b[201~\r\x1b[200~def\x1b[201~");
+    }
+
+    #[test]
+    fn input_right_after_start_goes_before_body() {
+        // Same order as the PTY thread: finish up to a boundary, then input.
+        fn write_input(paste: &mut Paste, out: &mut Vec<u8>) {
+            paste.yield_to_input();
+            while !paste.at_boundary() {
+                out.extend_from_slice(paste.chunk());
+                let n = paste.chunk().len();
+                paste.advance(n);
+            }
+            out.extend_from_slice(b"\r");
+        }
+
+        // Start marker fully written, no content yet.
+        let mut paste = Paste::new(Box::new(b"abc".to_vec()), true);
+        let mut out = PASTE_START.to_vec();
+        paste.advance(PASTE_START.len());
+        write_input(&mut paste, &mut out);
+        assert_eq!(paste.remaining(), 3);
+        out.extend_from_slice(&drain(&mut paste, usize::MAX));
+        assert_eq!(out, b"\x1b[200~\x1b[201~\r\x1b[200~abc\x1b[201~");
+
+        // Start marker cut short by a partial write.
+        let mut paste = Paste::new(Box::new(b"abc".to_vec()), true);
+        let mut out = PASTE_START[..2].to_vec();
+        paste.advance(2);
+        write_input(&mut paste, &mut out);
+        assert_eq!(paste.remaining(), 3);
+        out.extend_from_slice(&drain(&mut paste, usize::MAX));
+        assert_eq!(out, b"\x1b[200~\x1b[201~\r\x1b[200~abc\x1b[201~");
+    }
+}
@@ -5,6 +5,7 @@ use crate::batched_parser::BatchedParser;
 use crate::config::colors::{AnsiColor, ColorRgb, NamedColor};
 use crate::crosswords::pos::{CharsetIndex, Column, Line, StandardCharset};
 use crate::crosswords::square::Hyperlink;
+use crate::crosswords::sync::SyncEnd;
 use crate::simd_utf8;
 use cursor_icon::CursorIcon;
 use std::mem;
@@ -190,12 +191,25 @@ pub trait Handler {
     /// Called when BSU (\e[?2026h) or ESU (\e[?2026l) is received.
     fn set_syncing(&mut self, _syncing: bool) {}
 
+    /// A synchronized update was flushed, either by ESU or because it was aborted.
+    fn sync_ended(&mut self, _end: SyncEnd) {}
+
     /// Set the cursor shape.
     fn set_cursor_shape(&mut self, _shape: CursorShape) {}
 
     /// A character to be displayed.
     fn input(&mut self, _c: char) {}
 
+    /// A run of printable characters to be displayed.
+    ///
+    /// Defaults to calling [`Handler::input`] for every character.
+    #[inline]
+    fn input_str(&mut self, text: &str) {
+        for c in text.chars() {
+            self.input(c);
+        }
+    }
+
     /// Set cursor to position.
     fn goto(&mut self, _: Line, _: Column) {}
 
@@ -575,7 +589,7 @@ impl<T: Timeout> Processor<T> {
     where
         H: Handler,
     {
-        self.stop_sync_internal(handler, None);
+        self.stop_sync_internal(handler, None, SyncEnd::Timeout);
     }
 
     /// End a synchronized update.
@@ -583,13 +597,14 @@ impl<T: Timeout> Processor<T> {
     /// The `bsu_offset` parameter should be passed if the sync buffer contains
     /// a new BSU escape that is not part of the current synchronized
     /// update.
-    fn stop_sync_internal<H>(&mut self, handler: &mut H, bsu_offset: Option<usize>)
-    where
+    fn stop_sync_internal<H>(
+        &mut self,
+        handler: &mut H,
+        bsu_offset: Option<usize>,
+        end: SyncEnd,
+    ) where
         H: Handler,
     {
-        // 确保退出 sync 状态（处理超时、缓冲区溢出等情况）
-        handler.set_syncing(false);
-
         // Process all synchronized bytes.
         //
         // NOTE: We do not use `advance_until_terminated` here since BSU sequences are
@@ -601,6 +616,7 @@ impl<T: Timeout> Processor<T> {
         // Flush any pending batched input from synchronized processing
         self.parser.flush(&mut performer);
         self.state.sync_state.buffer = buffer;
+        handler.sync_ended(end);
 
         match bsu_offset {
             // Just clear processed bytes if there is a new BSU.
@@ -611,12 +627,17 @@ impl<T: Timeout> Processor<T> {
                 let new_len = self.state.sync_state.buffer.len() - bsu_offset;
                 self.state.sync_state.buffer.copy_within(bsu_offset.., 0);
                 self.state.sync_state.buffer.truncate(new_len);
+                // The new BSU starts another synchronized update.
+                handler.set_syncing(true);
             }
             // Report mode and clear state if no new BSU is present.
             None => {
                 handler.unset_private_mode(NamedPrivateMode::SyncUpdate.into());
                 self.state.sync_state.timeout.clear_timeout();
                 self.state.sync_state.buffer.clear();
+                // 确保退出 sync 状态（处理超时、缓冲区溢出等情况）
+                // 放在缓冲处理之后：缓冲区开头可能是新的 BSU，重放时会再次进入 sync
+                handler.set_syncing(false);
             }
         }
     }
@@ -638,7 +659,7 @@ impl<T: Timeout> Processor<T> {
         // Advance sync parser or stop sync if we'd exceed the maximum buffer size.
         if self.state.sync_state.buffer.len() + bytes.len() >= SYNC_BUFFER_SIZE - 1 {
             // Terminate the synchronized update.
-            self.stop_sync_internal(handler, None);
+            self.stop_sync_internal(handler, None, SyncEnd::Overflow);
 
             // Just parse the bytes normally.
             let mut performer = Performer::new(&mut self.state, handler);
@@ -682,7 +703,7 @@ impl<T: Timeout> Processor<T> {
             } else if escape == ESU_CSI {
                 // 通知 handler 退出 sync 状态
                 handler.set_syncing(false);
-                self.stop_sync_internal(handler, bsu_offset);
+                self.stop_sync_internal(handler, bsu_offset, SyncEnd::Completed);
                 break;
             }
         }
@@ -706,11 +727,26 @@ impl<'a, H: Handler + 'a, T: Timeout> Performer<'a, H, T> {
 }
 
 impl<U: Handler, T: Timeout> copa::Perform for Performer<'_, U, T> {
+    /// Stop parsing once a synchronized update begins, so the rest of the input
+    /// lands in the sync buffer instead of being applied immediately.
+    #[inline]
+    fn terminated(&self) -> bool {
+        self.state.sync_state.timeout.pending_timeout()
+    }
+
     fn print(&mut self, c: char) {
         self.handler.input(c);
         self.state.preceding_char = Some(c);
     }
 
+    #[inline]
+    fn print_str(&mut self, text: &str) {
+        self.handler.input_str(text);
+        if let Some(c) = text.chars().next_back() {
+            self.state.preceding_char = Some(c);
+        }
+    }
+
     fn execute(&mut self, byte: u8) {
         tracing::trace!("[execute] {byte:04x}");
 
@@ -1856,6 +1892,61 @@ fn get_termcap_capability(name: &str) -> Option<String> {
 mod tests {
     use super::*;
 
+    #[derive(Default)]
+    struct SyncRecorder {
+        syncing: bool,
+        ends: Vec<SyncEnd>,
+        printed: String,
+    }
+
+    impl Handler for SyncRecorder {
+        fn set_syncing(&mut self, syncing: bool) {
+            self.syncing = syncing;
+        }
+
+        fn sync_ended(&mut self, end: SyncEnd) {
+            self.ends.push(end);
+        }
+
+        fn input(&mut self, c: char) {
+            self.printed.push(c);
+        }
+    }
+
+    #[test]
+    fn test_sync_update_end_reasons() {
+        // ESU flushes the buffered update
+        let mut processor: Processor = Processor::new();
+        let mut handler = SyncRecorder::default();
+        processor.advance(&mut handler, b"\x1b[?2026hab");
+        assert!(handler.syncing);
+        assert!(handler.printed.is_empty());
+        processor.advance(&mut handler, b"c\x1b[?2026l");
+        assert!(!handler.syncing);
+        assert_eq!(handler.ends, [SyncEnd::Completed]);
+        assert_eq!(handler.printed, "abc");
+
+        // ESU immediately followed by a new BSU keeps the terminal syncing
+        processor.advance(&mut handler, b"\x1b[?2026hd");
+        processor.advance(&mut handler, b"e\x1b[?2026l\x1b[?2026hf");
+        assert!(handler.syncing);
+        assert_eq!(handler.printed, "abcde");
+        assert_eq!(handler.ends, [SyncEnd::Completed, SyncEnd::Completed]);
+
+        // Timeout
+        processor.stop_sync(&mut handler);
+        assert!(!handler.syncing);
+        assert_eq!(handler.printed, "abcdef");
+        assert_eq!(handler.ends.last(), Some(&SyncEnd::Timeout));
+
+        // Buffer limit
+        processor.advance(&mut handler, b"\x1b[?2026h");
+        processor.advance(&mut handler, &vec![b'x'; SYNC_BUFFER_SIZE]);
+        assert!(!handler.syncing);
+        assert_eq!(handler.ends.last(), Some(&SyncEnd::Overflow));
+        assert_eq!(handler.printed.len(), 6 + SYNC_BUFFER_SIZE);
+    }
+
     #[test]
     fn test_hex_encoding() {
         assert_eq!(encode_hex_string("TN"), "544E");
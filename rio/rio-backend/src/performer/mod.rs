@@ -239,6 +239,13 @@ where
         while let Some(msg) = self.receiver.recv() {
             match msg {
                 Msg::Input(input) => state.write_list.push_back(input),
+                Msg::Paste(mut paste) => {
+                    while !paste.is_finished() {
+                        let chunk = paste.chunk().to_vec();
+                        paste.advance(chunk.len());
+                        state.write_list.push_back(Cow::Owned(chunk));
+                    }
+                }
                 Msg::Resize(window_size) => {
                     let _ = self.pty.set_winsize(window_size);
                 }
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Record a program's PTY output into a .ptyrec capture.
+
+The format matches src/infra/pty_recording.rs:
+
+    b"PTYREC01" | cols: u16 | rows: u16 | { delay_us: u32 | len: u32 | bytes }*
+
+All integers are little-endian. `delay_us` is the time since the previous chunk.
+
+Usage:
+    record.py OUT.ptyrec [--cols 120] [--rows 40] [--keys KEYS] -- CMD [ARGS...]
+
+KEYS is a list of `delay_ms:text` items separated by `|`, sent to the program after
+the given delay, with Python escapes such as `\\r` or `\\x1b` unescaped.
+"""
+
+import argparse
+import fcntl
+import os
+import pty
+import select
+import struct
+import sys
+import termios
+import time
+
+MAGIC = b"PTYREC01"
+
+
+def parse_keys(spec):
+    keys = []
+    for item in filter(None, spec.split("|")):
+        delay, text = item.split(":", 1)
+        keys.append((int(delay) / 1000.0, text.encode().decode("unicode_escape").encode()))
+    return keys
+
+
+def record(out, cols, rows, keys, argv):
+    pid, fd = pty.fork()
+    if pid == 0:
+        os.environ["TERM"] = "xterm-256color"
+        os.environ["COLUMNS"] = str(cols)
+        os.environ["LINES"] = str(rows)
+        os.execvp(argv[0], argv)
+
+    fcntl.ioctl(fd, termios.TIOCSWINSZ, struct.pack("HHHH", rows, cols, 0, 0))
+
+    start = last = time.monotonic()
+    next_key = start + keys[0][0] if keys else None
+    with open(out, "wb") as f:
+        f.write(MAGIC + struct.pack("<HH", cols, rows))
+        while True:
+            timeout = None if next_key is None else max(0.0, next_key - time.monotonic())
+            ready, _, _ = select.select([fd], [], [], timeout)
+            if not ready:
+                os.write(fd, keys.pop(0)[1])
+                next_key = time.monotonic() + keys[0][0] if keys else None
+                continue
+            try:
+                data = os.read(fd, 65536)
+            except OSError:
+                break
+            if not data:
+                break
+            now = time.monotonic()
+            delay_us = int((now - last) * 1_000_000)
+            last = now
+            f.write(struct.pack("<II", delay_us, len(data)) + data)
+    os.waitpid(pid, 0)
+
+
+def main():
+    argv = sys.argv[1:]
+    if "--" not in argv:
+        sys.exit(__doc__)
+    split = argv.index("--")
+    parser = argparse.ArgumentParser()
+    parser.add_argument("out")
+    parser.add_argument("--cols", type=int, default=120)
+    parser.add_argument("--rows", type=int, default=40)
+    parser.add_argument("--keys", default="")
+    args = parser.parse_args(argv[:split])
+    record(args.out, args.cols, args.rows, parse_keys(args.keys), argv[split + 1 :])
+
+
+if __name__ == "__main__":
+    main()
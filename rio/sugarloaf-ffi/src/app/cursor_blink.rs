@@ -0,0 +1,270 @@
+//! Cursor Blink - 光标闪烁叠加层
+//!
+//! 光标画在行图像里，如果每次闪烁都走 render_all，每个可见终端都要重新
+//! 加锁、取快照、渲染行，空闲时 CPU 也停不下来。这里把闪烁拆成独立的一层：
+//! - 渲染闪烁中的终端时，额外生成一块"光标隐藏"时的像素补丁（只有光标附近几格）
+//! - 熄灭阶段 end_frame 把补丁盖在缓存的终端图像上，点亮阶段不盖
+//! - 闪烁计时由 DisplayLink 空闲回调推进，切换时只重新合成缓存的图像
+//!
+//! 只有一个终端（通常是焦点终端）闪烁，补丁的额外开销只落在这一个终端上，
+//! 而且只在它的光标本身设置为闪烁（DECSCUSR / DECSET 12）时才闪。
+
+use crate::domain::TerminalState;
+use crate::render::Renderer;
+use rio_backend::ansi::CursorShape;
+use skia_safe::{surfaces, Color};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+
+/// 未启用闪烁
+const NO_TERMINAL: usize = usize::MAX;
+
+/// 光标熄灭时覆盖在光标上的像素补丁
+pub struct CursorPatch {
+    /// 光标隐藏时这块区域的像素
+    pub image: skia_safe::Image,
+    /// 补丁在终端图像内的位置（物理像素，取整）
+    pub x: f32,
+    pub y: f32,
+}
+
+/// 光标闪烁时钟（无锁，主线程和 DisplayLink 线程共享）
+#[derive(Debug)]
+pub struct CursorBlink {
+    /// 闪烁的终端 ID（NO_TERMINAL = 关闭）
+    terminal_id: AtomicUsize,
+    /// 闪烁间隔（微秒）
+    interval_us: AtomicU64,
+    /// 闪烁终端的光标自身是否设置为闪烁（渲染该终端时更新）
+    blinking: AtomicBool,
+    /// 光标当前是否点亮
+    visible: AtomicBool,
+    /// 上次切换或重置的时间（相对 epoch 的微秒）
+    last_toggle_us: AtomicU64,
+    epoch: Instant,
+}
+
+impl Default for CursorBlink {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl CursorBlink {
+    pub fn new() -> Self {
+        Self {
+            terminal_id: AtomicUsize::new(NO_TERMINAL),
+            interval_us: AtomicU64::new(0),
+            blinking: AtomicBool::new(false),
+            visible: AtomicBool::new(true),
+            last_toggle_us: AtomicU64::new(0),
+            epoch: Instant::now(),
+        }
+    }
+
+    /// 设置闪烁的终端和间隔，`None` 或零间隔关闭闪烁
+    pub fn configure(
+        &self,
+        terminal_id: Option<usize>,
+        interval: Duration,
+        now: Instant,
+    ) {
+        let terminal_id = match terminal_id {
+            Some(id) if !interval.is_zero() => id,
+            _ => NO_TERMINAL,
+        };
+        self.interval_us
+            .store(interval.as_micros() as u64, Ordering::Relaxed);
+        // 新终端的光标是否闪烁要等渲染它时才知道
+        self.blinking.store(false, Ordering::Release);
+        self.terminal_id.store(terminal_id, Ordering::Release);
+        self.reset(now);
+    }
+
+    /// 更新闪烁终端的光标是否设置为闪烁
+    ///
+    /// 返回是否有变化，变为闪烁时需要重新渲染一次来生成光标补丁
+    pub fn set_blinking(&self, blinking: bool) -> bool {
+        let changed = self.blinking.swap(blinking, Ordering::AcqRel) != blinking;
+        if changed && !blinking {
+            self.visible.store(true, Ordering::Release);
+        }
+        changed
+    }
+
+    /// 是否在闪烁：有闪烁终端，且它的光标设置为闪烁
+    #[inline]
+    pub fn is_blinking(&self) -> bool {
+        self.terminal_id().is_some() && self.blinking.load(Ordering::Acquire)
+    }
+
+    /// 闪烁中的终端
+    #[inline]
+    pub fn terminal_id(&self) -> Option<usize> {
+        match self.terminal_id.load(Ordering::Acquire) {
+            NO_TERMINAL => None,
+            id => Some(id),
+        }
+    }
+
+    /// 光标是否处于熄灭阶段
+    #[inline]
+    pub fn is_cursor_hidden(&self) -> bool {
+        self.is_blinking() && !self.visible.load(Ordering::Acquire)
+    }
+
+    /// 点亮光标并重新计时（用户输入时调用，打字时光标常亮）
+    ///
+    /// 返回光标之前是否处于熄灭阶段
+    pub fn reset(&self, now: Instant) -> bool {
+        self.last_toggle_us
+            .store(self.micros(now), Ordering::Release);
+        !self.visible.swap(true, Ordering::AcqRel)
+    }
+
+    /// 推进时钟，到达间隔时切换亮灭
+    ///
+    /// 返回 true 表示切换了，需要重新合成一帧
+    pub fn tick(&self, now: Instant) -> bool {
+        if !self.is_blinking() {
+            return false;
+        }
+
+        let now_us = self.micros(now);
+        let last = self.last_toggle_us.load(Ordering::Acquire);
+        if now_us.saturating_sub(last) < self.interval_us.load(Ordering::Relaxed) {
+            return false;
+        }
+        // reset 在两次读取之间重新计时的话，这次不切换
+        if self
+            .last_toggle_us
+            .compare_exchange(last, now_us, Ordering::AcqRel, Ordering::Acquire)
+            .is_err()
+        {
+            return false;
+        }
+        self.visible.fetch_xor(true, Ordering::AcqRel);
+        true
+    }
+
+    #[inline]
+    fn micros(&self, now: Instant) -> u64 {
+        now.saturating_duration_since(self.epoch).as_micros() as u64
+    }
+}
+
+/// 渲染光标补丁：光标隐藏时，光标所在格及左右各一格的像素
+///
+/// 块光标在宽字符上会多占一格，所以补丁左右各多留一格。相邻行的图像
+/// 按终端 Surface 相同的位置和顺序绘制，行边界上的像素与缓存图像一致。
+///
+/// # 参数
+/// - `rows`: 终端 Surface 上的行数
+/// - `cell_width`, `line_height`: 物理像素
+pub fn render_cursor_patch(
+    renderer: &mut Renderer,
+    state: &TerminalState,
+    rows: usize,
+    cell_width: f32,
+    line_height: f32,
+) -> Option<CursorPatch> {
+    if !state.cursor.is_visible() {
+        return None;
+    }
+    let screen_row = state
+        .cursor
+        .line()
+        .checked_sub(state.grid.history_size())?
+        .checked_add(state.grid.display_offset())?;
+    if screen_row >= rows {
+        return None;
+    }
+
+    let col = state.cursor.col();
+    let start_col = col.saturating_sub(1);
+    let end_col = (col + 2).min(state.grid.columns());
+    let x0 = (start_col as f32 * cell_width).floor();
+    let x1 = (end_col as f32 * cell_width).ceil();
+    let y0 = (screen_row as f32 * line_height).floor();
+    let y1 = ((screen_row + 1) as f32 * line_height).ceil();
+
+    let mut surface = surfaces::raster_n32_premul(((x1 - x0) as i32, (y1 - y0) as i32))?;
+    let canvas = surface.canvas();
+    canvas.clear(Color::TRANSPARENT);
+
+    let mut hidden = state.clone();
+    hidden.cursor.shape = CursorShape::Hidden;
+    for line in screen_row.saturating_sub(1)..(screen_row + 2).min(rows) {
+        // 非光标行命中 LineCache，光标行的隐藏版本也会被缓存
+        let image = renderer.render_line(line, &hidden, None);
+        canvas.draw_image(&image, (-x0, line as f32 * line_height - y0), None);
+    }
+
+    Some(CursorPatch {
+        image: surface.image_snapshot(),
+        x: x0,
+        y: y0,
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_blink_toggles_on_interval() {
+        let blink = CursorBlink::new();
+        let start = Instant::now();
+
+        // 未启用时不切换
+        assert!(!blink.tick(start + Duration::from_secs(10)));
+        assert!(!blink.is_cursor_hidden());
+
+        blink.configure(Some(3), Duration::from_millis(500), start);
+        assert_eq!(blink.terminal_id(), Some(3));
+
+        // 终端的光标没有设置为闪烁时不切换
+        assert!(!blink.tick(start + Duration::from_millis(500)));
+        assert!(!blink.is_blinking());
+        assert!(blink.set_blinking(true));
+        assert!(!blink.set_blinking(true));
+
+        assert!(!blink.tick(start + Duration::from_millis(499)));
+        assert!(blink.tick(start + Duration::from_millis(500)));
+        assert!(blink.is_cursor_hidden());
+        assert!(!blink.tick(start + Duration::from_millis(700)));
+        assert!(blink.tick(start + Duration::from_millis(1000)));
+        assert!(!blink.is_cursor_hidden());
+
+        // 终端关掉光标闪烁（DECSCUSR 稳定形状 / DECRST 12）：熄灭中也立即点亮
+        assert!(blink.tick(start + Duration::from_millis(1500)));
+        assert!(blink.is_cursor_hidden());
+        assert!(blink.set_blinking(false));
+        assert!(!blink.is_cursor_hidden());
+        assert!(!blink.tick(start + Duration::from_millis(2500)));
+        blink.set_blinking(true);
+
+        // 零间隔关闭闪烁
+        blink.configure(Some(3), Duration::ZERO, start);
+        assert_eq!(blink.terminal_id(), None);
+        assert!(!blink.tick(start + Duration::from_secs(10)));
+    }
+
+    #[test]
+    fn test_reset_keeps_cursor_visible_while_typing() {
+        let blink = CursorBlink::new();
+        let start = Instant::now();
+        blink.configure(Some(1), Duration::from_millis(500), start);
+        blink.set_blinking(true);
+
+        assert!(blink.tick(start + Duration::from_millis(500)));
+        assert!(blink.is_cursor_hidden());
+
+        // 输入时立即点亮，并从输入时刻重新计时
+        assert!(blink.reset(start + Duration::from_millis(600)));
+        assert!(!blink.is_cursor_hidden());
+        assert!(!blink.tick(start + Duration::from_millis(1000)));
+        assert!(blink.tick(start + Duration::from_millis(1100)));
+        assert!(blink.is_cursor_hidden());
+    }
+}
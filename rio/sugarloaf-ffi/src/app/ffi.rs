@@ -4,6 +4,8 @@
 
 use std::ffi::c_void;
 
+use super::workspace_search::{WorkspaceSearchHit, WorkspaceSearchStatus};
+
 // 重新导出根模块的常量，方便使用
 pub use crate::DEFAULT_LINE_HEIGHT;
 
@@ -104,3 +106,101 @@ pub type TerminalPoolStringEventCallback = extern "C" fn(
     terminal_id: usize,
     data: *const std::os::raw::c_char,
 );
+
+/// 粘贴缓冲区释放回调
+///
+/// PTY 线程写完或丢弃粘贴内容后调用，可能在任意线程上调用
+pub type PasteReleaseCallback = extern "C" fn(context: *mut c_void);
+
+/// 宿主提供的粘贴缓冲区（零拷贝）
+///
+/// 持有宿主内存直到 PTY 线程写完，Drop 时通过回调通知宿主释放
+pub struct HostPasteBuffer {
+    data: *const u8,
+    len: usize,
+    release: PasteReleaseCallback,
+    context: *mut c_void,
+}
+
+// 宿主保证在 release 回调之前内存有效且不被修改
+unsafe impl Send for HostPasteBuffer {}
+
+impl HostPasteBuffer {
+    /// # Safety
+    /// `data..data + len` 在 `release(context)` 被调用前必须保持有效且不被修改
+    pub unsafe fn new(
+        data: *const u8,
+        len: usize,
+        release: PasteReleaseCallback,
+        context: *mut c_void,
+    ) -> Self {
+        Self {
+            data,
+            len,
+            release,
+            context,
+        }
+    }
+}
+
+impl AsRef<[u8]> for HostPasteBuffer {
+    fn as_ref(&self) -> &[u8] {
+        if self.len == 0 {
+            return &[];
+        }
+        unsafe { std::slice::from_raw_parts(self.data, self.len) }
+    }
+}
+
+impl Drop for HostPasteBuffer {
+    fn drop(&mut self) {
+        (self.release)(self.context);
+    }
+}
+
+/// 跨终端搜索回调
+///
+/// 命中分批到达（`status` 为 Running），最后一次调用 `count` 为 0、`status` 为结束状态。
+/// 在 rayon 工作线程上调用，`hits` 只在回调期间有效；
+/// `search_id` 用于丢弃已被新搜索取代的结果
+pub type WorkspaceSearchCallback = extern "C" fn(
+    context: *mut c_void,
+    search_id: u64,
+    hits: *const WorkspaceSearchHit,
+    count: usize,
+    status: WorkspaceSearchStatus,
+);
+
+/// 宿主提供的跨终端搜索回调
+pub struct WorkspaceSearchSink {
+    callback: WorkspaceSearchCallback,
+    context: *mut c_void,
+}
+
+// 宿主保证回调可以在任意线程上调用，且 context 在结束回调之前有效
+unsafe impl Send for WorkspaceSearchSink {}
+unsafe impl Sync for WorkspaceSearchSink {}
+
+impl WorkspaceSearchSink {
+    /// # Safety
+    /// `callback` 必须可以在任意线程上调用，`context` 在收到结束状态之前必须有效
+    pub unsafe fn new(callback: WorkspaceSearchCallback, context: *mut c_void) -> Self {
+        Self { callback, context }
+    }
+
+    /// 交付一批命中
+    pub fn hits(&self, search_id: u64, hits: &[WorkspaceSearchHit]) {
+        (self.callback)(
+            self.context,
+            search_id,
+            hits.as_ptr(),
+            hits.len(),
+            WorkspaceSearchStatus::Running,
+        );
+    }
+
+    /// 通知搜索结束
+    pub fn finish(&self, search_id: u64, status: WorkspaceSearchStatus) {
+        (self.callback)(self.context, search_id, std::ptr::null(), 0, status);
+    }
+}
@@ -5,15 +5,20 @@
 //! 架构：
 //! - **terminal_pool** - 多终端池
 //! - **render_scheduler** - 渲染调度器（协调 DisplayLink + TerminalPool）
+//! - **workspace_search** - 跨终端搜索
+//! - **cursor_blink** - 光标闪烁叠加层
 //! - **ffi** - FFI 类型定义
 
 pub mod terminal_pool;
 pub mod render_scheduler;
 pub mod ffi;
 pub mod daemon_client;
+pub mod workspace_search;
+pub mod cursor_blink;
 
 pub use terminal_pool::{TerminalPool, DetachedTerminal};
 pub use render_scheduler::RenderScheduler;
+pub use workspace_search::{WorkspaceSearch, WorkspaceSearchHit, WorkspaceSearchStatus};
 pub use ffi::{
     AppConfig, ErrorCode, FontMetrics, GridPoint, TerminalEvent, TerminalEventType,
     TerminalPoolEventCallback,
@@ -3,6 +3,7 @@
 //! 职责：
 //! - 持有 DisplayLink（VSync 驱动）
 //! - 在 VSync 时检查 needs_render，如果需要则调用渲染回调
+//! - 不需要渲染时调用空闲回调（光标闪烁只重新合成，不渲染终端）
 //!
 //! 架构变更：
 //! - 旧：DisplayLink → callback → Swift render() → FFI × N
@@ -28,6 +29,9 @@ pub struct RenderScheduler {
 
     /// 渲染回调（调用 pool.render_all()）
     render_callback: Arc<Mutex<Option<RenderAllCallback>>>,
+
+    /// 空闲回调（没有渲染请求的 VSync 上调用，调用 pool.tick_cursor_blink()）
+    idle_callback: Arc<Mutex<Option<RenderAllCallback>>>,
 }
 
 impl Default for RenderScheduler {
@@ -43,6 +47,7 @@ impl RenderScheduler {
             display_link: None,
             needs_render: Arc::new(AtomicBool::new(false)),
             render_callback: Arc::new(Mutex::new(None)),
+            idle_callback: Arc::new(Mutex::new(None)),
         }
     }
 
@@ -57,6 +62,17 @@ impl RenderScheduler {
         *cb = Some(Box::new(callback));
     }
 
+    /// 设置空闲回调
+    ///
+    /// 回调在每个没有渲染请求的 VSync 上执行，必须足够轻量
+    pub fn set_idle_callback<F>(&self, callback: F)
+    where
+        F: Fn() + Send + Sync + 'static,
+    {
+        let mut cb = self.idle_callback.lock();
+        *cb = Some(Box::new(callback));
+    }
+
     /// 启动 DisplayLink
     pub fn start(&mut self) -> bool {
         if self.display_link.is_some() {
@@ -65,10 +81,14 @@ impl RenderScheduler {
 
         let needs_render = self.needs_render.clone();
         let render_callback = self.render_callback.clone();
+        let idle_callback = self.idle_callback.clone();
 
         let display_link = DisplayLink::new(move || {
             // 检查是否需要渲染（最小化空闲开销）
             if !needs_render.swap(false, Ordering::AcqRel) {
+                if let Some(ref callback) = *idle_callback.lock() {
+                    callback();
+                }
                 return;
             }
 
@@ -49,13 +49,15 @@
 //! 3. 尽量缩短锁持有时间（clone 后立即释放）
 //! 4. 优先使用 `try_lock()` 避免阻塞主线程
 
-use crate::domain::aggregates::{Terminal, TerminalId};
+use crate::domain::aggregates::{Terminal, TerminalId, TerminalMemoryUsage};
 use crate::render::font::FontContext;
 use crate::render::{RenderConfig, Renderer};
 use crate::rio_event::EventQueue;
 use crate::rio_machine::Machine;
 use corcovado::channel;
 use parking_lot::{Mutex, RwLock};
+use rio_backend::crosswords::sync::{SyncStats, SyncStatus};
+use rio_backend::event::paste::{Paste, PasteData};
 use std::collections::HashMap;
 use std::ffi::c_void;
 use std::sync::Arc;
@@ -68,9 +70,12 @@ use sugarloaf::{
     SugarloafWindowSize, layout::RootStyle,
 };
 
+use super::cursor_blink::{CursorBlink, CursorPatch};
 use super::ffi::{
     AppConfig, ErrorCode, TerminalEvent, TerminalEventType, TerminalPoolEventCallback,
+    WorkspaceSearchSink,
 };
+use super::workspace_search::WorkspaceSearch;
 
 // ============================================================================
 // 全局终端事件路由（修复跨 Pool 迁移后事件丢失问题）
@@ -160,6 +165,15 @@ pub fn route_wakeup_event(terminal_id: usize) -> bool {
     false
 }
 
+/// 默认休眠时长：终端离开布局 10 分钟后休眠
+const DEFAULT_HIBERNATE_AFTER_SECS: u64 = 600;
+
+/// 休眠和内存预算检查的最小间隔
+const MEMORY_CHECK_INTERVAL: std::time::Duration = std::time::Duration::from_secs(5);
+
+/// 回收后仍超出预算时，用量要再涨过预算的 1/N 才重新回收
+const MEMORY_REGROWTH_DIVISOR: usize = 16;
+
 /// 单个终端的渲染缓存
 struct TerminalRenderCache {
     /// 缓存的渲染结果（Image 比 Surface 更轻量）
@@ -167,6 +181,8 @@ struct TerminalRenderCache {
     /// 缓存对应的尺寸（物理像素）
     width: u32,
     height: u32,
+    /// 光标熄灭时的补丁（只有闪烁中的终端才有）
+    cursor_patch: Option<CursorPatch>,
 }
 
 /// GPU Surface 缓存（按需创建，尺寸变化时重建）
@@ -194,6 +210,9 @@ struct TerminalEntry {
     #[allow(dead_code)]
     machine_handle: JoinHandle<(Machine<teletypewriter::Pty>, crate::rio_machine::State)>,
 
+    /// DEC Synchronized Update 状态（与 Crosswords 共享，无锁读取）
+    sync_status: Arc<SyncStatus>,
+
     /// 终端尺寸
     cols: u16,
     rows: u16,
@@ -249,6 +268,12 @@ struct TerminalEntry {
     /// 为 true 时，close_terminal 会调用 DaemonClient::detach()，
     /// daemon session 保留，后续可通过 reattach 恢复。
     keep_daemon_alive: bool,
+
+    /// 离开布局的时间（在布局中为 None），休眠策略据此计时
+    hidden_since: Option<std::time::Instant>,
+
+    /// 最近一次休眠释放的内存（字节），终端唤醒后失效
+    hibernated_bytes: usize,
 }
 
 /// 分离的终端（用于跨池迁移）
@@ -345,6 +370,32 @@ pub struct TerminalPool {
     /// 插件在 reopenTerminal 前通过 set_reattach_hint 设置，
     /// create_terminal_with_cwd 消费后自动清空（一次性语义）。
     reattach_hint: RwLock<Option<String>>,
+
+    /// 进行中的跨终端搜索 (search_id, 取消句柄)
+    ///
+    /// 同一时间只有一个，新的搜索会取消上一个
+    workspace_search: Mutex<Option<(u64, WorkspaceSearch)>>,
+
+    /// 上一次跨终端搜索的 ID
+    last_workspace_search_id: std::sync::atomic::AtomicU64,
+
+    /// 光标闪烁时钟（熄灭阶段在 end_frame 叠加光标补丁）
+    cursor_blink: CursorBlink,
+
+    /// 休眠策略：终端离开布局超过这么多秒后休眠（0 = 关闭）
+    hibernate_after_secs: std::sync::atomic::AtomicU64,
+
+    /// 内存预算（字节），超出时按顺序回收（0 = 不限制）
+    memory_budget: std::sync::atomic::AtomicU64,
+
+    /// 上一轮回收后仍超出预算时的用量（字节，0 = 没有），用量涨过它之前不再回收
+    memory_floor: std::sync::atomic::AtomicU64,
+
+    /// 当前预算下是否已经清空过行缓存（每次设置预算只清一次）
+    line_cache_cleared: AtomicBool,
+
+    /// 下一次休眠和内存预算检查的时间（只在 DisplayLink 线程访问）
+    next_memory_check: std::time::Instant,
 }
 
 // TerminalPool 需要实现 Send（跨线程传递）
@@ -469,6 +520,16 @@ impl TerminalPool {
             // 缓存初始 font metrics
             cached_font_metrics: std::sync::RwLock::new(initial_font_metrics),
             reattach_hint: RwLock::new(None),
+            workspace_search: Mutex::new(None),
+            last_workspace_search_id: std::sync::atomic::AtomicU64::new(0),
+            cursor_blink: CursorBlink::new(),
+            hibernate_after_secs: std::sync::atomic::AtomicU64::new(
+                DEFAULT_HIBERNATE_AFTER_SECS,
+            ),
+            memory_budget: std::sync::atomic::AtomicU64::new(0),
+            memory_floor: std::sync::atomic::AtomicU64::new(0),
+            line_cache_cleared: AtomicBool::new(false),
+            next_memory_check: std::time::Instant::now(),
         })
     }
 
@@ -555,8 +616,10 @@ impl TerminalPool {
 
         // 3. 存储条目
         let dirty_flag = Arc::new(crate::infra::AtomicDirtyFlag::new());
+        let sync_status = terminal.sync_status();
         let entry = TerminalEntry {
             terminal: Arc::new(Mutex::new(terminal)),
+            sync_status,
             pty_tx,
             machine_handle,
             cols,
@@ -581,6 +644,8 @@ impl TerminalPool {
             ime_state: Arc::new(RwLock::new(None)),
             daemon_session,
             keep_daemon_alive: false,
+            hidden_since: None,
+            hibernated_bytes: 0,
         };
 
         self.terminals.write().insert(id, entry);
@@ -635,8 +700,10 @@ impl TerminalPool {
 
         // 3. 存储条目
         let dirty_flag = Arc::new(crate::infra::AtomicDirtyFlag::new());
+        let sync_status = terminal.sync_status();
         let entry = TerminalEntry {
             terminal: Arc::new(Mutex::new(terminal)),
+            sync_status,
             pty_tx,
             machine_handle,
             cols,
@@ -661,6 +728,8 @@ impl TerminalPool {
             ime_state: Arc::new(RwLock::new(None)),
             daemon_session,
             keep_daemon_alive: false,
+            hidden_since: None,
+            hibernated_bytes: 0,
         };
 
         self.terminals.write().insert(id, entry);
@@ -704,8 +773,10 @@ impl TerminalPool {
 
         // 3. 存储条目
         let dirty_flag = Arc::new(crate::infra::AtomicDirtyFlag::new());
+        let sync_status = terminal.sync_status();
         let entry = TerminalEntry {
             terminal: Arc::new(Mutex::new(terminal)),
+            sync_status,
             pty_tx,
             machine_handle,
             cols,
@@ -730,6 +801,8 @@ impl TerminalPool {
             ime_state: Arc::new(RwLock::new(None)),
             daemon_session,
             keep_daemon_alive: false,
+            hidden_since: None,
+            hibernated_bytes: 0,
         };
 
         self.terminals.write().insert(id, entry);
@@ -789,8 +862,10 @@ impl TerminalPool {
 
         // 3. 存储条目
         let dirty_flag = Arc::new(crate::infra::AtomicDirtyFlag::new());
+        let sync_status = terminal.sync_status();
         let entry = TerminalEntry {
             terminal: Arc::new(Mutex::new(terminal)),
+            sync_status,
             pty_tx,
             machine_handle,
             cols,
@@ -815,6 +890,8 @@ impl TerminalPool {
             ime_state: Arc::new(RwLock::new(None)),
             daemon_session,
             keep_daemon_alive: false,
+            hidden_since: None,
+            hibernated_bytes: 0,
         };
 
         self.terminals.write().insert(id, entry);
@@ -902,8 +979,10 @@ impl TerminalPool {
 
         // 4. 存储条目
         let dirty_flag = Arc::new(crate::infra::AtomicDirtyFlag::new());
+        let sync_status = terminal.sync_status();
         let entry = TerminalEntry {
             terminal: Arc::new(Mutex::new(terminal)),
+            sync_status,
             pty_tx,
             machine_handle,
             cols,
@@ -928,6 +1007,8 @@ impl TerminalPool {
             ime_state: Arc::new(RwLock::new(None)),
             daemon_session: None, // 非 daemon 管理
             keep_daemon_alive: false,
+            hidden_since: None,
+            hibernated_bytes: 0,
         };
 
         self.terminals.write().insert(id, entry);
@@ -1719,6 +1800,10 @@ impl TerminalPool {
         let terminals = self.terminals.read();
         if let Some(entry) = terminals.get(&id) {
             crate::rio_machine::send_input(&entry.pty_tx, data);
+            // 打字时光标常亮，闪烁从输入时刻重新计时
+            if self.cursor_blink.terminal_id() == Some(id) {
+                self.cursor_blink.reset(std::time::Instant::now());
+            }
             // 输入后标记需要渲染
             // 某些应用（如 Claude CLI）在 raw 模式下不产生即时回显，
             // 但仍需要更新光标位置等状态，所以输入后应触发渲染
@@ -1730,6 +1815,26 @@ impl TerminalPool {
         }
     }
 
+    /// 流式粘贴
+    ///
+    /// 由 PTY 线程按块写入，终端启用 Bracketed Paste Mode 时自动包裹转义序列，
+    /// 期间的交互输入会插到粘贴前面。终端不存在时 `data` 被直接丢弃（释放）。
+    pub fn paste(&self, id: usize, data: PasteData) -> bool {
+        let bracketed = self.is_bracketed_paste_enabled(id);
+        let terminals = self.terminals.read();
+        if let Some(entry) = terminals.get(&id) {
+            let sent = crate::rio_machine::send_paste(
+                &entry.pty_tx,
+                Paste::new(data, bracketed),
+            );
+            self.needs_render.store(true, Ordering::Release);
+            sent
+        } else {
+            eprintln!("[TerminalPool] paste: id={} NOT FOUND", id);
+            false
+        }
+    }
+
     /// 滚动终端
     ///
     /// 使用 try_lock 避免阻塞主线程，如果锁被占用则跳过这次滚动
@@ -1753,6 +1858,43 @@ impl TerminalPool {
         }
     }
 
+    /// 把上一个（`previous = true`）或下一个命令提示符滚动到视口顶部
+    ///
+    /// 依赖 shell 的 OSC 133 标记，没有提示符可跳时返回 false
+    pub fn scroll_to_prompt(&self, id: usize, previous: bool) -> bool {
+        let terminals = self.terminals.read();
+        if let Some(entry) = terminals.get(&id) {
+            let mut terminal = entry.terminal.lock();
+            if !terminal.scroll_to_prompt(previous) {
+                return false;
+            }
+            entry.dirty_flag.mark_dirty();
+            self.needs_render.store(true, Ordering::Release);
+            true
+        } else {
+            false
+        }
+    }
+
+    /// 最近一条已结束命令的输出（复制上一条命令输出）
+    pub fn last_command_output(&self, id: usize) -> Option<String> {
+        let terminals = self.terminals.read();
+        let entry = terminals.get(&id)?;
+        let mut terminal = entry.terminal.lock();
+        terminal.last_command_output()
+    }
+
+    /// 导出命令块列表（JSON 数组）
+    ///
+    /// 每项包含 index、prompt_row、command、exit_code、running、duration_ms，
+    /// `include_output` 为 true 时附带 output
+    pub fn command_blocks_json(&self, id: usize, include_output: bool) -> Option<String> {
+        let terminals = self.terminals.read();
+        let entry = terminals.get(&id)?;
+        let mut terminal = entry.terminal.lock();
+        serde_json::to_string(&terminal.command_blocks(include_output)).ok()
+    }
+
     /// 设置选区
     ///
     /// 使用 try_lock 避免阻塞主线程
@@ -2142,6 +2284,13 @@ impl TerminalPool {
             let terminals = self.terminals.read();
             match terminals.get(&id) {
                 Some(entry) => {
+                    // DEC Synchronized Update (mode 2026)：sync 进行中直接跳过（无锁）
+                    // 不清除 dirty_flag / 选区脏标记，ESU 时的 Wakeup 会触发完整的一帧，
+                    // 也不去抢 Terminal 锁（PTY 线程正在往 sync 缓冲区写数据）
+                    if entry.sync_status.is_syncing() {
+                        return true;
+                    }
+
                     // 检查缓存
                     let valid = match &entry.render_cache {
                         Some(cache) => {
@@ -2154,9 +2303,15 @@ impl TerminalPool {
                     // 返回值是之前的状态，如果为 true 则继续渲染
                     let dirty = entry.dirty_flag.check_and_clear();
                     let sel_dirty = entry.selection_overlay.check_and_clear_dirty();
-                    if valid && !dirty && !sel_dirty {
+                    // sync 刚结束（ESU / 超时 / 溢出）：强制渲染这一帧
+                    let sync_ended = entry
+                        .render_state
+                        .lock()
+                        .observe_sync_generation(entry.sync_status.generation());
+                    if valid && !dirty && !sel_dirty && !sync_ended {
                         return true;
                     }
+                    let dirty = dirty || sync_ended;
                     // 传递 dirty 状态供后续阶段使用
                     (valid, dirty, sel_dirty)
                 }
@@ -2175,7 +2330,7 @@ impl TerminalPool {
         let (
             terminal_arc,
             render_state_arc,
-            _dirty_flag,
+            dirty_flag,
             cursor_cache,
             selection_cache,
             scroll_cache,
@@ -2205,21 +2360,38 @@ impl TerminalPool {
                 Some(mut terminal) => {
                     // 检查 DEC Synchronized Update (mode 2026)
                     // 如果正在 sync 中（收到 BSU 但未收到 ESU），跳过渲染以避免闪烁
+                    // （阶段 1 已无锁检查过，这里处理两阶段之间刚进入 sync 的情况）
                     if terminal.is_syncing() {
-                        // 渲染被跳过，如果选区脏标记已清除，需要重新标记确保下帧继续渲染
+                        // 渲染被跳过，如果脏标记已清除，需要重新标记确保 sync 结束后继续渲染
+                        if dirty_cleared {
+                            dirty_flag.mark_dirty();
+                        }
                         if sel_dirty_cleared {
                             selection_overlay.mark_dirty();
                         }
                         return true;
                     }
 
+                    // 休眠的终端重新显示：先恢复历史行（惰性唤醒）
+                    terminal.wake();
+
+                    // 光标只在终端自己设置为闪烁时闪，刚开始闪时要重新渲染生成补丁
+                    let blink_changed = self.cursor_blink.terminal_id() == Some(id)
+                        && self
+                            .cursor_blink
+                            .set_blinking(terminal.is_cursor_blinking());
+
                     // 使用增量更新获取状态（COW 优化）
                     let mut state = terminal.state_incremental();
                     let rows = state.grid.lines();
 
                     // 检查是否需要渲染
                     let is_damaged = terminal.is_damaged();
-                    if cache_valid && !is_damaged && !dirty_cleared && !sel_dirty_cleared
+                    if cache_valid
+                        && !is_damaged
+                        && !dirty_cleared
+                        && !sel_dirty_cleared
+                        && !blink_changed
                     {
                         return true;
                     }
@@ -2383,7 +2555,9 @@ impl TerminalPool {
                         // 绘制选区叠加层
                         // 注意：空白检查只在 mouseUp (finalize_selection) 时执行，
                         // 渲染时始终显示选区，让用户在拖拽过程中看到选区位置
-                        if let Some(snapshot) = entry.selection_overlay.snapshot() {
+                        let selection_snapshot = entry.selection_overlay.snapshot();
+                        let has_selection_overlay = selection_snapshot.is_some();
+                        if let Some(snapshot) = selection_snapshot {
                             use crate::domain::primitives::PhysicalPixels;
                             let physical_cell_width = PhysicalPixels::new(
                                 logical_cell_size.width.value * scale,
@@ -2396,6 +2570,7 @@ impl TerminalPool {
                                 physical_cell_width,
                                 physical_line_height,
                                 rows,
+                                state.grid.columns(),
                                 state.grid.history_size(),
                                 state.grid.display_offset(),
                             );
@@ -2427,6 +2602,24 @@ impl TerminalPool {
                             );
                         }
 
+                        // 光标闪烁补丁：只为闪烁中的终端生成
+                        // 有选区或 IME 预编辑时不闪烁（补丁会盖掉叠加层）
+                        let cursor_patch = if self.cursor_blink.terminal_id() == Some(id)
+                            && self.cursor_blink.is_blinking()
+                            && state.ime.is_none()
+                            && !has_selection_overlay
+                        {
+                            super::cursor_blink::render_cursor_patch(
+                                &mut renderer,
+                                &state,
+                                rows,
+                                logical_cell_size.width.value * scale,
+                                logical_line_height.value * scale,
+                            )
+                        } else {
+                            None
+                        };
+
                         // 统计在 render_all 中统一输出，这里不重置
                         // renderer.print_frame_stats(&format!("terminal_{}", id));
 
@@ -2436,6 +2629,7 @@ impl TerminalPool {
                             cached_image,
                             width: cache_width,
                             height: cache_height,
+                            cursor_patch,
                         });
                     } else {
                         return false;
@@ -2493,6 +2687,14 @@ impl TerminalPool {
             return;
         }
 
+        // 光标熄灭阶段：在闪烁终端的图像上叠加光标补丁
+        let hidden_cursor_terminal = if self.cursor_blink.is_cursor_hidden() {
+            self.cursor_blink.terminal_id()
+        } else {
+            None
+        };
+        let scale = self.config.scale;
+
         // 从每个终端的缓存获取 Image
         let mut objects = Vec::new();
         {
@@ -2507,6 +2709,16 @@ impl TerminalPool {
                         };
 
                         objects.push(Object::Image(image_obj));
+
+                        if hidden_cursor_terminal == Some(*terminal_id) {
+                            if let Some(patch) = &render_cache.cursor_patch {
+                                // 补丁偏移是整数物理像素，与终端图像对齐
+                                objects.push(Object::Image(ImageObject {
+                                    position: [x + patch.x / scale, y + patch.y / scale],
+                                    image: patch.image.clone(),
+                                }));
+                            }
+                        }
                     }
                 }
             }
@@ -2822,9 +3034,15 @@ impl TerminalPool {
         }
         let render_time = render_start.elapsed();
 
+        // 顺带推进光标闪烁，end_frame 按当前亮灭合成
+        self.cursor_blink.tick(std::time::Instant::now());
+
         // 结束帧（统一提交渲染）
         self.end_frame();
 
+        // 持续有输出时空闲回调不会触发，这里也检查一次（自带限频）
+        self.reclaim_memory();
+
         let frame_time = frame_start.elapsed();
 
         // 🎯 帧时间日志（默认关闭，只有开启 perf_log feature 才输出）
@@ -2845,6 +3063,349 @@ impl TerminalPool {
         }
     }
 
+    /// 设置光标闪烁的终端和间隔（`None` 或零间隔关闭闪烁）
+    ///
+    /// 新的闪烁终端需要重新渲染一次来生成光标补丁
+    pub fn set_cursor_blink(
+        &self,
+        terminal_id: Option<usize>,
+        interval: std::time::Duration,
+    ) {
+        let previous = self.cursor_blink.terminal_id();
+        self.cursor_blink
+            .configure(terminal_id, interval, std::time::Instant::now());
+
+        let current = self.cursor_blink.terminal_id();
+        if current != previous {
+            let terminals = self.terminals.read();
+            for id in [previous, current].into_iter().flatten() {
+                if let Some(entry) = terminals.get(&id) {
+                    entry.dirty_flag.mark_dirty();
+                }
+            }
+        }
+        self.needs_render.store(true, Ordering::Release);
+    }
+
+    /// 推进光标闪烁（由 RenderScheduler 在没有渲染请求的 VSync 上调用）
+    ///
+    /// 亮灭切换时只用缓存的终端图像和光标补丁重新合成，不渲染任何终端。
+    /// 返回是否提交了新的一帧
+    pub fn tick_cursor_blink(&mut self) -> bool {
+        if !self.cursor_blink.tick(std::time::Instant::now()) {
+            return false;
+        }
+        self.end_frame();
+        true
+    }
+
+    // ========================================================================
+    // 终端休眠 / 内存预算
+    // ========================================================================
+    //
+    // 几十个 Tab 时，后台终端的历史行和渲染缓存占了大部分内存。离开布局太久的
+    // 终端会休眠：释放 Surface/Image 缓存，历史行压缩成紧凑编码。PTY 照常读写，
+    // 重新出现在布局中时 render_terminal 惰性恢复历史行。
+    //
+    // 设置了内存预算时，超出预算按代价从低到高回收，回到预算内即停止：
+    // 1. 收缩历史：释放网格复用的空行、历史行的文本缓存和多余容量（不丢内容）
+    // 2. 丢弃缓存：不可见终端的渲染缓存和网格快照，仍不够再清空行缓存
+    // 3. 休眠不可见终端，离开布局最久的优先
+    //
+    // 可见终端和焦点终端从不回收。可回收的都回收了仍超出预算时（预算比可见内容
+    // 还小），记下此时的用量，涨过预算的 1/16 之前不再回收，避免每 5 秒重复
+    // 收缩、重建同一批缓存。行缓存每次设置预算最多清空一次。
+
+    /// 设置休眠时长（秒），终端离开布局超过这个时长后休眠，0 关闭
+    pub fn set_hibernate_after(&self, secs: u64) {
+        self.hibernate_after_secs.store(secs, Ordering::Relaxed);
+    }
+
+    /// 设置内存预算（字节），0 不限制
+    pub fn set_memory_budget(&self, bytes: u64) {
+        self.memory_budget.store(bytes, Ordering::Relaxed);
+        self.memory_floor.store(0, Ordering::Relaxed);
+        self.line_cache_cleared.store(false, Ordering::Relaxed);
+    }
+
+    /// 回收内存（由 RenderScheduler 调用，自带限频）
+    ///
+    /// 休眠离开布局太久的终端，超出内存预算时按顺序回收。
+    pub fn reclaim_memory(&mut self) {
+        let now = std::time::Instant::now();
+        if now < self.next_memory_check {
+            return;
+        }
+        self.next_memory_check = now + MEMORY_CHECK_INTERVAL;
+
+        // 锁顺序：render_layout → terminals
+        let visible_ids: std::collections::HashSet<usize> = self
+            .render_layout
+            .lock()
+            .iter()
+            .map(|(id, _, _, _, _)| *id)
+            .collect();
+
+        self.hibernate_idle_terminals(&visible_ids, now);
+        self.enforce_memory_budget(&visible_ids, now);
+    }
+
+    /// 休眠离开布局太久的终端
+    fn hibernate_idle_terminals(
+        &self,
+        visible_ids: &std::collections::HashSet<usize>,
+        now: std::time::Instant,
+    ) {
+        // 非阻塞获取写锁，失败时下次检查重试
+        let Some(mut terminals) = self.terminals.try_write() else {
+            return;
+        };
+        let secs = self.hibernate_after_secs.load(Ordering::Relaxed);
+        let hibernate_after = std::time::Duration::from_secs(secs);
+
+        for (id, entry) in terminals.iter_mut() {
+            if visible_ids.contains(id) {
+                entry.hidden_since = None;
+                continue;
+            }
+            let hidden_since = *entry.hidden_since.get_or_insert(now);
+            if secs == 0 || now.duration_since(hidden_since) < hibernate_after {
+                continue;
+            }
+            if let Some(released) = Self::hibernate_entry(entry) {
+                crate::rust_log_info!(
+                    "[Hibernate] terminal {} hibernated, reclaimed {} KB",
+                    id,
+                    released / 1024
+                );
+            }
+        }
+    }
+
+    /// 超出内存预算时回收内存
+    ///
+    /// 统计要遍历所有历史行，只在设置了预算时进行（随 reclaim_memory 限频）。
+    /// 正忙的终端本轮跳过，可见终端和焦点终端不回收。
+    fn enforce_memory_budget(
+        &self,
+        visible_ids: &std::collections::HashSet<usize>,
+        now: std::time::Instant,
+    ) {
+        let budget = self.memory_budget.load(Ordering::Relaxed) as usize;
+        if budget == 0 {
+            return;
+        }
+        let Some(mut terminals) = self.terminals.try_write() else {
+            return;
+        };
+        // 锁顺序：terminals → renderer
+        let Some(mut renderer) = self.renderer.try_lock() else {
+            return;
+        };
+
+        let line_cache = renderer.cache.memory_stats().3;
+        let total = line_cache
+            + terminals
+                .values()
+                .filter_map(|entry| {
+                    let terminal = entry.terminal.try_lock()?;
+                    Some(terminal.memory_usage().total() + Self::surface_bytes(entry))
+                })
+                .sum::<usize>();
+        if total <= budget {
+            self.memory_floor.store(0, Ordering::Relaxed);
+            return;
+        }
+        // 上一轮已经回收到底，用量没有明显增长就没有新的可回收内存
+        let floor = self.memory_floor.load(Ordering::Relaxed) as usize;
+        if floor > 0 && total < floor + budget / MEMORY_REGROWTH_DIVISOR {
+            return;
+        }
+        let excess = total - budget;
+        let mut released = 0;
+
+        let focused = self.cursor_blink.terminal_id();
+        let reclaimable = |id: &usize| !visible_ids.contains(id) && Some(*id) != focused;
+
+        // 1. 收缩历史
+        for (id, entry) in terminals.iter() {
+            if released >= excess {
+                break;
+            }
+            if !reclaimable(id) {
+                continue;
+            }
+            if let Some(mut terminal) = entry.terminal.try_lock() {
+                released += terminal.shrink_to_fit();
+            }
+        }
+
+        // 2. 丢弃缓存（不可见终端下次显示时重建，行缓存下一帧重建）
+        for (id, entry) in terminals.iter_mut() {
+            if released >= excess {
+                break;
+            }
+            if reclaimable(id) {
+                released += Self::drop_render_caches(entry);
+            }
+        }
+        if released < excess
+            && line_cache > 0
+            && !self.line_cache_cleared.swap(true, Ordering::Relaxed)
+        {
+            renderer.cache.clear();
+            released += line_cache;
+            self.needs_render.store(true, Ordering::Release);
+        }
+        drop(renderer);
+
+        // 3. 休眠不可见终端，离开布局最久的优先
+        if released < excess {
+            let mut hidden: Vec<(usize, std::time::Instant)> = terminals
+                .iter()
+                .filter(|(id, _)| reclaimable(id))
+                .map(|(id, entry)| (*id, entry.hidden_since.unwrap_or(now)))
+                .collect();
+            hidden.sort_by_key(|(_, since)| *since);
+
+            for (id, _) in hidden {
+                if released >= excess {
+                    break;
+                }
+                if let Some(entry) = terminals.get_mut(&id) {
+                    released += Self::hibernate_entry(entry).unwrap_or(0);
+                }
+            }
+        }
+
+        if released < excess {
+            let floor = total.saturating_sub(released).max(1);
+            self.memory_floor.store(floor as u64, Ordering::Relaxed);
+            crate::rust_log_warn!(
+                "[Memory] {} KB over budget, reclaimed {} KB",
+                excess / 1024,
+                released / 1024
+            );
+        } else {
+            self.memory_floor.store(0, Ordering::Relaxed);
+            crate::rust_log_info!(
+                "[Memory] {} KB over budget, reclaimed {} KB",
+                excess / 1024,
+                released / 1024
+            );
+        }
+    }
+
+    /// 立即休眠指定终端（不检查是否可见，可见的终端下一帧会被唤醒）
+    ///
+    /// # 返回
+    /// - Some(字节数): 释放的内存
+    /// - None: 终端不存在、已在休眠或正忙
+    pub fn hibernate_terminal(&self, id: usize) -> Option<usize> {
+        let mut terminals = self.terminals.write();
+        let entry = terminals.get_mut(&id)?;
+        entry
+            .hidden_since
+            .get_or_insert_with(std::time::Instant::now);
+        Self::hibernate_entry(entry)
+    }
+
+    /// 休眠中的终端上次休眠释放的内存（字节），未休眠返回 None
+    pub fn hibernated_bytes(&self, id: usize) -> Option<usize> {
+        let terminals = self.terminals.read();
+        let entry = terminals.get(&id)?;
+        entry
+            .terminal
+            .lock()
+            .is_hibernated()
+            .then_some(entry.hibernated_bytes)
+    }
+
+    /// 终端的内存统计
+    ///
+    /// 会遍历终端的所有历史行，不要每帧调用。
+    ///
+    /// 返回 Some((终端内存, 渲染缓存字节数)) 或 None（终端不存在）
+    pub fn memory_stats(&self, id: usize) -> Option<(TerminalMemoryUsage, usize)> {
+        let terminals = self.terminals.read();
+        let entry = terminals.get(&id)?;
+        let usage = entry.terminal.lock().memory_usage();
+        Some((usage, Self::surface_bytes(entry)))
+    }
+
+    /// 池的内存统计
+    ///
+    /// 返回 (所有终端合计, 行缓存, 内存预算)，字节。行缓存按内容共享，不归属单个终端。
+    pub fn pool_memory_stats(&self) -> (usize, usize, usize) {
+        let terminals: usize = self
+            .terminals
+            .read()
+            .values()
+            .map(|entry| {
+                entry.terminal.lock().memory_usage().total() + Self::surface_bytes(entry)
+            })
+            .sum();
+        let line_cache = self.renderer.lock().cache.memory_stats().3;
+        let budget = self.memory_budget.load(Ordering::Relaxed) as usize;
+        (terminals, line_cache, budget)
+    }
+
+    /// 休眠单个终端：压缩历史行，释放 GPU 缓存
+    ///
+    /// 没有可释放的内存（已在休眠、没有历史也没有缓存）时返回 None
+    fn hibernate_entry(entry: &mut TerminalEntry) -> Option<usize> {
+        let mut terminal = entry.terminal.try_lock()?;
+        if terminal.is_hibernated() {
+            return None;
+        }
+        let mut released = terminal.hibernate();
+        drop(terminal);
+
+        released += Self::drop_render_caches(entry);
+        if released == 0 {
+            return None;
+        }
+        entry.hibernated_bytes = released;
+        Some(released)
+    }
+
+    /// 丢弃终端的 Surface/Image 缓存和网格快照，返回释放的字节数
+    fn drop_render_caches(entry: &mut TerminalEntry) -> usize {
+        let mut released = Self::surface_bytes(entry);
+        entry.surface_cache = None;
+        if entry.render_cache.take().is_some() {
+            entry.dirty_flag.mark_dirty();
+        }
+        if let Some(mut terminal) = entry.terminal.try_lock() {
+            released += terminal.drop_snapshot();
+        }
+        released
+    }
+
+    /// 终端渲染缓存占用的显存（字节）
+    ///
+    /// Image 是 Surface 的快照，共享同一块纹理，只按 Surface 尺寸计算一次。
+    fn surface_bytes(entry: &TerminalEntry) -> usize {
+        let size = entry
+            .surface_cache
+            .as_ref()
+            .map(|cache| (cache.width, cache.height))
+            .or_else(|| {
+                entry
+                    .render_cache
+                    .as_ref()
+                    .map(|cache| (cache.width, cache.height))
+            });
+        let patch = entry
+            .render_cache
+            .as_ref()
+            .and_then(|cache| cache.cursor_patch.as_ref())
+            .map_or(0, |patch| {
+                patch.image.width() as usize * patch.image.height() as usize * 4
+            });
+        size.map_or(0, |(width, height)| width as usize * height as usize * 4) + patch
+    }
+
     /// 调整 Sugarloaf 尺寸
     ///
     /// 使用 try_lock 避免阻塞主线程：
@@ -3196,6 +3757,17 @@ impl TerminalPool {
             .and_then(|entry| entry.title_cache.read())
     }
 
+    /// 获取终端的 Synchronized Update 统计（无锁）
+    ///
+    /// 返回 Some((统计, 是否正在 sync)) 或 None（终端不存在）。
+    /// `aborted()` 持续增长说明 TUI 经常超出 sync 超时或 2 MiB 缓冲上限。
+    pub fn get_sync_stats(&self, id: usize) -> Option<(SyncStats, bool)> {
+        self.terminals
+            .read()
+            .get(&id)
+            .map(|entry| (entry.sync_status.stats(), entry.sync_status.is_syncing()))
+    }
+
     /// 检查是否需要渲染
     ///
     /// 供外部调度器（如 RenderScheduler）查询
@@ -3334,6 +3906,81 @@ impl TerminalPool {
         }
     }
 
+    /// 跨终端搜索（异步）
+    ///
+    /// 查询只编译一次，在 rayon 线程池上并行扫描 `terminal_ids` 指定的终端
+    /// （None = 所有终端）的历史和屏幕，命中通过 `sink` 流式回调，总数不超过 `max_hits`。
+    /// 不修改各终端自己的搜索状态和高亮。新的搜索会取消上一次未完成的搜索。
+    ///
+    /// # 返回
+    /// - 搜索 ID（> 0），查询无效返回 -1
+    pub fn search_all(
+        &self,
+        query: &str,
+        is_regex: bool,
+        case_sensitive: bool,
+        terminal_ids: Option<&[usize]>,
+        max_hits: usize,
+        sink: WorkspaceSearchSink,
+    ) -> i64 {
+        let compiled = match rio_backend::crosswords::compile_search(
+            query,
+            is_regex,
+            case_sensitive,
+        ) {
+            Ok(compiled) => compiled,
+            Err(_) => return -1,
+        };
+
+        // 只在收集 Arc 时持有 terminals 读锁，扫描时只锁单个终端
+        let targets: Vec<(usize, Arc<Mutex<Terminal>>)> = {
+            let terminals = self.terminals.read();
+            match terminal_ids {
+                Some(ids) => ids
+                    .iter()
+                    .filter_map(|id| {
+                        terminals.get(id).map(|entry| (*id, entry.terminal.clone()))
+                    })
+                    .collect(),
+                None => terminals
+                    .iter()
+                    .map(|(id, entry)| (*id, entry.terminal.clone()))
+                    .collect(),
+            }
+        };
+
+        let search = WorkspaceSearch::new();
+        let search_id = self
+            .last_workspace_search_id
+            .fetch_add(1, Ordering::Relaxed)
+            + 1;
+        if let Some((_, previous)) = self
+            .workspace_search
+            .lock()
+            .replace((search_id, search.clone()))
+        {
+            previous.cancel();
+        }
+
+        rayon::spawn(move || {
+            let status = search.run(&targets, &compiled, max_hits, &|hits| {
+                sink.hits(search_id, hits)
+            });
+            sink.finish(search_id, status);
+        });
+
+        search_id as i64
+    }
+
+    /// 取消进行中的跨终端搜索
+    ///
+    /// 回调随后会收到 Cancelled 状态
+    pub fn cancel_search_all(&self) {
+        if let Some((_, search)) = self.workspace_search.lock().take() {
+            search.cancel();
+        }
+    }
+
     /// 跳转到下一个匹配
     ///
     /// # 参数
@@ -3469,6 +4116,7 @@ impl TerminalPool {
     /// - cell_width: 单元格宽度（物理像素）
     /// - line_height: 行高（物理像素）
     /// - screen_rows: 可见行数
+    /// - columns: 列数
     /// - history_size: 历史缓冲区大小
     /// - display_offset: 滚动偏移
     fn draw_selection_overlay(
@@ -3478,10 +4126,11 @@ impl TerminalPool {
         cell_width: crate::domain::primitives::PhysicalPixels,
         line_height: crate::domain::primitives::PhysicalPixels,
         screen_rows: usize,
+        columns: usize,
         history_size: usize,
         display_offset: usize,
     ) {
-        use crate::infra::SelectionType;
+        use crate::domain::{AbsolutePoint, SelectionType, SelectionView};
 
         // 选区背景色：半透明蓝色
         let selection_color = skia_safe::Color4f::new(0.3, 0.5, 0.8, 0.35);
@@ -3490,77 +4139,54 @@ impl TerminalPool {
         paint.set_color4f(selection_color, None);
         paint.set_anti_alias(false); // 矩形不需要抗锯齿
 
-        // 规范化选区：确保 start <= end（支持反向选择）
-        let (sel_start_row, sel_start_col, sel_end_row, sel_end_col) =
-            if selection.start_row < selection.end_row
-                || (selection.start_row == selection.end_row
-                    && selection.start_col <= selection.end_col)
-            {
-                // 正向选择
-                (
-                    selection.start_row,
-                    selection.start_col,
-                    selection.end_row,
-                    selection.end_col,
-                )
-            } else {
-                // 反向选择：交换 start 和 end
-                (
-                    selection.end_row,
-                    selection.end_col,
-                    selection.start_row,
-                    selection.start_col,
-                )
-            };
-
-        // 遍历可见行
-        for screen_row in 0..screen_rows {
-            // 计算绝对行号
-            let abs_row =
-                (history_size + screen_row).saturating_sub(display_offset) as i32;
+        let ty = match selection.ty {
+            crate::infra::SelectionType::Simple => SelectionType::Simple,
+            crate::infra::SelectionType::Block => SelectionType::Block,
+            crate::infra::SelectionType::Lines => SelectionType::Lines,
+        };
+        let view = SelectionView::new(
+            AbsolutePoint::new(
+                selection.start_row.max(0) as usize,
+                selection.start_col as usize,
+            ),
+            AbsolutePoint::new(
+                selection.end_row.max(0) as usize,
+                selection.end_col as usize,
+            ),
+            ty,
+        );
 
-            // 检查是否在选区范围内
-            if abs_row < sel_start_row || abs_row > sel_end_row {
-                continue;
-            }
+        // 每帧换算一次：可见行 → 列区间（已处理反向选择和块选区）
+        let first_line = history_size.saturating_sub(display_offset);
+        let spans = view.spans(first_line, screen_rows, columns);
 
-            // 计算该行的选区列范围
-            let (start_col, end_col) = match selection.ty {
-                SelectionType::Block => {
-                    // 块选区：固定列范围（也需要规范化）
-                    (
-                        sel_start_col.min(sel_end_col),
-                        sel_start_col.max(sel_end_col),
-                    )
-                }
-                SelectionType::Lines => {
-                    // 行选区：整行
-                    (0, u32::MAX)
-                }
-                SelectionType::Simple => {
-                    // 普通选区
-                    let start = if abs_row == sel_start_row {
-                        sel_start_col
-                    } else {
-                        0
-                    };
-                    let end = if abs_row == sel_end_row {
-                        sel_end_col
-                    } else {
-                        u32::MAX
-                    };
-                    (start, end)
+        // 连续的整行选中合并成一个矩形，大选区中间部分不逐行绘制
+        let mut screen_row = 0;
+        while screen_row < spans.len() {
+            let span = match spans[screen_row] {
+                Some(span) => span,
+                None => {
+                    screen_row += 1;
+                    continue;
                 }
             };
 
-            // 绘制矩形
-            let x = start_col as f32 * cell_width.value;
-            let y = screen_row as f32 * line_height.value;
-            let w = ((end_col.saturating_sub(start_col)).min(1000) + 1) as f32
-                * cell_width.value;
-            let h = line_height.value;
+            let mut run = 1;
+            if span.is_full_row(columns) {
+                while spans.get(screen_row + run).is_some_and(|next| {
+                    next.is_some_and(|next| next.is_full_row(columns))
+                }) {
+                    run += 1;
+                }
+            }
 
+            let x = span.start_col as f32 * cell_width.value;
+            let y = screen_row as f32 * line_height.value;
+            let w = (span.end_col - span.start_col + 1) as f32 * cell_width.value;
+            let h = run as f32 * line_height.value;
             canvas.draw_rect(skia_safe::Rect::from_xywh(x, y, w, h), &paint);
+
+            screen_row += run;
         }
     }
 
@@ -3713,6 +4339,9 @@ impl Drop for TerminalPool {
         // - 如果不先 shutdown，回调可能使用已释放的内存
         self.event_queue.shutdown();
 
+        // 停止跨终端搜索，工作线程持有的是终端 Arc，不会访问已释放的 pool
+        self.cancel_search_all();
+
         // terminals 会自动 drop，PTY 连接会关闭
         // #[cfg(debug_assertions)]
         // eprintln!("🗑️ [TerminalPool] Dropped pool with {} terminals", self.terminals.read().len());
@@ -0,0 +1,240 @@
+//! Workspace Search - 跨终端搜索
+//!
+//! 在所有（或指定的）终端的历史和屏幕中搜索同一个查询：
+//! - 查询只编译一次（纯文本走子串搜索，正则才构建 DFA），每个终端 clone 一份
+//!   （lazy DFA 的缓存不能跨线程共享）
+//! - 终端之间在 rayon 线程池上并行扫描，每个终端只持有自己的锁
+//! - 每扫描一批行（约 1024 行）就释放终端锁，PTY 线程和渲染不会被长时间的
+//!   扫描挡住；命中在锁外交给回调
+//! - 命中按批流式交给回调，全局上限由原子计数保证，不会多报
+//! - 可随时取消：每扫描一批行检查一次取消标记，长时间无命中的扫描也能及时停下
+//!
+//! 同一终端的命中按行序到达，不同终端的命中交错到达。
+
+use crate::domain::aggregates::Terminal;
+use crate::domain::views::MatchRange;
+use parking_lot::Mutex;
+use rayon::prelude::*;
+use rio_backend::crosswords::search::SearchQuery;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::Arc;
+
+/// 每批回调的最大命中数
+const BATCH_HITS: usize = 256;
+
+/// 跨终端搜索命中（C-compatible）
+///
+/// 行号为绝对坐标（0 = 历史缓冲区最顶行），列区间包含两端。
+/// 匹配跨越软换行时 `end_line` 大于 `line`。
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct WorkspaceSearchHit {
+    pub terminal_id: usize,
+    pub line: usize,
+    pub start_col: usize,
+    pub end_line: usize,
+    pub end_col: usize,
+}
+
+impl WorkspaceSearchHit {
+    fn new(terminal_id: usize, range: &MatchRange) -> Self {
+        Self {
+            terminal_id,
+            line: range.start.line,
+            start_col: range.start.col,
+            end_line: range.end.line,
+            end_col: range.end.col,
+        }
+    }
+}
+
+/// 跨终端搜索的结束状态
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum WorkspaceSearchStatus {
+    /// 仍在搜索（中间批次）
+    Running = 0,
+    /// 所有终端扫描完成
+    Finished = 1,
+    /// 命中数达到上限，提前结束
+    Capped = 2,
+    /// 被取消（之后不会再有命中批次）
+    Cancelled = 3,
+}
+
+/// 一次跨终端搜索的取消句柄
+#[derive(Debug, Clone, Default)]
+pub struct WorkspaceSearch {
+    cancelled: Arc<AtomicBool>,
+}
+
+impl WorkspaceSearch {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// 取消搜索，正在扫描的终端在当前这批行结束后停止
+    pub fn cancel(&self) {
+        self.cancelled.store(true, Ordering::Release);
+    }
+
+    #[inline]
+    pub fn is_cancelled(&self) -> bool {
+        self.cancelled.load(Ordering::Acquire)
+    }
+
+    /// 在 rayon 线程池上并行搜索 `terminals`，阻塞到所有终端扫描结束
+    ///
+    /// `sink` 在 rayon 工作线程上被调用（不持有终端锁），应尽快返回。
+    /// 取消后不再调用 `sink`。
+    pub fn run(
+        &self,
+        terminals: &[(usize, Arc<Mutex<Terminal>>)],
+        query: &SearchQuery,
+        max_hits: usize,
+        sink: &(dyn Fn(&[WorkspaceSearchHit]) + Sync),
+    ) -> WorkspaceSearchStatus {
+        let reserved = AtomicUsize::new(0);
+        let capped = AtomicBool::new(false);
+        let stop = || self.is_cancelled() || capped.load(Ordering::Relaxed);
+
+        terminals.par_iter().for_each(|(terminal_id, terminal)| {
+            if stop() {
+                return;
+            }
+
+            let mut query = query.clone();
+            let mut batch = Vec::with_capacity(BATCH_HITS);
+            // 休眠的终端临时唤醒，搜完再压缩回去（命中用绝对行号，不受影响）
+            let mut hibernated = false;
+
+            let mut next = Some(0);
+            while let Some(from) = next {
+                if stop() {
+                    break;
+                }
+                // 只在扫描这批行时持锁；两批之间内存预算可能让终端休眠，每批都要唤醒
+                let mut locked = terminal.lock();
+                hibernated |= locked.wake();
+                next = locked.find_matches_from(&mut query, from, |range| {
+                    // 先占用一个全局名额，超出上限的命中直接丢弃
+                    if reserved.fetch_add(1, Ordering::Relaxed) >= max_hits {
+                        capped.store(true, Ordering::Relaxed);
+                        return false;
+                    }
+                    batch.push(WorkspaceSearchHit::new(*terminal_id, &range));
+                    !stop()
+                });
+                drop(locked);
+
+                // 攒满的批次在锁外交付，不足一批的留到下一批行或最后
+                let full = batch.len() - batch.len() % BATCH_HITS;
+                for hits in batch[..full].chunks(BATCH_HITS) {
+                    if self.is_cancelled() {
+                        break;
+                    }
+                    sink(hits);
+                }
+                batch.drain(..full);
+            }
+
+            if hibernated {
+                terminal.lock().hibernate();
+            }
+
+            if !batch.is_empty() && !self.is_cancelled() {
+                sink(&batch);
+            }
+        });
+
+        if self.is_cancelled() {
+            WorkspaceSearchStatus::Cancelled
+        } else if capped.load(Ordering::Relaxed) {
+            WorkspaceSearchStatus::Capped
+        } else {
+            WorkspaceSearchStatus::Finished
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::domain::aggregates::TerminalId;
+    use rio_backend::crosswords::compile_search;
+
+    fn terminal(id: usize, output: &[u8]) -> (usize, Arc<Mutex<Terminal>>) {
+        let mut terminal = Terminal::new_for_test(TerminalId(id), 20, 5);
+        terminal.write(output);
+        (id, Arc::new(Mutex::new(terminal)))
+    }
+
+    fn collect(
+        search: &WorkspaceSearch,
+        terminals: &[(usize, Arc<Mutex<Terminal>>)],
+        query: &str,
+        max_hits: usize,
+    ) -> (Vec<WorkspaceSearchHit>, WorkspaceSearchStatus) {
+        let query = compile_search(query, false, false).unwrap();
+        let hits = Mutex::new(Vec::new());
+        let status = search.run(terminals, &query, max_hits, &|batch| {
+            hits.lock().extend_from_slice(batch)
+        });
+        let mut hits = hits.into_inner();
+        hits.sort_by_key(|hit| (hit.terminal_id, hit.line, hit.start_col));
+        (hits, status)
+    }
+
+    #[test]
+    fn test_search_across_terminals() {
+        let terminals = vec![
+            terminal(1, b"cargo build\r\nerror: oops\r\n"),
+            terminal(2, b"ok\r\n"),
+            terminal(3, b"no Error here\r\nerror again\r\n"),
+        ];
+        let search = WorkspaceSearch::new();
+
+        let (hits, status) = collect(&search, &terminals, "error", usize::MAX);
+        assert_eq!(status, WorkspaceSearchStatus::Finished);
+        let found: Vec<_> = hits
+            .iter()
+            .map(|hit| (hit.terminal_id, hit.line, hit.start_col, hit.end_col))
+            .collect();
+        assert_eq!(found, [(1, 1, 0, 4), (3, 0, 3, 7), (3, 1, 0, 4)]);
+
+        // 全局上限跨终端生效
+        let (hits, status) = collect(&search, &terminals, "error", 2);
+        assert_eq!(status, WorkspaceSearchStatus::Capped);
+        assert_eq!(hits.len(), 2);
+    }
+
+    #[test]
+    fn test_sink_runs_outside_terminal_lock() {
+        // 3000 行跨越多批行
+        let terminals = vec![terminal(1, &b"match\r\n".repeat(3000))];
+        let query = compile_search("match", false, false).unwrap();
+        let hits = AtomicUsize::new(0);
+        let batches = AtomicUsize::new(0);
+
+        let status =
+            WorkspaceSearch::new().run(&terminals, &query, usize::MAX, &|batch| {
+                assert!(terminals[0].1.try_lock().is_some());
+                hits.fetch_add(batch.len(), Ordering::Relaxed);
+                batches.fetch_add(1, Ordering::Relaxed);
+            });
+        assert_eq!(status, WorkspaceSearchStatus::Finished);
+        assert_eq!(hits.into_inner(), 3000);
+        assert!(batches.into_inner() > 1);
+    }
+
+    #[test]
+    fn test_cancelled_search_reports_nothing() {
+        let terminals = vec![terminal(1, b"match\r\n"), terminal(2, b"match\r\n")];
+        let search = WorkspaceSearch::new();
+        search.cancel();
+
+        let (hits, status) = collect(&search, &terminals, "match", usize::MAX);
+        assert_eq!(status, WorkspaceSearchStatus::Cancelled);
+        assert!(hits.is_empty());
+    }
+}
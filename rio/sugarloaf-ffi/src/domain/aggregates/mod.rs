@@ -1,5 +1,5 @@
 pub mod terminal;
 pub mod render_state;
 
-pub use terminal::{Terminal, TerminalId, TerminalMode};
+pub use terminal::{Terminal, TerminalId, TerminalMemoryUsage, TerminalMode};
 pub use render_state::RenderState;
@@ -85,6 +85,9 @@ pub struct RenderState {
     /// 是否需要全量同步（首次或 resize 后）
     needs_full_sync: bool,
 
+    /// 上次渲染时已结束的 Synchronized Update 次数（见 `SyncStatus::generation`）
+    sync_generation: u64,
+
     // ==================== 视图层字段（用于渲染叠加层）====================
 
     /// 选区视图（可选）
@@ -479,6 +482,7 @@ impl RenderState {
             synced_row_hashes: vec![0; rows],
             synced_display_offset: 0,
             needs_full_sync: true, // 首次需要全量同步
+            sync_generation: 0,
             // 视图层字段
             selection: None,
             search: None,
@@ -492,6 +496,16 @@ impl RenderState {
 
     // ==================== 增量同步 API ====================
 
+    /// 记录 Synchronized Update 的结束次数
+    ///
+    /// 返回 true 表示自上一帧以来有 sync 结束（ESU、超时或缓冲区溢出），
+    /// 此时应强制渲染一帧，即使 damage 已被清除。
+    pub fn observe_sync_generation(&mut self, generation: u64) -> bool {
+        let ended = generation != self.sync_generation;
+        self.sync_generation = generation;
+        ended
+    }
+
     /// 从 Crosswords 增量同步变化
     ///
     /// 返回是否有变化（用于决定是否需要渲染）
@@ -1843,6 +1857,20 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_observe_sync_generation() {
+        let mut state = RenderState::new(80, 24);
+
+        // 没有 sync 结束时不强制渲染
+        assert!(!state.observe_sync_generation(0));
+        // sync 结束后只强制一帧
+        assert!(state.observe_sync_generation(1));
+        assert!(!state.observe_sync_generation(1));
+        // 两帧之间结束了多次 sync，仍然只强制一帧
+        assert!(state.observe_sync_generation(3));
+        assert!(!state.observe_sync_generation(3));
+    }
+
     #[test]
     fn test_render_state_cursor_consistency() {
         // 验证光标位置一致性
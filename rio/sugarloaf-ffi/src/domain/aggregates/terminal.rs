@@ -9,6 +9,10 @@
 
 use rio_backend::crosswords::Crosswords;
 
+use rio_backend::crosswords::search::SearchQuery;
+
+use rio_backend::crosswords::sync::SyncStatus;
+
 use rio_backend::crosswords::grid::Dimensions;
 
 use rio_backend::event::EventListener;
@@ -27,7 +31,9 @@ use crate::domain::state::TerminalState;
 
 use crate::domain::events::TerminalEvent;
 
-use crate::domain::views::{CursorView, GridData, GridView, MatchRange, SearchView};
+use crate::domain::views::{
+    CommandBlockView, CursorView, GridData, GridView, MatchRange, SearchView,
+};
 
 use crate::domain::primitives::AbsolutePoint;
 
@@ -62,6 +68,26 @@ pub enum TerminalMode {
     Background = 1,
 }
 
+/// 终端各部分的内存占用（字节，估算）
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct TerminalMemoryUsage {
+    /// 屏幕行（主屏 + 备用屏）+ 渲染用的 COW 网格快照
+    pub grid: usize,
+    /// 历史行（含网格复用的空行、休眠时的压缩历史）
+    pub scrollback: usize,
+    /// 日志缓冲区（未启用为 0）
+    pub log_buffer: usize,
+    /// 还没交给渲染器的图像数据 + Sixel 解析状态
+    pub graphics: usize,
+}
+
+impl TerminalMemoryUsage {
+    #[inline]
+    pub fn total(&self) -> usize {
+        self.grid + self.scrollback + self.log_buffer + self.graphics
+    }
+}
+
 /// 事件收集器（用于从 Crosswords 收集事件）
 
 #[derive(Clone)]
@@ -439,6 +465,68 @@ impl Terminal {
         }
     }
 
+    /// 休眠：压缩历史行并释放 COW 网格缓存（终端长时间不可见时调用）
+    ///
+    /// 屏幕和 PTY 照常工作，新输出照常进入历史；滚动、resize、搜索会自动唤醒，
+    /// 渲染前由 TerminalPool 调用 [`Self::wake`]。
+    ///
+    /// # 返回
+    /// - 释放的堆内存（字节）
+    pub fn hibernate(&mut self) -> usize {
+        let released = with_crosswords_mut!(self, crosswords, crosswords.hibernate());
+        self.cached_grid_data = None;
+        released
+    }
+
+    /// 唤醒：恢复休眠时压缩的历史行
+    ///
+    /// # 返回
+    /// - 之前是否处于休眠状态
+    pub fn wake(&mut self) -> bool {
+        with_crosswords_mut!(self, crosswords, crosswords.wake())
+    }
+
+    /// 是否处于休眠状态
+    pub fn is_hibernated(&self) -> bool {
+        with_crosswords!(self, crosswords, crosswords.is_hibernated())
+    }
+
+    /// 内存占用
+    ///
+    /// 会遍历所有历史行，历史很长时代价不低，不要每帧调用。
+    pub fn memory_usage(&self) -> TerminalMemoryUsage {
+        let usage = with_crosswords!(self, crosswords, crosswords.memory_usage());
+        let snapshot = self
+            .cached_grid_data
+            .as_ref()
+            .map_or(0, |data| data.heap_size());
+        TerminalMemoryUsage {
+            grid: usage.screen + snapshot,
+            scrollback: usage.scrollback,
+            log_buffer: self.log_buffer.as_ref().map_or(0, |lb| lb.heap_size()),
+            graphics: usage.graphics,
+        }
+    }
+
+    /// 释放不影响内容的内存：网格复用的空行、历史行的文本缓存和多余容量、日志缓冲区的多余容量
+    ///
+    /// # 返回
+    /// - 释放的堆内存（字节）
+    pub fn shrink_to_fit(&mut self) -> usize {
+        let released = with_crosswords_mut!(self, crosswords, crosswords.shrink_to_fit());
+        released + self.log_buffer.as_ref().map_or(0, |lb| lb.shrink_to_fit())
+    }
+
+    /// 丢弃 COW 网格快照，下次取状态时全量重建
+    ///
+    /// # 返回
+    /// - 快照占用的堆内存（字节），渲染线程仍持有的部分不会立即释放
+    pub fn drop_snapshot(&mut self) -> usize {
+        self.cached_grid_data
+            .take()
+            .map_or(0, |data| data.heap_size())
+    }
+
     /// 获取终端状态快照（增量更新版，COW 优化）
     ///
     /// 使用缓存的 GridData，只更新变化的行
@@ -729,61 +817,22 @@ impl Terminal {
         screen_col: usize,
     ) -> Option<(usize, usize, String)> {
         with_crosswords!(self, crosswords, {
-            use rio_backend::crosswords::pos::{Column, Line};
+            use rio_backend::crosswords::pos::{Column, Line, Pos};
 
             // 计算 grid line（考虑 display_offset）
             let display_offset = crosswords.display_offset();
             let grid_line = Line((screen_row as i32) - (display_offset as i32));
 
-            // 获取 cell
-            let col = Column(screen_col);
-            let grid = &crosswords.grid;
-
             // 检查坐标是否有效
+            let grid = &crosswords.grid;
             if screen_row >= grid.screen_lines() || screen_col >= grid.columns() {
                 return None;
             }
 
-            let square = &grid[grid_line][col];
-
-            // 检查是否有超链接
-            if let Some(hyperlink) = square.hyperlink() {
-                let uri = hyperlink.uri().to_string();
-                let hyperlink_id = hyperlink.id();
-
-                // 向左右扩展找到完整的超链接范围
-                let columns = grid.columns();
-
-                // 向左扩展
-                let mut left = screen_col;
-                while left > 0 {
-                    let prev_col = Column(left - 1);
-                    if let Some(h) = grid[grid_line][prev_col].hyperlink() {
-                        if h.id() == hyperlink_id {
-                            left -= 1;
-                            continue;
-                        }
-                    }
-                    break;
-                }
-
-                // 向右扩展
-                let mut right = screen_col;
-                while right + 1 < columns {
-                    let next_col = Column(right + 1);
-                    if let Some(h) = grid[grid_line][next_col].hyperlink() {
-                        if h.id() == hyperlink_id {
-                            right += 1;
-                            continue;
-                        }
-                    }
-                    break;
-                }
-
-                Some((left, right, uri))
-            } else {
-                None
-            }
+            // 行内超链接区间按列有序，二分查找命中的区间
+            let pos = Pos::new(grid_line, Column(screen_col));
+            let (span, hyperlink) = crosswords.hyperlink_at(pos)?;
+            Some((span.start.0, span.end.0, hyperlink.uri().to_string()))
         })
     }
 
@@ -1043,6 +1092,21 @@ impl Terminal {
         })
     }
 
+    /// 获取可见区域每一行的文本（去除行尾空白，按屏幕行序）
+    ///
+    /// 直接读取行的文本缓存，行未改变时不会重新遍历 cell。
+    pub fn visible_lines_text(&self) -> Vec<String> {
+        use rio_backend::crosswords::pos::Line;
+
+        with_crosswords!(self, crosswords, {
+            let grid = &crosswords.grid;
+            let top = -(grid.display_offset() as i32);
+            (0..grid.screen_lines() as i32)
+                .map(|row| grid[Line(top + row)].text().as_str().trim_end().to_owned())
+                .collect()
+        })
+    }
+
     /// 完成选区（mouseUp 时调用）
     ///
     /// 业务逻辑：
@@ -1103,6 +1167,25 @@ impl Terminal {
         })
     }
 
+    /// 焦点移动后更新 SearchView
+    ///
+    /// 匹配集合没有变化时只切换焦点，复用已构建的行索引（O(1)）
+    fn refocus_search_view<T>(
+        cached: Option<&SearchView>,
+        crosswords: &Crosswords<T>,
+    ) -> Option<SearchView>
+    where
+        T: EventListener,
+    {
+        let search_state = crosswords.search_state.as_ref()?;
+        match cached {
+            Some(view) if view.match_count() == search_state.all_matches.len() => {
+                Some(view.with_focus(search_state.focused_index))
+            }
+            _ => Self::build_search_view(crosswords),
+        }
+    }
+
     /// 搜索文本
     ///
     /// # 参数
@@ -1172,7 +1255,7 @@ impl Terminal {
             if let Some(pos) = scroll_pos {
                 crosswords.scroll_to_pos(pos);
             }
-            Self::build_search_view(&*crosswords)
+            Self::refocus_search_view(self.cached_search_view.as_ref(), &*crosswords)
         } else if let Some(ref cw) = self.crosswords_test {
             let mut crosswords = cw.write();
             crosswords.search_goto_next();
@@ -1185,7 +1268,7 @@ impl Terminal {
             if let Some(pos) = scroll_pos {
                 crosswords.scroll_to_pos(pos);
             }
-            Self::build_search_view(&*crosswords)
+            Self::refocus_search_view(self.cached_search_view.as_ref(), &*crosswords)
         } else {
             None
         };
@@ -1206,7 +1289,7 @@ impl Terminal {
             if let Some(pos) = scroll_pos {
                 crosswords.scroll_to_pos(pos);
             }
-            Self::build_search_view(&*crosswords)
+            Self::refocus_search_view(self.cached_search_view.as_ref(), &*crosswords)
         } else if let Some(ref cw) = self.crosswords_test {
             let mut crosswords = cw.write();
             crosswords.search_goto_prev();
@@ -1219,7 +1302,7 @@ impl Terminal {
             if let Some(pos) = scroll_pos {
                 crosswords.scroll_to_pos(pos);
             }
-            Self::build_search_view(&*crosswords)
+            Self::refocus_search_view(self.cached_search_view.as_ref(), &*crosswords)
         } else {
             None
         };
@@ -1235,6 +1318,40 @@ impl Terminal {
         self.cached_search_view = None;
     }
 
+    /// 扫描一批行（约 1024 行）中的匹配，不修改本终端的搜索状态（跨终端搜索用）
+    ///
+    /// 调用方在两批之间释放终端锁，用返回值继续下一批，从 `from = 0` 开始。
+    ///
+    /// - `from`: 本批起点（grid 的稳定绝对行号，不随滚动变化）；期间被挤出历史的
+    ///   行跳过，从最旧的行开始
+    /// - `visit`: 收到绝对坐标的匹配范围（按行序，0 = 本批扫描时的历史顶部），
+    ///   返回 false 停止
+    ///
+    /// # 返回
+    /// - Some(下一批的起点)
+    /// - None: 已扫描到屏幕底部，或 `visit` 要求停止
+    pub fn find_matches_from(
+        &self,
+        query: &mut SearchQuery,
+        from: usize,
+        mut visit: impl FnMut(MatchRange) -> bool,
+    ) -> Option<usize> {
+        with_crosswords!(self, crosswords, {
+            let history_size = crosswords.grid.history_size() as i32;
+            crosswords.search_chunk(query, from, |m| {
+                let start = AbsolutePoint::new(
+                    (m.start().row.0 + history_size) as usize,
+                    m.start().col.0,
+                );
+                let end = AbsolutePoint::new(
+                    (m.end().row.0 + history_size) as usize,
+                    m.end().col.0,
+                );
+                visit(MatchRange::new(start, end))
+            })
+        })
+    }
+
     // ==================== Step 7: Scroll ====================
 
     /// 滚动终端
@@ -1270,6 +1387,61 @@ impl Terminal {
         });
     }
 
+    // ==================== Command Blocks (OSC 133) ====================
+
+    /// 把上一个（`previous = true`）或下一个命令提示符滚动到视口顶部
+    ///
+    /// # 返回
+    /// - `false` - 该方向没有提示符（或 shell 未启用 OSC 133）
+    pub fn scroll_to_prompt(&mut self, previous: bool) -> bool {
+        use rio_backend::crosswords::pos::Direction;
+
+        let direction = if previous {
+            Direction::Left
+        } else {
+            Direction::Right
+        };
+        with_crosswords_mut!(self, crosswords, crosswords.scroll_to_prompt(direction))
+    }
+
+    /// 最近一条已结束命令的输出（休眠时先唤醒）
+    pub fn last_command_output(&mut self) -> Option<String> {
+        with_crosswords_mut!(self, crosswords, crosswords.last_command_output())
+    }
+
+    /// 命令块列表（按提示符顺序）
+    ///
+    /// 提示符行和输出可能在休眠的历史里，先唤醒
+    ///
+    /// # 参数
+    /// - `include_output`: 是否附带每条命令的输出（导出用，开销与输出行数成正比）
+    pub fn command_blocks(&mut self, include_output: bool) -> Vec<CommandBlockView> {
+        with_crosswords_mut!(self, crosswords, {
+            crosswords.wake();
+            let history_size = crosswords.grid.history_size() as i32;
+            let blocks: Vec<_> = crosswords.command_blocks().iter().cloned().collect();
+            blocks
+                .into_iter()
+                .enumerate()
+                .map(|(index, block)| CommandBlockView {
+                    index,
+                    prompt_row: crosswords
+                        .command_prompt_line(&block)
+                        .map(|line| (line.0 + history_size) as usize),
+                    running: block.is_executed() && !block.is_finished(),
+                    duration_ms: block.duration().map(|d| d.as_millis() as u64),
+                    output: if include_output {
+                        crosswords.command_output(&block)
+                    } else {
+                        None
+                    },
+                    exit_code: block.exit_code,
+                    command: block.command,
+                })
+                .collect()
+        })
+    }
+
     // ==================== Damage 管理（代理到 Crosswords）====================
 
     /// 检查是否有 damage（需要重绘）
@@ -1301,7 +1473,20 @@ impl Terminal {
     /// 直到收到 ESU (\e[?2026l) 才变为 false。
     /// 在 sync 期间，应该跳过渲染以避免闪烁。
     pub fn is_syncing(&self) -> bool {
-        with_crosswords!(self, crosswords, crosswords.is_syncing)
+        with_crosswords!(self, crosswords, crosswords.is_syncing())
+    }
+
+    /// 光标是否设置为闪烁（DECSCUSR 闪烁形状或 DECSET 12）
+    pub fn is_cursor_blinking(&self) -> bool {
+        with_crosswords!(self, crosswords, crosswords.blinking_cursor)
+    }
+
+    /// 获取共享的 Synchronized Update 状态
+    ///
+    /// 返回的 Arc 与 Crosswords 共享，渲染线程无需 Terminal 锁即可读取
+    /// （是否在 sync 中、已结束的 sync 次数、被中止的 sync 次数）。
+    pub fn sync_status(&self) -> Arc<SyncStatus> {
+        with_crosswords!(self, crosswords, crosswords.sync_status())
     }
 
     /// 检查终端是否启用了 Bracketed Paste Mode
@@ -1612,6 +1797,68 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_visible_lines_text() {
+        let mut terminal = Terminal::new_for_test(TerminalId(1), 20, 3);
+        terminal.write("ls -la\r\n中文 ok".as_bytes());
+
+        assert_eq!(terminal.visible_lines_text(), ["ls -la", "中文 ok", ""]);
+
+        // 行被改写后文本缓存失效
+        terminal.write(b"\rdone");
+        assert_eq!(terminal.visible_lines_text()[1], "done ok");
+    }
+
+    #[test]
+    fn test_hibernate_and_wake() {
+        let mut terminal = Terminal::new_for_test(TerminalId(1), 40, 5);
+        for i in 0..200 {
+            terminal.write(format!("output line {}\r\n", i).as_bytes());
+        }
+        let history_size = terminal.state().grid.history_size();
+        let visible = terminal.visible_lines_text();
+
+        assert!(terminal.hibernate() > 0);
+        assert!(terminal.is_hibernated());
+        // 屏幕不受影响
+        assert_eq!(terminal.visible_lines_text(), visible);
+        assert_eq!(terminal.state().grid.history_size(), 0);
+
+        // 搜索自动唤醒
+        assert!(terminal.search("output line 10") > 0);
+        assert!(!terminal.is_hibernated());
+        assert_eq!(terminal.state().grid.history_size(), history_size);
+
+        terminal.hibernate();
+        assert!(terminal.wake());
+        assert!(!terminal.wake());
+        assert_eq!(terminal.state().grid.history_size(), history_size);
+    }
+
+    #[test]
+    fn test_memory_usage() {
+        let mut terminal = Terminal::new_for_test(TerminalId(1), 40, 5);
+        let empty = terminal.memory_usage();
+        assert!(empty.grid > 0);
+        assert_eq!(empty.log_buffer, 0);
+
+        for i in 0..200 {
+            terminal.write(format!("output line {}\r\n", i).as_bytes());
+        }
+        let _ = terminal.state_incremental();
+        let usage = terminal.memory_usage();
+        assert!(usage.scrollback > empty.scrollback);
+        // 渲染快照计入 grid
+        assert!(usage.grid > empty.grid);
+
+        // 释放复用的空行和快照，内容不变
+        let history_size = terminal.state().grid.history_size();
+        assert!(terminal.shrink_to_fit() > 0);
+        assert!(terminal.drop_snapshot() > 0);
+        assert!(terminal.memory_usage().total() < usage.total());
+        assert_eq!(terminal.state().grid.history_size(), history_size);
+    }
+
     // ==================== Step 6: Search Tests ====================
 
     #[test]
@@ -1770,6 +2017,48 @@ mod tests {
 
     // ==================== Step 8: Integration Tests ====================
 
+    #[test]
+    fn test_command_blocks() {
+        let mut terminal = Terminal::new_for_test(TerminalId(1), 80, 5);
+
+        // 没有 OSC 133 时什么都没有
+        assert!(terminal.command_blocks(false).is_empty());
+        assert!(!terminal.scroll_to_prompt(true));
+
+        terminal.write(b"\x1b]133;A\x07$ \x1b]133;B\x07ls\r\n\x1b]133;C;ls\x07");
+        for i in 0..10 {
+            terminal.write(format!("file{}\r\n", i).as_bytes());
+        }
+        terminal.write(b"\x1b]133;D;0\x07\x1b]133;A\x07$ ");
+
+        let blocks = terminal.command_blocks(true);
+        assert_eq!(blocks.len(), 2);
+        assert_eq!(blocks[0].command.as_deref(), Some("ls"));
+        assert_eq!(blocks[0].exit_code, Some(0));
+        assert_eq!(blocks[0].prompt_row, Some(0));
+        assert!(blocks[0]
+            .output
+            .as_deref()
+            .unwrap()
+            .starts_with("file0\nfile1"));
+        assert!(blocks[1].exit_code.is_none());
+
+        let output = terminal.last_command_output().unwrap();
+        assert_eq!(output.lines().count(), 10);
+        assert_eq!(output.lines().last(), Some("file9"));
+
+        // 休眠的历史里的提示符：读取时先唤醒
+        assert!(terminal.hibernate() > 0);
+        assert_eq!(terminal.command_blocks(false)[0].prompt_row, Some(0));
+        assert!(!terminal.is_hibernated());
+
+        // 跳到滚出屏幕的上一个提示符
+        assert!(terminal.scroll_to_prompt(true));
+        assert!(terminal.state().grid.display_offset() > 0);
+        assert!(terminal.scroll_to_prompt(false));
+        assert_eq!(terminal.state().grid.display_offset(), 0);
+    }
+
     #[test]
     fn test_full_terminal_lifecycle() {
         // 创建终端
@@ -2258,4 +2547,29 @@ mod tests {
         assert_eq!(final_state.grid.columns(), 100);
         assert_eq!(final_state.grid.lines(), 30);
     }
+
+    #[test]
+    fn test_sync_status_shared_with_renderer() {
+        let mut terminal = Terminal::new_for_test(TerminalId(1), 80, 24);
+        let status = terminal.sync_status();
+
+        // BSU：进入 sync，后续内容进入缓冲区，不应出现在网格上
+        terminal.write(b"\x1b[?2026h");
+        terminal.write(b"abc");
+        assert!(status.is_syncing());
+        assert!(terminal.is_syncing());
+        assert_eq!(status.generation(), 0);
+        assert_eq!(terminal.state().grid.row(0).unwrap().cells()[0].c, ' ');
+
+        // ESU：刷新缓冲区，generation 增加，渲染层据此强制出一帧
+        terminal.write(b"\x1b[?2026l");
+        assert!(!status.is_syncing());
+        assert_eq!(status.generation(), 1);
+        assert_eq!(terminal.state().grid.row(0).unwrap().cells()[0].c, 'a');
+
+        let stats = status.stats();
+        assert_eq!(stats.started, 1);
+        assert_eq!(stats.completed, 1);
+        assert_eq!(stats.aborted(), 0);
+    }
 }
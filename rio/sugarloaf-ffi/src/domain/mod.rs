@@ -50,7 +50,7 @@ pub use state::TerminalState;
 pub use renderable::RenderableState;
 
 
-pub use views::{GridView, RowView, GridData, CursorView, SelectionView, SelectionType, SearchView, MatchRange, HyperlinkHoverView, ImeView};
+pub use views::{GridView, RowView, GridData, CursorView, SelectionView, SelectionType, SelectionSpan, SearchView, MatchRange, HyperlinkHoverView, ImeView};
 
 
 pub use primitives::{GridPoint, Absolute, AbsolutePoint, Screen, ScreenPoint};
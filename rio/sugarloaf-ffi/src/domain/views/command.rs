@@ -0,0 +1,31 @@
+//! Command Block View - 命令块快照
+//!
+//! 来自 rio-backend 的 CommandBlocks（OSC 133 标记建立的命令索引），
+//! 用于命令列表导出、跳转到提示符等。
+
+use serde::Serialize;
+
+/// 命令块视图
+///
+/// # 坐标系统
+///
+/// - `prompt_row`: 提示符所在行（绝对坐标，0 = 历史缓冲区最顶行），
+///   已滚出历史缓冲区或处于 alt screen 时为 None
+#[derive(Debug, Clone, PartialEq, Eq, Serialize)]
+pub struct CommandBlockView {
+    /// 在命令块列表中的序号（按提示符顺序）
+    pub index: usize,
+    /// 提示符所在行（绝对坐标）
+    pub prompt_row: Option<usize>,
+    /// Shell 上报的命令行
+    pub command: Option<String>,
+    /// 退出码，命令未结束时为 None
+    pub exit_code: Option<u8>,
+    /// 命令正在运行
+    pub running: bool,
+    /// 执行耗时（毫秒），命令未结束时为 None
+    pub duration_ms: Option<u64>,
+    /// 命令输出（仅导出时填充）
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub output: Option<String>,
+}
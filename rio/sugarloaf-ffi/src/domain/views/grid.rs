@@ -289,7 +289,7 @@ fn is_valid_url_ending(c: char) -> bool {
     c.is_ascii_alphanumeric() || matches!(c, '/' | '-' | '_' | '=' | '~')
 }
 
-fn detect_urls(text: &str) -> Vec<UrlRange> {
+fn detect_urls(text: &str, column_at: impl Fn(usize) -> usize) -> Vec<UrlRange> {
     let mut urls = Vec::new();
 
     for mat in URL_REGEX.find_iter(text) {
@@ -303,28 +303,13 @@ fn detect_urls(text: &str) -> Vec<UrlRange> {
             continue;
         }
 
-        // 计算 trim 掉了多少字符
-        let trimmed_chars = raw_url.len() - trimmed_url.len();
-
-        // 获取字节位置
+        // 字节位置 → 列号（结束列取 URL 最后一个字节所在的列）
         let byte_start = mat.start();
-        let byte_end = mat.end() - trimmed_chars;
-
-        // 安全地获取切片（处理 UTF-8 字符边界）
-        let Some(prefix) = text.get(..byte_start) else {
-            continue;
-        };
-        let Some(url_slice) = text.get(byte_start..byte_end) else {
-            continue;
-        };
-
-        // 转换为字符位置
-        let char_start = prefix.chars().count();
-        let char_end = char_start + url_slice.chars().count() - 1;
+        let byte_end = byte_start + trimmed_url.len();
 
         urls.push(UrlRange {
-            start_col: char_start,
-            end_col: char_end,
+            start_col: column_at(byte_start),
+            end_col: column_at(byte_end - 1),
             uri: trimmed_url.to_string(),
         });
     }
@@ -508,6 +493,23 @@ impl GridData {
         self.rows.get(index)
     }
 
+    /// 堆内存占用（字节，估算）
+    ///
+    /// COW 共享的行按完整大小计入，与上一帧快照共享的部分会重复计算。
+    pub fn heap_size(&self) -> usize {
+        let rows: usize = self
+            .rows
+            .iter()
+            .map(|row| {
+                std::mem::size_of::<RowData>()
+                    + row.cells.capacity() * std::mem::size_of::<CellData>()
+                    + row.urls.capacity() * std::mem::size_of::<UrlRange>()
+            })
+            .sum();
+        rows + self.row_hashes.capacity() * std::mem::size_of::<u64>()
+            + self.rows.capacity() * std::mem::size_of::<Arc<RowData>>()
+    }
+
     /// 创建带内容的 mock GridData（用于性能测试）
     ///
     /// 生成包含真实字符的测试数据，模拟终端典型内容
@@ -710,16 +712,12 @@ impl GridData {
 
         let mut cells = Vec::with_capacity(columns);
         let mut hasher = DefaultHasher::new();
-        let mut row_text = String::with_capacity(columns);
 
         // 遍历该行的所有列
         for col_index in 0..columns {
             let col = Column(col_index);
             let square = &grid[line][col];
 
-            // 收集行文本用于 URL 检测
-            row_text.push(square.c);
-
             // 转换 cell 数据
             let cell = CellData {
                 c: square.c,
@@ -745,8 +743,9 @@ impl GridData {
 
         let content_hash = hasher.finish();
 
-        // 检测 URL（使用预编译的正则，性能开销很小）
-        let urls = detect_urls(&row_text);
+        // 检测 URL：复用行的文本缓存（与搜索、选区共享），字节偏移映射回列号
+        let row_text = grid[line].text();
+        let urls = detect_urls(row_text.as_str(), |offset| row_text.column_at(offset).0);
 
         RowData {
             cells,
@@ -760,6 +759,13 @@ impl GridData {
 mod tests {
     use super::*;
 
+    /// 按字符计列检测 URL（每个字符占一列）
+    fn detect_urls(text: &str) -> Vec<UrlRange> {
+        super::detect_urls(text, |offset| {
+            text.char_indices().filter(|(i, _)| *i <= offset).count() - 1
+        })
+    }
+
     /// 测试：验证 row_hash() 方法
     #[test]
     fn test_grid_view_row_hash() {
@@ -5,7 +5,7 @@
 //! - **复用 Selection 机制**：渲染时类似 SelectionInfo 处理高亮
 //!
 //! 与 rio-backend/square.rs 的 Hyperlink 的关系：
-//! - rio-backend/Hyperlink: 存储在 Square.extra 中的超链接数据
+//! - rio-backend/Hyperlink: 终端级超链接表中的数据，Square 只保存 HyperlinkId
 //! - HyperlinkHoverView: 当前 hover 状态，用于渲染高亮
 
 use crate::domain::primitives::AbsolutePoint;
@@ -11,15 +11,19 @@ pub mod hyperlink;
 
 pub mod ime;
 
+pub mod command;
+
 
 pub use grid::{GridView, RowView, GridData, RowData, UrlRange, CellData};
 
 pub use cursor::CursorView;
 
-pub use selection::{SelectionView, SelectionType};
+pub use selection::{SelectionView, SelectionType, SelectionSpan};
 
-pub use search::{SearchView, MatchRange};
+pub use search::{SearchView, MatchRange, MatchSpan};
 
 pub use hyperlink::HyperlinkHoverView;
 
 pub use ime::ImeView;
+
+pub use command::CommandBlockView;
@@ -7,6 +7,8 @@
 
 use crate::domain::primitives::AbsolutePoint;
 use std::collections::HashMap;
+use std::ops::RangeInclusive;
+use std::sync::Arc;
 
 /// 搜索视图 - 包含所有匹配结果
 ///
@@ -15,13 +17,17 @@ use std::collections::HashMap;
 /// # 字段说明
 ///
 /// - `matches`: 所有匹配范围（保留用于导航）
-/// - `matches_by_line`: 按行索引的匹配（用于快速渲染查询）
+/// - `spans_by_line`: 按行索引的匹配列区间（用于快速渲染查询）
 /// - `focused_index`: 当前焦点匹配的索引（0-based）
 ///
 /// # 性能优化
 ///
-/// `matches_by_line` 将匹配按行号分组，渲染某行时只需检查该行的匹配，
-/// 避免遍历所有匹配（O(cells × matches) → O(cells)）。
+/// `spans_by_line` 在搜索时构建一次，把匹配换算成每行的列区间，
+/// 渲染和 state hash 某行时只需读取该行的区间，不再逐个匹配换算坐标。
+///
+/// `matches` 和 `spans_by_line` 由 Arc 共享：每帧快照 clone 是 O(1)，
+/// 切换焦点（[`SearchView::with_focus`]）也不重建索引。
+/// 焦点移动时只有新旧焦点匹配所在行的 state hash 变化。
 ///
 /// # 使用场景
 ///
@@ -30,14 +36,35 @@ use std::collections::HashMap;
 #[derive(Debug, Clone, PartialEq)]
 pub struct SearchView {
     /// 所有匹配范围（保留用于导航）
-    pub matches: Vec<MatchRange>,
-    /// 按行索引的匹配（用于快速渲染查询）
-    /// key: 行号（绝对坐标）, value: matches 中的索引列表
-    pub matches_by_line: HashMap<usize, Vec<usize>>,
+    pub matches: Arc<Vec<MatchRange>>,
+    /// 按行索引的匹配列区间（用于快速渲染查询）
+    /// key: 行号（绝对坐标）, value: 该行上的匹配区间（按列有序）
+    pub spans_by_line: Arc<HashMap<usize, Vec<MatchSpan>>>,
     /// 当前焦点匹配的索引（0-based）
     pub focused_index: usize,
 }
 
+/// 匹配在某一行上的列区间
+///
+/// 跨行匹配在起始行以外从第 0 列开始，在结束行以外延伸到 `usize::MAX`。
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct MatchSpan {
+    /// 起始列
+    pub start_col: usize,
+    /// 结束列（包含）
+    pub end_col: usize,
+    /// 在 `matches` 中的索引
+    pub index: usize,
+}
+
+impl MatchSpan {
+    /// 列是否在区间内
+    #[inline]
+    pub fn contains(&self, col: usize) -> bool {
+        self.start_col <= col && col <= self.end_col
+    }
+}
+
 /// 匹配范围 - 表示单个搜索匹配的位置
 ///
 /// 代表一个搜索匹配在终端网格中的位置范围。
@@ -69,8 +96,8 @@ impl SearchView {
     ///
     /// # 性能说明
     ///
-    /// 构建时会自动生成 `matches_by_line` 索引，将匹配按行号分组。
-    /// 如果一个匹配跨多行，会在所有涉及的行中添加索引。
+    /// 构建时会自动生成 `spans_by_line` 索引，将匹配按行号分组。
+    /// 如果一个匹配跨多行，会在所有涉及的行中添加区间。
     ///
     /// # 示例
     ///
@@ -83,21 +110,42 @@ impl SearchView {
     /// ```
     pub fn new(matches: Vec<MatchRange>, focused_index: usize) -> Self {
         // 构建行号索引
-        let mut matches_by_line: HashMap<usize, Vec<usize>> = HashMap::new();
+        let mut spans_by_line: HashMap<usize, Vec<MatchSpan>> = HashMap::new();
 
-        for (idx, m) in matches.iter().enumerate() {
+        for (index, m) in matches.iter().enumerate() {
             // 对于跨多行的匹配，需要在每一行的索引中都添加
             for line in m.start.line..=m.end.line {
-                matches_by_line
-                    .entry(line)
-                    .or_insert_with(Vec::new)
-                    .push(idx);
+                let start_col = if line == m.start.line { m.start.col } else { 0 };
+                let end_col = if line == m.end.line {
+                    m.end.col
+                } else {
+                    usize::MAX
+                };
+                spans_by_line.entry(line).or_default().push(MatchSpan {
+                    start_col,
+                    end_col,
+                    index,
+                });
             }
         }
 
+        // 搜索结果通常已按位置排序，这里保证行内按列有序
+        for spans in spans_by_line.values_mut() {
+            spans.sort_unstable_by_key(|span| (span.start_col, span.index));
+        }
+
         Self {
-            matches,
-            matches_by_line,
+            matches: Arc::new(matches),
+            spans_by_line: Arc::new(spans_by_line),
+            focused_index,
+        }
+    }
+
+    /// 切换焦点，共享匹配和行索引（O(1)，不重建）
+    pub fn with_focus(&self, focused_index: usize) -> Self {
+        Self {
+            matches: self.matches.clone(),
+            spans_by_line: self.spans_by_line.clone(),
             focused_index,
         }
     }
@@ -120,7 +168,7 @@ impl SearchView {
         self.matches.get(self.focused_index)
     }
 
-    /// 获取某行的所有匹配索引
+    /// 获取某行的所有匹配区间
     ///
     /// # 参数
     ///
@@ -128,15 +176,27 @@ impl SearchView {
     ///
     /// # 返回
     ///
-    /// - `Some(&[usize])`: 该行的匹配索引列表（指向 `matches` 中的下标）
+    /// - `Some(&[MatchSpan])`: 该行的匹配区间（按列有序）
     /// - `None`: 该行没有匹配
     ///
     /// # 性能
     ///
     /// O(1) HashMap 查询，比遍历所有匹配快得多。
     #[inline]
-    pub fn get_matches_at_line(&self, line: usize) -> Option<&[usize]> {
-        self.matches_by_line.get(&line).map(|v| v.as_slice())
+    pub fn get_matches_at_line(&self, line: usize) -> Option<&[MatchSpan]> {
+        self.spans_by_line.get(&line).map(|v| v.as_slice())
+    }
+
+    /// 区间是否属于焦点匹配
+    #[inline]
+    pub fn is_focused(&self, span: &MatchSpan) -> bool {
+        span.index == self.focused_index
+    }
+
+    /// 焦点匹配覆盖的行（绝对坐标）
+    #[inline]
+    pub fn focused_lines(&self) -> Option<RangeInclusive<usize>> {
+        self.focused_match().map(|m| m.start.line..=m.end.line)
     }
 }
 
@@ -196,7 +256,7 @@ mod tests {
         assert_eq!(search.match_count(), 2);
         assert!(search.has_matches());
         assert_eq!(search.focused_index, 0);
-        assert_eq!(search.matches, matches);
+        assert_eq!(*search.matches, matches);
     }
 
     /// 测试：验证 MatchRange 基本功能
@@ -287,6 +347,13 @@ mod tests {
         assert_ne!(search1, search3);
     }
 
+    /// 获取某行匹配在 `matches` 中的索引
+    fn indices_at_line(search: &SearchView, line: usize) -> Option<Vec<usize>> {
+        search
+            .get_matches_at_line(line)
+            .map(|spans| spans.iter().map(|span| span.index).collect())
+    }
+
     /// 测试：验证按行索引功能
     #[test]
     fn test_get_matches_at_line() {
@@ -298,37 +365,64 @@ mod tests {
         let search = SearchView::new(matches, 0);
 
         // 第 0 行：有 1 个匹配（索引 0）
-        let line0 = search.get_matches_at_line(0);
-        assert!(line0.is_some());
-        assert_eq!(line0.unwrap(), &[0]);
+        assert_eq!(indices_at_line(&search, 0), Some(vec![0]));
 
         // 第 1 行：没有匹配
-        let line1 = search.get_matches_at_line(1);
-        assert!(line1.is_none());
+        assert!(search.get_matches_at_line(1).is_none());
 
         // 第 2 行：有 1 个匹配（索引 1）
-        let line2 = search.get_matches_at_line(2);
-        assert!(line2.is_some());
-        assert_eq!(line2.unwrap(), &[1]);
+        assert_eq!(indices_at_line(&search, 2), Some(vec![1]));
 
-        // 第 5 行：有 1 个匹配（索引 2，跨行匹配的起始行）
-        let line5 = search.get_matches_at_line(5);
-        assert!(line5.is_some());
-        assert_eq!(line5.unwrap(), &[2]);
+        // 第 5-7 行：跨行匹配（索引 2）的起始行、中间行、结束行
+        assert_eq!(indices_at_line(&search, 5), Some(vec![2]));
+        assert_eq!(indices_at_line(&search, 6), Some(vec![2]));
+        assert_eq!(indices_at_line(&search, 7), Some(vec![2]));
 
-        // 第 6 行：有 1 个匹配（索引 2，跨行匹配的中间行）
-        let line6 = search.get_matches_at_line(6);
-        assert!(line6.is_some());
-        assert_eq!(line6.unwrap(), &[2]);
+        // 第 8 行：没有匹配
+        assert!(search.get_matches_at_line(8).is_none());
+    }
 
-        // 第 7 行：有 1 个匹配（索引 2，跨行匹配的结束行）
-        let line7 = search.get_matches_at_line(7);
-        assert!(line7.is_some());
-        assert_eq!(line7.unwrap(), &[2]);
+    /// 测试：行内列区间（跨行匹配在中间行覆盖整行）
+    #[test]
+    fn test_match_spans() {
+        let matches = vec![
+            MatchRange::new(AbsolutePoint::new(1, 20), AbsolutePoint::new(1, 25)),
+            MatchRange::new(AbsolutePoint::new(1, 2), AbsolutePoint::new(1, 4)),
+            MatchRange::new(AbsolutePoint::new(3, 8), AbsolutePoint::new(5, 2)),
+        ];
+        let search = SearchView::new(matches, 0);
 
-        // 第 8 行：没有匹配
-        let line8 = search.get_matches_at_line(8);
-        assert!(line8.is_none());
+        let line1 = search.get_matches_at_line(1).unwrap();
+        assert_eq!(
+            line1,
+            &[
+                MatchSpan { start_col: 2, end_col: 4, index: 1 },
+                MatchSpan { start_col: 20, end_col: 25, index: 0 },
+            ]
+        );
+        assert!(search.is_focused(&line1[1]));
+        assert!(line1[0].contains(3));
+
+        let span = |line| search.get_matches_at_line(line).unwrap()[0];
+        assert_eq!((span(3).start_col, span(3).end_col), (8, usize::MAX));
+        assert_eq!((span(4).start_col, span(4).end_col), (0, usize::MAX));
+        assert_eq!((span(5).start_col, span(5).end_col), (0, 2));
+    }
+
+    /// 测试：切换焦点共享索引
+    #[test]
+    fn test_with_focus_shares_index() {
+        let matches = vec![
+            MatchRange::new(AbsolutePoint::new(0, 0), AbsolutePoint::new(0, 5)),
+            MatchRange::new(AbsolutePoint::new(4, 0), AbsolutePoint::new(6, 5)),
+        ];
+        let search = SearchView::new(matches, 0);
+        let focused = search.with_focus(1);
+
+        assert!(Arc::ptr_eq(&search.spans_by_line, &focused.spans_by_line));
+        assert!(Arc::ptr_eq(&search.matches, &focused.matches));
+        assert_eq!(search.focused_lines(), Some(0..=0));
+        assert_eq!(focused.focused_lines(), Some(4..=6));
     }
 
     /// 测试：验证按行索引的性能优化
@@ -346,9 +440,7 @@ mod tests {
         let search = SearchView::new(matches, 0);
 
         // 查询第 500 行的匹配（应该是 O(1) 查询，而不是 O(1000) 遍历）
-        let line500 = search.get_matches_at_line(500);
-        assert!(line500.is_some());
-        assert_eq!(line500.unwrap(), &[500]);
+        assert_eq!(indices_at_line(&search, 500), Some(vec![500]));
 
         // 查询不存在的行（应该是 O(1) 查询）
         let line9999 = search.get_matches_at_line(9999);
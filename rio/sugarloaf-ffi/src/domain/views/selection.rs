@@ -8,6 +8,8 @@
 //! 与 rio-backend/selection.rs 的关系：
 //! - rio-backend/Selection: 可变状态，包含复杂的选区操作逻辑
 //! - SelectionView: 只读视图，只包含渲染所需的最小信息
+//!
+//! 渲染时按行换算成列区间（SelectionSpan），整行选中的行不需要逐列判断
 
 use crate::domain::primitives::AbsolutePoint;
 
@@ -80,6 +82,87 @@ impl SelectionView {
     pub fn is_lines(&self) -> bool {
         self.ty == SelectionType::Lines
     }
+
+    /// 按位置排序后的起点和终点（反向拖拽时 start 在 end 之后）
+    #[inline]
+    pub fn ordered(&self) -> (AbsolutePoint, AbsolutePoint) {
+        if (self.start.line, self.start.col) <= (self.end.line, self.end.col) {
+            (self.start, self.end)
+        } else {
+            (self.end, self.start)
+        }
+    }
+
+    /// 选区在 `abs_line` 行覆盖的列区间，不覆盖本行时返回 None
+    ///
+    /// 列区间已按 `columns` 截断，O(1)，不依赖行内容
+    pub fn span_on_line(&self, abs_line: usize, columns: usize) -> Option<SelectionSpan> {
+        let (start, end) = self.ordered();
+        if columns == 0 || abs_line < start.line || abs_line > end.line {
+            return None;
+        }
+
+        let last_col = columns - 1;
+        let (start_col, end_col) = match self.ty {
+            SelectionType::Block => (
+                self.start.col.min(self.end.col),
+                self.start.col.max(self.end.col),
+            ),
+            SelectionType::Lines => (0, last_col),
+            SelectionType::Simple => {
+                let start_col = if abs_line == start.line { start.col } else { 0 };
+                let end_col = if abs_line == end.line {
+                    end.col
+                } else {
+                    last_col
+                };
+                (start_col, end_col)
+            }
+        };
+
+        if start_col > last_col || start_col > end_col {
+            return None;
+        }
+        Some(SelectionSpan {
+            start_col,
+            end_col: end_col.min(last_col),
+        })
+    }
+
+    /// 从 `first_line` 开始连续 `rows` 行的列区间（每帧换算一次，下标为屏幕行）
+    pub fn spans(
+        &self,
+        first_line: usize,
+        rows: usize,
+        columns: usize,
+    ) -> Vec<Option<SelectionSpan>> {
+        (first_line..first_line + rows)
+            .map(|line| self.span_on_line(line, columns))
+            .collect()
+    }
+}
+
+/// 选区在一行上覆盖的列区间（闭区间）
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SelectionSpan {
+    /// 起始列
+    pub start_col: usize,
+    /// 结束列（包含）
+    pub end_col: usize,
+}
+
+impl SelectionSpan {
+    /// 是否覆盖整行
+    #[inline]
+    pub fn is_full_row(&self, columns: usize) -> bool {
+        self.start_col == 0 && self.end_col + 1 >= columns
+    }
+
+    /// 列是否在区间内
+    #[inline]
+    pub fn contains(&self, col: usize) -> bool {
+        self.start_col <= col && col <= self.end_col
+    }
 }
 
 #[cfg(test)]
@@ -144,6 +227,43 @@ mod tests {
         assert_ne!(p1, p3);
     }
 
+    /// 测试：三种选区按行换算成列区间
+    #[test]
+    fn test_span_on_line() {
+        let start = AbsolutePoint::new(2, 5);
+        let end = AbsolutePoint::new(4, 3);
+        let span = |start_col, end_col| Some(SelectionSpan { start_col, end_col });
+
+        let simple = SelectionView::new(start, end, SelectionType::Simple);
+        assert_eq!(simple.span_on_line(1, 10), None);
+        assert_eq!(simple.span_on_line(2, 10), span(5, 9));
+        assert_eq!(simple.span_on_line(3, 10), span(0, 9));
+        assert!(simple.span_on_line(3, 10).unwrap().is_full_row(10));
+        assert_eq!(simple.span_on_line(4, 10), span(0, 3));
+        assert_eq!(simple.span_on_line(5, 10), None);
+
+        // 反向拖拽结果相同
+        let reversed = SelectionView::new(end, start, SelectionType::Simple);
+        assert_eq!(reversed.span_on_line(2, 10), span(5, 9));
+        assert_eq!(reversed.span_on_line(4, 10), span(0, 3));
+
+        let block = SelectionView::new(start, end, SelectionType::Block);
+        assert_eq!(block.span_on_line(3, 10), span(3, 5));
+
+        let lines = SelectionView::new(start, end, SelectionType::Lines);
+        assert_eq!(lines.span_on_line(4, 10), span(0, 9));
+
+        // 超出列数的部分被截断，完全在右侧时不覆盖
+        let wide = SelectionView::new(
+            AbsolutePoint::new(0, 12),
+            AbsolutePoint::new(1, 20),
+            SelectionType::Simple,
+        );
+        assert_eq!(wide.span_on_line(0, 10), None);
+        assert_eq!(wide.span_on_line(1, 10), span(0, 9));
+        assert_eq!(wide.spans(0, 3, 10), vec![None, span(0, 9), None]);
+    }
+
     /// 测试：SelectionView 相等性
     #[test]
     fn test_selection_view_equality() {
@@ -74,6 +74,13 @@ pub extern "C" fn render_scheduler_bind_to_pool(
         let pool = unsafe { &mut *(pool_addr as *mut TerminalPool) };
         pool.render_all();
     });
+
+    // 空闲回调：推进光标闪烁（切换时只重新合成缓存的图像），回收内存
+    scheduler.set_idle_callback(move || {
+        let pool = unsafe { &mut *(pool_addr as *mut TerminalPool) };
+        pool.tick_cursor_blink();
+        pool.reclaim_memory();
+    });
 }
 
 /// 启动 RenderScheduler（启动 CVDisplayLink）
@@ -1,8 +1,12 @@
 //! TerminalPool FFI - 多终端管理 + 统一渲染
 
 use crate::SugarloafFontMetrics;
-use crate::app::ffi::TerminalPoolEventCallback;
+use crate::app::ffi::{
+    HostPasteBuffer, PasteReleaseCallback, TerminalPoolEventCallback,
+    WorkspaceSearchCallback, WorkspaceSearchSink,
+};
 use crate::app::{AppConfig, TerminalPool};
+use rio_backend::event::paste::PasteData;
 use std::ffi::c_void;
 
 /// TerminalPool 句柄（不透明指针）
@@ -440,6 +444,45 @@ pub extern "C" fn terminal_pool_input(
     pool.input(terminal_id, data_slice)
 }
 
+/// 流式粘贴到终端
+///
+/// PTY 线程按块写入 `data`，终端启用 Bracketed Paste Mode 时自动包裹
+/// `\x1b[200~` / `\x1b[201~`，期间的按键等交互输入优先写入。
+///
+/// # 参数
+/// - `release`: 非空时零拷贝，`data` 必须保持有效直到 `release(context)` 被调用
+///   （写完、终端关闭或失败时调用，可能在任意线程）；为空时立即拷贝 `data`
+///
+/// # 返回
+/// - false: 终端不存在（`release` 已被调用）
+#[no_mangle]
+pub extern "C" fn terminal_pool_paste(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+    data: *const u8,
+    len: usize,
+    release: Option<PasteReleaseCallback>,
+    context: *mut c_void,
+) -> bool {
+    if handle.is_null() || (data.is_null() && len > 0) {
+        eprintln!("[FFI] terminal_pool_paste: null handle or data");
+        if let Some(release) = release {
+            release(context);
+        }
+        return false;
+    }
+
+    let data: PasteData = match release {
+        Some(release) => {
+            Box::new(unsafe { HostPasteBuffer::new(data, len, release, context) })
+        }
+        None if len == 0 => Box::new(Vec::new()),
+        None => Box::new(unsafe { std::slice::from_raw_parts(data, len) }.to_vec()),
+    };
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.paste(terminal_id, data)
+}
+
 /// 滚动终端
 #[no_mangle]
 pub extern "C" fn terminal_pool_scroll(
@@ -455,6 +498,73 @@ pub extern "C" fn terminal_pool_scroll(
     pool.scroll(terminal_id, delta)
 }
 
+// ===== 命令块（OSC 133）=====
+
+/// 把上一个（previous = true）或下一个命令提示符滚动到视口顶部
+///
+/// 依赖 shell 的 OSC 133 标记，没有提示符可跳时返回 false
+#[no_mangle]
+pub extern "C" fn terminal_pool_jump_to_prompt(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+    previous: bool,
+) -> bool {
+    if handle.is_null() {
+        return false;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.scroll_to_prompt(terminal_id, previous)
+}
+
+/// 获取最近一条已结束命令的输出
+///
+/// 返回的字符串需要调用者使用 `rio_free_string` 释放，
+/// 没有已结束的命令（或输出已滚出历史缓冲区）时返回 NULL
+#[no_mangle]
+pub extern "C" fn terminal_pool_get_last_command_output(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+) -> *mut std::ffi::c_char {
+    if handle.is_null() {
+        return std::ptr::null_mut();
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    match pool.last_command_output(terminal_id) {
+        Some(output) => match std::ffi::CString::new(output) {
+            Ok(c_str) => c_str.into_raw(),
+            Err(_) => std::ptr::null_mut(),
+        },
+        None => std::ptr::null_mut(),
+    }
+}
+
+/// 导出终端的命令块列表
+///
+/// 返回 JSON 数组，每项包含 index、prompt_row、command、exit_code、running、
+/// duration_ms，`include_output` 为 true 时附带 output。
+/// 需要调用者使用 `rio_free_string` 释放，终端不存在时返回 NULL。
+#[no_mangle]
+pub extern "C" fn terminal_pool_get_command_blocks(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+    include_output: bool,
+) -> *mut std::ffi::c_char {
+    if handle.is_null() {
+        return std::ptr::null_mut();
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    match pool.command_blocks_json(terminal_id, include_output) {
+        Some(json) => match std::ffi::CString::new(json) {
+            Ok(c_str) => c_str.into_raw(),
+            Err(_) => std::ptr::null_mut(),
+        },
+        None => std::ptr::null_mut(),
+    }
+}
+
 // ===== 渲染流程（统一提交）=====
 
 /// 开始新的一帧（清空待渲染列表）
@@ -754,6 +864,75 @@ pub extern "C" fn terminal_pool_clear_search(
     pool.clear_search(terminal_id);
 }
 
+/// 跨终端搜索（异步）
+///
+/// 在 `terminal_ids` 指定的终端（为空或 `terminal_count` 为 0 时搜索所有终端）的
+/// 历史和屏幕中搜索，命中分批通过 `callback` 回调（rayon 工作线程），
+/// 最后一次回调携带结束状态。不影响各终端自己的搜索高亮。
+/// 新的搜索会取消上一次未完成的搜索。
+///
+/// # 参数
+/// - query: 搜索关键词（C 字符串）
+/// - is_regex: 是否按正则表达式解析
+/// - case_sensitive: 是否区分大小写
+/// - max_hits: 所有终端合计的命中上限
+/// - callback / context: 命中回调，`context` 在收到结束状态之前必须有效
+///
+/// # 返回
+/// - 搜索 ID（> 0），失败返回 -1（此时不会回调）
+#[no_mangle]
+pub extern "C" fn terminal_pool_search_all(
+    handle: *mut TerminalPoolHandle,
+    query: *const std::ffi::c_char,
+    is_regex: bool,
+    case_sensitive: bool,
+    terminal_ids: *const usize,
+    terminal_count: usize,
+    max_hits: usize,
+    callback: WorkspaceSearchCallback,
+    context: *mut c_void,
+) -> i64 {
+    if handle.is_null() || query.is_null() {
+        return -1;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+
+    let query_str = match unsafe { std::ffi::CStr::from_ptr(query).to_str() } {
+        Ok(s) => s,
+        Err(_) => return -1,
+    };
+
+    let terminal_ids = if terminal_ids.is_null() || terminal_count == 0 {
+        None
+    } else {
+        Some(unsafe { std::slice::from_raw_parts(terminal_ids, terminal_count) })
+    };
+
+    let sink = unsafe { WorkspaceSearchSink::new(callback, context) };
+    pool.search_all(
+        query_str,
+        is_regex,
+        case_sensitive,
+        terminal_ids,
+        max_hits,
+        sink,
+    )
+}
+
+/// 取消进行中的跨终端搜索
+///
+/// 回调随后会收到 Cancelled 状态
+#[no_mangle]
+pub extern "C" fn terminal_pool_cancel_search_all(handle: *mut TerminalPoolHandle) {
+    if handle.is_null() {
+        return;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.cancel_search_all();
+}
+
 // ===== 渲染布局（新架构） =====
 
 /// 渲染布局信息
@@ -820,6 +999,215 @@ pub extern "C" fn terminal_pool_render_all(handle: *mut TerminalPoolHandle) {
     pool.render_all();
 }
 
+/// 设置光标闪烁
+///
+/// 闪烁由 RenderScheduler 的空闲 VSync 推进，亮灭切换只重新合成缓存的图像，
+/// 不重新渲染终端。
+///
+/// # 参数
+/// - handle: TerminalPool 句柄
+/// - terminal_id: 闪烁的终端（通常是焦点终端），负数关闭闪烁
+/// - interval_ms: 亮灭切换间隔（毫秒），0 关闭闪烁
+#[no_mangle]
+pub extern "C" fn terminal_pool_set_cursor_blink(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: i64,
+    interval_ms: u32,
+) {
+    if handle.is_null() {
+        return;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    let terminal_id = usize::try_from(terminal_id).ok();
+    pool.set_cursor_blink(
+        terminal_id,
+        std::time::Duration::from_millis(interval_ms as u64),
+    );
+}
+
+// ===== 终端休眠 / 内存统计 =====
+
+/// 设置休眠时长
+///
+/// 终端离开渲染布局超过这个时长后休眠：释放渲染缓存，历史行压缩存储，
+/// 重新显示时自动恢复。默认 600 秒。
+///
+/// # 参数
+/// - handle: TerminalPool 句柄
+/// - seconds: 休眠时长（秒），0 关闭自动休眠
+#[no_mangle]
+pub extern "C" fn terminal_pool_set_hibernate_after(
+    handle: *mut TerminalPoolHandle,
+    seconds: u32,
+) {
+    if handle.is_null() {
+        return;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.set_hibernate_after(seconds as u64);
+}
+
+/// 立即休眠终端
+///
+/// # 返回
+/// - 释放的内存（字节）
+/// - -1: 终端不存在、已在休眠、正忙或没有可释放的内存
+#[no_mangle]
+pub extern "C" fn terminal_pool_hibernate_terminal(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+) -> i64 {
+    if handle.is_null() {
+        return -1;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.hibernate_terminal(terminal_id)
+        .map_or(-1, |bytes| bytes as i64)
+}
+
+/// 获取休眠释放的内存
+///
+/// # 返回
+/// - 终端上次休眠释放的内存（字节）
+/// - -1: 终端不存在或未休眠
+#[no_mangle]
+pub extern "C" fn terminal_pool_get_hibernated_bytes(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+) -> i64 {
+    if handle.is_null() {
+        return -1;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.hibernated_bytes(terminal_id)
+        .map_or(-1, |bytes| bytes as i64)
+}
+
+/// 设置内存预算
+///
+/// 所有终端加上行缓存超出预算时，按代价从低到高回收：收缩历史的空闲容量、
+/// 丢弃不可见终端的渲染缓存和行缓存、休眠不可见终端（离开布局最久的优先）。
+/// 回收不会丢弃终端内容，可见终端本身超出预算时只记录警告。
+///
+/// # 参数
+/// - handle: TerminalPool 句柄
+/// - bytes: 预算（字节），0 不限制
+#[no_mangle]
+pub extern "C" fn terminal_pool_set_memory_budget(
+    handle: *mut TerminalPoolHandle,
+    bytes: u64,
+) {
+    if handle.is_null() {
+        return;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    pool.set_memory_budget(bytes);
+}
+
+/// 终端内存统计（字节，估算）
+#[repr(C)]
+pub struct TerminalMemoryStats {
+    /// 屏幕行（主屏 + 备用屏）+ 渲染用的网格快照
+    pub grid: u64,
+    /// 历史行（含休眠时的压缩历史）
+    pub scrollback: u64,
+    /// 日志缓冲区
+    pub log_buffer: u64,
+    /// 渲染缓存（Surface/Image、光标补丁）
+    pub surfaces: u64,
+    /// 还没交给渲染器的图像数据
+    pub graphics: u64,
+    /// 合计
+    pub total: u64,
+    /// 是否有效
+    pub valid: bool,
+}
+
+/// 获取终端的内存统计
+///
+/// 会遍历终端的所有历史行，适合按需查询，不要每帧调用。
+/// 行缓存按内容在终端间共享，见 `terminal_pool_get_pool_memory_stats`。
+#[no_mangle]
+pub extern "C" fn terminal_pool_get_memory_stats(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+) -> TerminalMemoryStats {
+    let invalid = TerminalMemoryStats {
+        grid: 0,
+        scrollback: 0,
+        log_buffer: 0,
+        surfaces: 0,
+        graphics: 0,
+        total: 0,
+        valid: false,
+    };
+
+    if handle.is_null() {
+        return invalid;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+
+    match pool.memory_stats(terminal_id) {
+        Some((usage, surfaces)) => TerminalMemoryStats {
+            grid: usage.grid as u64,
+            scrollback: usage.scrollback as u64,
+            log_buffer: usage.log_buffer as u64,
+            surfaces: surfaces as u64,
+            graphics: usage.graphics as u64,
+            total: (usage.total() + surfaces) as u64,
+            valid: true,
+        },
+        None => invalid,
+    }
+}
+
+/// 池内存统计（字节，估算）
+#[repr(C)]
+pub struct PoolMemoryStats {
+    /// 所有终端合计
+    pub terminals: u64,
+    /// 行缓存（所有终端共享）
+    pub line_cache: u64,
+    /// 合计
+    pub total: u64,
+    /// 内存预算（0 = 不限制）
+    pub budget: u64,
+    /// 是否有效
+    pub valid: bool,
+}
+
+/// 获取池的内存统计
+#[no_mangle]
+pub extern "C" fn terminal_pool_get_pool_memory_stats(
+    handle: *mut TerminalPoolHandle,
+) -> PoolMemoryStats {
+    if handle.is_null() {
+        return PoolMemoryStats {
+            terminals: 0,
+            line_cache: 0,
+            total: 0,
+            budget: 0,
+            valid: false,
+        };
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+    let (terminals, line_cache, budget) = pool.pool_memory_stats();
+    PoolMemoryStats {
+        terminals: terminals as u64,
+        line_cache: line_cache as u64,
+        total: (terminals + line_cache) as u64,
+        budget: budget as u64,
+        valid: true,
+    }
+}
+
 // ===== 终端模式管理 =====
 
 /// 设置终端运行模式
@@ -941,6 +1329,60 @@ pub extern "C" fn terminal_pool_get_scroll_info(
     }
 }
 
+/// Synchronized Update (mode 2026) 统计（无锁读取）
+#[repr(C)]
+pub struct SyncUpdateStats {
+    /// 开始的 sync 次数
+    pub started: u64,
+    /// 正常结束（收到 ESU）的次数
+    pub completed: u64,
+    /// 超时中止的次数
+    pub timed_out: u64,
+    /// 缓冲区溢出中止的次数
+    pub overflowed: u64,
+    /// 当前是否在 sync 中
+    pub syncing: bool,
+    /// 是否有效
+    pub valid: bool,
+}
+
+/// 获取终端的 Synchronized Update 统计（无锁）
+///
+/// timed_out / overflowed 持续增长说明 TUI 超出了 sync 的时间或缓冲上限，
+/// 这些帧会在 sync 中途被强制刷新。
+#[no_mangle]
+pub extern "C" fn terminal_pool_get_sync_stats(
+    handle: *mut TerminalPoolHandle,
+    terminal_id: usize,
+) -> SyncUpdateStats {
+    let invalid = SyncUpdateStats {
+        started: 0,
+        completed: 0,
+        timed_out: 0,
+        overflowed: 0,
+        syncing: false,
+        valid: false,
+    };
+
+    if handle.is_null() {
+        return invalid;
+    }
+
+    let pool = unsafe { &*(handle as *const TerminalPool) };
+
+    match pool.get_sync_stats(terminal_id) {
+        Some((stats, syncing)) => SyncUpdateStats {
+            started: stats.started,
+            completed: stats.completed,
+            timed_out: stats.timed_out,
+            overflowed: stats.overflowed,
+            syncing,
+            valid: true,
+        },
+        None => invalid,
+    }
+}
+
 // ============================================================================
 // 终端迁移 API（跨窗口移动）
 // ============================================================================
@@ -1087,25 +1529,13 @@ pub extern "C" fn terminal_pool_get_visible_lines(
 
     // 使用 with_terminal 替代已弃用的 get_terminal
     let result = pool.with_terminal(terminal_id as usize, |terminal| {
-        // 获取可见区域的行数
-        let visible_rows = terminal.rows();
-        let mut lines: Vec<*const std::ffi::c_char> = Vec::with_capacity(visible_rows);
-
-        // 遍历可见区域的每一行，提取文本
-        for row in 0..visible_rows {
-            // 使用 text_in_range 获取整行文本
-            let line_text = if let Some(text) = terminal.text_in_range(
-                row as i32,
-                0,
-                row as i32,
-                u32::MAX, // 获取到行尾
-            ) {
-                // 去除尾部空白
-                text.trim_end().to_string()
-            } else {
-                String::new()
-            };
+        // 行文本来自行缓存（已去除尾部空白）
+        let visible_lines = terminal.visible_lines_text();
+        let count = visible_lines.len();
+        // 容量必须等于行数，terminal_pool_free_string_array 按 count 释放
+        let mut lines: Vec<*const std::ffi::c_char> = Vec::with_capacity(count);
 
+        for line_text in visible_lines {
             // 转换为 C 字符串
             let c_string = match std::ffi::CString::new(line_text) {
                 Ok(s) => s,
@@ -1116,7 +1546,7 @@ pub extern "C" fn terminal_pool_get_visible_lines(
         }
 
         // 返回 (lines, count)
-        (lines, visible_rows)
+        (lines, count)
     });
 
     let (mut lines, count) = match result {
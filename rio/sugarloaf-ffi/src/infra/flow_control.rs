@@ -0,0 +1,371 @@
+//! Flow Control - PTY 输出洪泛检测与读取限速
+//!
+//! 职责：
+//! - 检测：按 `WINDOW` 统计持锁解析的耗时。连续 `ENTER_WINDOWS` 个窗口解析占满
+//!   `ENTER_PARSE_SHARE` 以上，并且终端锁有争用（try_write 失败，渲染线程等在读），
+//!   进入洪泛模式
+//! - 限速：洪泛模式下每个 `SLICE` 最多读取 `PARSE_SHARE` 个时间片能解析完的字节数
+//!   （按实测解析速度换算），其余数据留在内核 PTY 缓冲区，缓冲区写满后输出进程的
+//!   write 会阻塞，形成背压
+//! - 退出：窗口内没有锁争用，或读空了内核缓冲区（生产者没有积压），或进程空闲
+//!
+//! 没有人和它抢锁的单个繁忙终端不限速，大文件 `cat`、构建日志仍按解析速度跑满；
+//! 限速时吞吐量也只降到解析速度的 `PARSE_SHARE`，而不是固定的字节数。
+//!
+//! 限速同时减少了持锁解析和 Wakeup 的次数：每个时间片只有一批解析、一次重绘，
+//! alt screen 程序的中间帧在同一批里被覆盖，不会逐帧渲染。
+//! 解析本身不降级，所有字节仍然经过 parser，终端状态保持精确。
+
+use std::time::{Duration, Instant};
+
+/// 统计窗口长度
+const WINDOW: Duration = Duration::from_millis(100);
+
+/// 解析占窗口的比例达到该值算超标（基本一直持锁解析）
+const ENTER_PARSE_SHARE: f64 = 0.75;
+
+/// 连续超标多少个窗口才算持续洪泛（短暂的大输出如 `cat` 小文件不受影响）
+const ENTER_WINDOWS: u32 = 3;
+
+/// 洪泛模式下的读取时间片（约一帧）
+const SLICE: Duration = Duration::from_millis(16);
+
+/// 洪泛模式下解析最多占用时间片的比例，剩下的时间终端锁留给渲染
+const PARSE_SHARE: f64 = 0.5;
+
+/// 每个时间片至少允许读取的字节数（解析速度还没测出来时也用它）
+const MIN_SLICE_BUDGET: usize = 64 * 1024;
+
+/// 少于该字节数的读取不参与解析速度估计（耗时太短，误差大）
+const MIN_RATE_SAMPLE: usize = 4 * 1024;
+
+/// 一次 `pty_read` 的统计
+#[derive(Debug, Default, Clone, Copy)]
+pub struct ReadReport {
+    /// 读取并解析的字节数
+    pub bytes: usize,
+    /// 持锁解析的耗时
+    pub parse_time: Duration,
+    /// 获取终端锁时 try_write 失败过（渲染线程等正在持锁）
+    pub contended: bool,
+    /// 读到了 WouldBlock，内核缓冲区已读空（生产者没有积压）
+    pub drained: bool,
+}
+
+/// PTY 输出流控状态，由 Machine 的 PTY 线程独占
+#[derive(Debug)]
+pub struct FlowControl {
+    window_start: Instant,
+    window_parse: Duration,
+    window_contended: bool,
+    window_drained: bool,
+    /// 连续超标的窗口数
+    hot_windows: u32,
+    flooding: bool,
+    slice_start: Instant,
+    slice_bytes: usize,
+    /// 实测解析速度（字节/秒，指数平滑），0 表示还没有样本
+    parse_rate: f64,
+}
+
+impl FlowControl {
+    pub fn new(now: Instant) -> Self {
+        Self {
+            window_start: now,
+            window_parse: Duration::ZERO,
+            window_contended: false,
+            window_drained: false,
+            hot_windows: 0,
+            flooding: false,
+            slice_start: now,
+            slice_bytes: 0,
+            parse_rate: 0.0,
+        }
+    }
+
+    /// 是否处于洪泛模式
+    #[inline]
+    pub fn is_flooding(&self) -> bool {
+        self.flooding
+    }
+
+    /// 记录一次读取，返回洪泛状态是否发生了变化
+    pub fn record(&mut self, read: ReadReport, now: Instant) -> bool {
+        let was_flooding = self.flooding;
+        self.roll_window(now);
+        self.window_parse += read.parse_time;
+        self.window_contended |= read.contended;
+        self.window_drained |= read.drained;
+        self.sample_parse_rate(&read);
+        if self.flooding {
+            self.roll_slice(now);
+            self.slice_bytes += read.bytes;
+        }
+        self.flooding != was_flooding
+    }
+
+    /// 本次最多可读的字节数，非洪泛模式不限制，返回 0 表示本时间片配额已用完
+    pub fn read_budget(&mut self, now: Instant) -> usize {
+        self.roll_window(now);
+        if !self.flooding {
+            return usize::MAX;
+        }
+        self.roll_slice(now);
+        self.slice_budget().saturating_sub(self.slice_bytes)
+    }
+
+    /// 配额用完时距下一个时间片的等待时间，未限速时返回 None
+    pub fn throttle_delay(&self, now: Instant) -> Option<Duration> {
+        if !self.flooding || self.slice_bytes < self.slice_budget() {
+            return None;
+        }
+        let resume = self.slice_start + SLICE;
+        (resume > now).then(|| resume - now)
+    }
+
+    /// 每个时间片的读取配额：`PARSE_SHARE` 个时间片能解析完的字节数
+    fn slice_budget(&self) -> usize {
+        let budget = self.parse_rate * SLICE.as_secs_f64() * PARSE_SHARE;
+        (budget as usize).max(MIN_SLICE_BUDGET)
+    }
+
+    fn sample_parse_rate(&mut self, read: &ReadReport) {
+        if read.bytes < MIN_RATE_SAMPLE || read.parse_time.is_zero() {
+            return;
+        }
+        let sample = read.bytes as f64 / read.parse_time.as_secs_f64();
+        self.parse_rate = if self.parse_rate == 0.0 {
+            sample
+        } else {
+            self.parse_rate * 0.75 + sample * 0.25
+        };
+    }
+
+    /// 结束已过去的统计窗口并更新洪泛状态
+    fn roll_window(&mut self, now: Instant) {
+        let elapsed = now.saturating_duration_since(self.window_start);
+        if elapsed < WINDOW {
+            return;
+        }
+
+        // 中间整窗没有读取（进程空闲），视为冷窗口
+        let idle = elapsed >= WINDOW * 2;
+        if self.flooding {
+            // 没人抢锁就不必再限速；读空了缓冲区说明生产者已经跟不上解析
+            if idle || !self.window_contended || self.window_drained {
+                self.flooding = false;
+                self.hot_windows = 0;
+            }
+        } else if !idle
+            && self.window_contended
+            && self.window_parse >= WINDOW.mul_f64(ENTER_PARSE_SHARE)
+        {
+            self.hot_windows += 1;
+            if self.hot_windows >= ENTER_WINDOWS {
+                self.flooding = true;
+                self.slice_start = now;
+                self.slice_bytes = 0;
+            }
+        } else {
+            self.hot_windows = 0;
+        }
+
+        self.window_start = now;
+        self.window_parse = Duration::ZERO;
+        self.window_contended = false;
+        self.window_drained = false;
+    }
+
+    fn roll_slice(&mut self, now: Instant) {
+        if now.saturating_duration_since(self.slice_start) >= SLICE {
+            self.slice_start = now;
+            self.slice_bytes = 0;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// 模拟的解析速度（64MB/s）
+    const PARSER_RATE: f64 = 64.0 * 1024.0 * 1024.0;
+
+    /// 生产者一直写满，每次读取都读不空
+    const SATURATED: usize = usize::MAX;
+
+    /// 模拟 PTY 线程：每 `step` 读一次，生产者每次最多给出 `bytes`，
+    /// `contended` 表示渲染线程是否在抢终端锁。返回读到的总字节数
+    fn feed(
+        flow: &mut FlowControl,
+        now: &mut Instant,
+        bytes: usize,
+        contended: bool,
+        step: Duration,
+        duration: Duration,
+    ) -> usize {
+        let end = *now + duration;
+        let mut total = 0;
+        while *now < end {
+            let budget = flow.read_budget(*now);
+            // 不限速时一次最多读 64KB（MAX_LOCKED_READ）
+            let read = bytes.min(budget).min(64 * 1024);
+            flow.record(
+                ReadReport {
+                    bytes: read,
+                    parse_time: Duration::from_secs_f64(read as f64 / PARSER_RATE),
+                    contended: contended && read > 0,
+                    drained: bytes < budget.min(64 * 1024),
+                },
+                *now,
+            );
+            total += read;
+            *now += step;
+        }
+        total
+    }
+
+    /// 让终端在有锁争用的情况下进入洪泛模式
+    fn flood(flow: &mut FlowControl, now: &mut Instant) {
+        feed(
+            flow,
+            now,
+            SATURATED,
+            true,
+            Duration::from_millis(1),
+            Duration::from_millis(400),
+        );
+        assert!(flow.is_flooding());
+    }
+
+    #[test]
+    fn test_short_burst_does_not_flood() {
+        let mut now = Instant::now();
+        let mut flow = FlowControl::new(now);
+
+        // 一次性的大输出，只占一个窗口
+        feed(
+            &mut flow,
+            &mut now,
+            SATURATED,
+            true,
+            Duration::from_millis(1),
+            Duration::from_millis(100),
+        );
+        feed(
+            &mut flow,
+            &mut now,
+            0,
+            false,
+            Duration::from_millis(50),
+            Duration::from_millis(500),
+        );
+        assert!(!flow.is_flooding());
+        assert_eq!(flow.read_budget(now), usize::MAX);
+    }
+
+    #[test]
+    fn test_busy_terminal_without_contention_is_not_throttled() {
+        let mut now = Instant::now();
+        let mut flow = FlowControl::new(now);
+
+        // 没人抢锁，按解析速度一直读
+        let total = feed(
+            &mut flow,
+            &mut now,
+            SATURATED,
+            false,
+            Duration::from_millis(1),
+            Duration::from_secs(1),
+        );
+        assert!(!flow.is_flooding());
+        assert_eq!(total, 1000 * 64 * 1024);
+    }
+
+    #[test]
+    fn test_sustained_output_is_throttled() {
+        let mut now = Instant::now();
+        let mut flow = FlowControl::new(now);
+        flood(&mut flow, &mut now);
+
+        // 配额按解析速度换算，解析只占时间片的一半
+        let expected = PARSER_RATE * SLICE.as_secs_f64() * PARSE_SHARE;
+        assert!((flow.slice_budget() as f64 - expected).abs() < expected * 0.01);
+
+        // 配额用完后需要等到下一个时间片
+        let budget = flow.read_budget(now);
+        flow.record(
+            ReadReport {
+                bytes: budget,
+                parse_time: Duration::from_secs_f64(budget as f64 / PARSER_RATE),
+                contended: true,
+                drained: false,
+            },
+            now,
+        );
+        assert_eq!(flow.read_budget(now), 0);
+        let delay = flow.throttle_delay(now).unwrap();
+        assert!(delay > Duration::ZERO && delay <= SLICE);
+        assert_eq!(flow.read_budget(now + delay), flow.slice_budget());
+
+        // 一直有争用时保持限速，吞吐量约为解析速度的一半
+        let total = feed(
+            &mut flow,
+            &mut now,
+            SATURATED,
+            true,
+            Duration::from_millis(1),
+            Duration::from_secs(1),
+        );
+        assert!(flow.is_flooding());
+        let rate = total as f64 / PARSER_RATE;
+        assert!(
+            rate > 0.4 && rate < 0.6,
+            "throttled to {rate} of parser speed"
+        );
+    }
+
+    #[test]
+    fn test_capped_reader_leaves_flood_when_contention_ends() {
+        let mut now = Instant::now();
+        let mut flow = FlowControl::new(now);
+        flood(&mut flow, &mut now);
+
+        // 生产者仍然写满，但已经没人抢锁
+        feed(
+            &mut flow,
+            &mut now,
+            SATURATED,
+            false,
+            Duration::from_millis(1),
+            Duration::from_millis(300),
+        );
+        assert!(!flow.is_flooding());
+        assert_eq!(flow.read_budget(now), usize::MAX);
+    }
+
+    #[test]
+    fn test_flood_ends_when_output_stops() {
+        let mut now = Instant::now();
+        let mut flow = FlowControl::new(now);
+        flood(&mut flow, &mut now);
+
+        // 输出降到交互水平，每次都能读空缓冲区
+        feed(
+            &mut flow,
+            &mut now,
+            100,
+            true,
+            Duration::from_millis(10),
+            Duration::from_millis(300),
+        );
+        assert!(!flow.is_flooding());
+        assert_eq!(flow.throttle_delay(now), None);
+
+        // 长时间空闲后第一次读取也立即退出
+        let mut flow2 = FlowControl::new(now);
+        flood(&mut flow2, &mut now);
+        now += Duration::from_secs(5);
+        assert_eq!(flow2.read_budget(now), usize::MAX);
+    }
+}
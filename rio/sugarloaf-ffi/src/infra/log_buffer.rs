@@ -329,6 +329,33 @@ impl LogBuffer {
         self.len() == 0
     }
 
+    /// Estimated heap bytes held by the stored lines
+    pub fn heap_size(&self) -> usize {
+        let lines = self.lines.read().unwrap();
+        let text: usize = lines.iter().map(|line| line.text.capacity()).sum();
+        lines.capacity() * std::mem::size_of::<LogLine>()
+            + text
+            + self.current_line.read().unwrap().capacity()
+    }
+
+    /// Release spare capacity left behind by `clear` or a burst of long lines
+    ///
+    /// Returns the number of heap bytes released.
+    pub fn shrink_to_fit(&self) -> usize {
+        let before = self.heap_size();
+        {
+            let mut lines = self.lines.write().unwrap();
+            // Keep room for one more line: a full buffer pushes before it pops
+            let keep = lines.len() + 1;
+            lines.shrink_to(keep);
+            for line in lines.iter_mut() {
+                line.text.shrink_to_fit();
+            }
+        }
+        self.current_line.write().unwrap().shrink_to_fit();
+        before.saturating_sub(self.heap_size())
+    }
+
     // --- Private ---
 
     fn commit_line(
@@ -483,6 +510,24 @@ mod tests {
         assert_eq!(lines[2].text, "line5");
     }
 
+    #[test]
+    fn test_shrink_to_fit_after_clear() {
+        let buffer = LogBuffer::new(10_000);
+        for i in 0..5_000 {
+            buffer.append(format!("line {}\n", i).as_bytes());
+        }
+        let full = buffer.heap_size();
+        assert!(full > 5_000 * "line 0".len());
+
+        buffer.clear();
+        assert!(buffer.shrink_to_fit() > 0);
+        assert!(buffer.heap_size() < full / 10);
+
+        // Still usable after shrinking
+        buffer.append(b"after\n");
+        assert_eq!(buffer.tail(1)[0].text, "after");
+    }
+
     #[test]
     fn test_strip_ansi_colors() {
         let buffer = LogBuffer::new(100);
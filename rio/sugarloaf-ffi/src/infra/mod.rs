@@ -6,12 +6,17 @@
 //! - spsc_queue: 无锁单生产者单消费者队列
 //! - atomic_cache: 原子缓存（光标位置、脏标记等）
 //! - log_buffer: 终端输出日志缓冲（可选功能）
+//! - pty_recording: PTY 原始字节流录制 / 回放（可选功能）
+//! - flow_control: PTY 输出洪泛检测与读取限速
 //! - stress_tests: 压力测试（仅测试构建）
+//! - replay_bench: 真实 PTY 录制回放性能测试（仅测试构建）
 
 pub mod spsc_queue;
 pub mod atomic_cache;
 pub mod selection_overlay;
 pub mod log_buffer;
+pub mod pty_recording;
+pub mod flow_control;
 
 #[cfg(test)]
 mod stress_tests;
@@ -19,6 +24,9 @@ mod stress_tests;
 #[cfg(test)]
 mod pipeline_bench;
 
+#[cfg(test)]
+mod replay_bench;
+
 pub use spsc_queue::SpscQueue;
 pub use atomic_cache::{
     AtomicCursorCache,
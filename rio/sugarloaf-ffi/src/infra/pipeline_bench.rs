@@ -376,6 +376,115 @@ mod tests {
         println!("   Image size:  {}x{}", img1.width(), img1.height());
     }
 
+    #[test]
+    fn bench_idle_cursor_blink_16_panes() {
+        use crate::app::cursor_blink::{render_cursor_patch, CursorBlink};
+        use rio_backend::ansi::CursorShape;
+        use skia_safe::{surfaces, Color};
+        use std::time::Duration;
+
+        println!("\n🔬 [Idle Cursor Blink] 16 个分屏空闲时的光标闪烁开销\n");
+
+        const PANES: usize = 16;
+        const COLS: usize = 80;
+        const ROWS: usize = 24;
+        const TICKS: u32 = 200;
+
+        let mut renderer = create_test_renderer();
+        let metrics = renderer.get_font_metrics();
+        let cell_width = metrics.cell_width.value;
+        let line_height = metrics.cell_height.value;
+        let pane_width = (COLS as f32 * cell_width).ceil() as i32;
+        let pane_height = (ROWS as f32 * line_height).ceil() as i32;
+
+        let terminals: Vec<_> = (0..PANES)
+            .map(|i| {
+                let mut terminal = Terminal::new_for_test(TerminalId(i), COLS, ROWS);
+                for line in 0..ROWS - 1 {
+                    terminal.write(format!("pane {} line {}: \x1b[32mok\x1b[0m some output\r\n", i, line).as_bytes());
+                }
+                terminal.write(b"$ ");
+                terminal
+            })
+            .collect();
+
+        // 缓存的终端图像（相当于 TerminalRenderCache）
+        let pane_images: Vec<_> = terminals
+            .iter()
+            .map(|terminal| {
+                let state = terminal.state();
+                let mut surface = surfaces::raster_n32_premul((pane_width, pane_height)).unwrap();
+                for line in 0..ROWS {
+                    let image = renderer.render_line(line, &state, None);
+                    surface.canvas().draw_image(&image, (0.0, line as f32 * line_height), None);
+                }
+                surface.image_snapshot()
+            })
+            .collect();
+        let mut frame = surfaces::raster_n32_premul((pane_width * 4, pane_height * 4)).unwrap();
+        let composite = |frame: &mut skia_safe::Surface| {
+            let canvas = frame.canvas();
+            canvas.clear(Color::TRANSPARENT);
+            for (i, image) in pane_images.iter().enumerate() {
+                let x = (i % 4) as f32 * pane_width as f32;
+                let y = (i / 4) as f32 * pane_height as f32;
+                canvas.draw_image(image, (x, y), None);
+            }
+        };
+
+        // 旧路径：每次亮灭切换都 render_all，每个分屏重新取快照、渲染所有行再合成
+        let t1 = Instant::now();
+        for tick in 0..TICKS {
+            for terminal in &terminals {
+                let mut state = terminal.state();
+                if tick % 2 == 0 {
+                    state.cursor.shape = CursorShape::Hidden;
+                }
+                let mut surface = surfaces::raster_n32_premul((pane_width, pane_height)).unwrap();
+                for line in 0..ROWS {
+                    let image = renderer.render_line(line, &state, None);
+                    surface.canvas().draw_image(&image, (0.0, line as f32 * line_height), None);
+                }
+            }
+            composite(&mut frame);
+        }
+        let full = t1.elapsed() / TICKS;
+
+        // 新路径：闪烁时钟切换，只合成缓存图像 + 焦点终端的光标补丁
+        let state = terminals[0].state();
+        let patch = render_cursor_patch(&mut renderer, &state, ROWS, cell_width, line_height).unwrap();
+        let blink = CursorBlink::new();
+        let start = Instant::now();
+        blink.configure(Some(0), Duration::from_millis(500), start);
+        // 终端光标设置为闪烁（DECSCUSR / DECSET 12）
+        blink.set_blinking(true);
+        let t2 = Instant::now();
+        for tick in 1..=TICKS {
+            assert!(blink.tick(start + Duration::from_millis(500) * tick));
+            composite(&mut frame);
+            if blink.is_cursor_hidden() {
+                frame.canvas().draw_image(&patch.image, (patch.x, patch.y), None);
+            }
+        }
+        let overlay = t2.elapsed() / TICKS;
+
+        // 空闲 VSync（没有切换）只读一次原子变量
+        let t3 = Instant::now();
+        for _ in 0..TICKS {
+            assert!(!blink.tick(start + Duration::from_millis(500) * TICKS + Duration::from_millis(1)));
+        }
+        let idle = t3.elapsed() / TICKS;
+
+        println!("每次亮灭切换:");
+        println!("   全量重渲染 ({} 个分屏): {:>10?}", PANES, full);
+        println!("   光标补丁叠加:          {:>10?}", overlay);
+        println!("   空闲 VSync tick:       {:>10?}", idle);
+        println!("   加速比:                {:>10.1}x", full.as_nanos() as f64 / overlay.as_nanos() as f64);
+        println!("\n📊 2 次切换/秒时的 CPU 占用:");
+        println!("   全量重渲染: {:.3}%", full.as_secs_f64() * 2.0 * 100.0);
+        println!("   补丁叠加:   {:.3}%", overlay.as_secs_f64() * 2.0 * 100.0);
+    }
+
     #[test]
     fn bench_large_terminal_100x200() {
         println!("\n🔬 [Large Terminal 100×200] 大终端渲染测试\n");
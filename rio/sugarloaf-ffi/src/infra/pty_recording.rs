@@ -0,0 +1,226 @@
+//! PTY Recording - PTY 原始字节流录制 / 回放
+//!
+//! 职责：
+//! - 录制：Machine 在 pty_read 中把读到的原始字节连同时间间隔写入 .ptyrec 文件
+//! - 回放：解析 .ptyrec，供基准测试按原始分块回放（解析 + Grid 写入 + RenderState 同步）
+//!
+//! 文件格式（整数均为小端）：
+//! ```text
+//! b"PTYREC01" | cols: u16 | rows: u16 | { delay_us: u32 | len: u32 | bytes }*
+//! ```
+//! `delay_us` 是距上一块的时间间隔。`benches/captures/record.py` 写出同样的格式，
+//! 用于在应用外录制语料。
+//!
+//! 启用录制：设置环境变量 `ETERM_PTY_RECORD_DIR=<目录>`，每个终端生成一个
+//! `terminal-<route_id>-<unix 秒>.ptyrec` 文件。
+
+use std::fs::File;
+use std::io::{self, BufWriter, Write};
+use std::path::{Path, PathBuf};
+use std::time::{Duration, Instant};
+
+/// 文件头魔数
+const MAGIC: &[u8; 8] = b"PTYREC01";
+
+/// 文件头长度（魔数 + cols + rows）
+const HEADER_LEN: usize = MAGIC.len() + 4;
+
+/// 启用录制的环境变量
+pub const RECORD_DIR_ENV: &str = "ETERM_PTY_RECORD_DIR";
+
+/// PTY 字节流录制器
+pub struct PtyRecorder {
+    writer: BufWriter<File>,
+    last: Instant,
+    path: PathBuf,
+}
+
+impl PtyRecorder {
+    /// 创建录制文件并写入文件头
+    pub fn create(path: impl AsRef<Path>, cols: u16, rows: u16) -> io::Result<Self> {
+        let path = path.as_ref().to_path_buf();
+        let mut writer = BufWriter::new(File::create(&path)?);
+        writer.write_all(MAGIC)?;
+        writer.write_all(&cols.to_le_bytes())?;
+        writer.write_all(&rows.to_le_bytes())?;
+
+        Ok(Self {
+            writer,
+            last: Instant::now(),
+            path,
+        })
+    }
+
+    /// 根据 `ETERM_PTY_RECORD_DIR` 创建录制器（未设置或创建失败时返回 None）
+    pub fn from_env(route_id: usize, cols: u16, rows: u16) -> Option<Self> {
+        let dir = std::env::var_os(RECORD_DIR_ENV)?;
+        let secs = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .map(|d| d.as_secs())
+            .unwrap_or(0);
+        let path = Path::new(&dir).join(format!("terminal-{}-{}.ptyrec", route_id, secs));
+
+        match Self::create(&path, cols, rows) {
+            Ok(recorder) => {
+                crate::rust_log_info!("[PtyRecorder] recording to {}", path.display());
+                Some(recorder)
+            }
+            Err(e) => {
+                crate::rust_log_warn!(
+                    "[PtyRecorder] failed to create {}: {}",
+                    path.display(),
+                    e
+                );
+                None
+            }
+        }
+    }
+
+    /// 录制一块 PTY 输出
+    pub fn record(&mut self, bytes: &[u8]) -> io::Result<()> {
+        if bytes.is_empty() {
+            return Ok(());
+        }
+
+        let now = Instant::now();
+        let delay_us = now
+            .duration_since(self.last)
+            .as_micros()
+            .min(u32::MAX as u128) as u32;
+        self.last = now;
+
+        // 单块超过 u32 的情况不存在（READ_BUFFER_SIZE = 1MB），这里仍然拆分保证格式正确
+        for (i, chunk) in bytes.chunks(u32::MAX as usize).enumerate() {
+            let delay = if i == 0 { delay_us } else { 0 };
+            self.writer.write_all(&delay.to_le_bytes())?;
+            self.writer.write_all(&(chunk.len() as u32).to_le_bytes())?;
+            self.writer.write_all(chunk)?;
+        }
+        Ok(())
+    }
+
+    /// 刷新到磁盘
+    pub fn flush(&mut self) -> io::Result<()> {
+        self.writer.flush()
+    }
+
+    /// 录制文件路径
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+}
+
+/// 录制中的一块数据
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct RecordedChunk {
+    /// 距上一块的时间间隔
+    pub delay: Duration,
+    /// 原始 PTY 字节
+    pub bytes: Vec<u8>,
+}
+
+/// 已解析的录制文件
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct PtyRecording {
+    pub cols: u16,
+    pub rows: u16,
+    pub chunks: Vec<RecordedChunk>,
+}
+
+impl PtyRecording {
+    /// 从文件加载
+    pub fn load(path: impl AsRef<Path>) -> io::Result<Self> {
+        Self::parse(&std::fs::read(path)?)
+    }
+
+    /// 解析录制数据
+    ///
+    /// 末尾被截断的块（录制进程被中断）会被丢弃
+    pub fn parse(data: &[u8]) -> io::Result<Self> {
+        if data.len() < HEADER_LEN || &data[..MAGIC.len()] != MAGIC {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidData,
+                "not a ptyrec recording",
+            ));
+        }
+
+        let cols = u16::from_le_bytes([data[8], data[9]]);
+        let rows = u16::from_le_bytes([data[10], data[11]]);
+
+        let mut chunks = Vec::new();
+        let mut rest = &data[HEADER_LEN..];
+        while rest.len() >= 8 {
+            let delay_us = u32::from_le_bytes([rest[0], rest[1], rest[2], rest[3]]);
+            let len = u32::from_le_bytes([rest[4], rest[5], rest[6], rest[7]]) as usize;
+            if rest.len() < 8 + len {
+                break;
+            }
+            chunks.push(RecordedChunk {
+                delay: Duration::from_micros(delay_us as u64),
+                bytes: rest[8..8 + len].to_vec(),
+            });
+            rest = &rest[8 + len..];
+        }
+
+        Ok(Self { cols, rows, chunks })
+    }
+
+    /// 总字节数
+    pub fn total_bytes(&self) -> usize {
+        self.chunks.iter().map(|chunk| chunk.bytes.len()).sum()
+    }
+
+    /// 录制时长
+    pub fn duration(&self) -> Duration {
+        self.chunks.iter().map(|chunk| chunk.delay).sum()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_record_and_parse_roundtrip() {
+        let path = std::env::temp_dir()
+            .join(format!("eterm-ptyrec-test-{}.ptyrec", std::process::id()));
+
+        {
+            let mut recorder = PtyRecorder::create(&path, 120, 40).unwrap();
+            recorder.record(b"\x1b[31mhello\x1b[0m\r\n").unwrap();
+            recorder.record(b"").unwrap(); // 空块不写入
+            recorder.record(b"world").unwrap();
+            recorder.flush().unwrap();
+        }
+
+        let recording = PtyRecording::load(&path).unwrap();
+        std::fs::remove_file(&path).ok();
+
+        assert_eq!((recording.cols, recording.rows), (120, 40));
+        assert_eq!(recording.chunks.len(), 2);
+        assert_eq!(recording.chunks[0].bytes, b"\x1b[31mhello\x1b[0m\r\n");
+        assert_eq!(recording.chunks[1].bytes, b"world");
+        assert_eq!(recording.total_bytes(), 21);
+    }
+
+    #[test]
+    fn test_parse_rejects_garbage_and_drops_truncated_chunk() {
+        assert!(PtyRecording::parse(b"not a recording").is_err());
+
+        let mut data = MAGIC.to_vec();
+        data.extend_from_slice(&80u16.to_le_bytes());
+        data.extend_from_slice(&24u16.to_le_bytes());
+        data.extend_from_slice(&10u32.to_le_bytes());
+        data.extend_from_slice(&3u32.to_le_bytes());
+        data.extend_from_slice(b"abc");
+        // 被截断的第二块
+        data.extend_from_slice(&10u32.to_le_bytes());
+        data.extend_from_slice(&100u32.to_le_bytes());
+        data.extend_from_slice(b"de");
+
+        let recording = PtyRecording::parse(&data).unwrap();
+        assert_eq!(recording.chunks.len(), 1);
+        assert_eq!(recording.chunks[0].delay, Duration::from_micros(10));
+        assert_eq!(recording.duration(), Duration::from_micros(10));
+    }
+}
@@ -0,0 +1,124 @@
+//! Replay Benchmark - 真实 PTY 录制回放性能测试
+//!
+//! 回放 `benches/captures/*.ptyrec`（真实程序的 PTY 输出），按录制时的分块
+//! 依次送入 Processor + Crosswords，并在每块之后执行 RenderState 同步，
+//! 模拟 I/O 线程解析 + 渲染线程同步的真实负载。
+//!
+//! 运行：cargo test --release replay_bench -- --nocapture
+
+#[cfg(test)]
+mod tests {
+    use crate::domain::aggregates::RenderState;
+    use crate::infra::pty_recording::PtyRecording;
+    use rio_backend::ansi::CursorShape;
+    use rio_backend::crosswords::{Crosswords, CrosswordsSize};
+    use rio_backend::event::{VoidListener, WindowId};
+    use rio_backend::performer::handler::Processor;
+    use std::path::PathBuf;
+    use std::time::{Duration, Instant};
+
+    const ITERATIONS: u32 = 20;
+
+    fn load_capture(name: &str) -> PtyRecording {
+        let path: PathBuf = [env!("CARGO_MANIFEST_DIR"), "benches", "captures", name]
+            .iter()
+            .collect();
+        PtyRecording::load(&path)
+            .unwrap_or_else(|e| panic!("failed to load {}: {}", path.display(), e))
+    }
+
+    fn new_crosswords(recording: &PtyRecording) -> Crosswords<VoidListener> {
+        let size = CrosswordsSize::new(recording.cols as usize, recording.rows as usize);
+        Crosswords::new(
+            size,
+            CursorShape::Block,
+            VoidListener {},
+            WindowId::from(0),
+            0,
+        )
+    }
+
+    /// 只解析 + Grid 写入
+    fn replay_parse(recording: &PtyRecording) -> Duration {
+        let start = Instant::now();
+        for _ in 0..ITERATIONS {
+            let mut crosswords = new_crosswords(recording);
+            let mut processor: Processor = Processor::new();
+            for chunk in &recording.chunks {
+                processor.advance(&mut crosswords, &chunk.bytes);
+            }
+        }
+        start.elapsed() / ITERATIONS
+    }
+
+    /// 解析 + Grid 写入 + 每块之后 RenderState 同步
+    fn replay_parse_and_sync(recording: &PtyRecording) -> (Duration, usize) {
+        let mut frames = 0;
+        let start = Instant::now();
+        for _ in 0..ITERATIONS {
+            let mut crosswords = new_crosswords(recording);
+            let mut processor: Processor = Processor::new();
+            let mut render_state =
+                RenderState::new(recording.cols as usize, recording.rows as usize);
+            frames = 0;
+            for chunk in &recording.chunks {
+                processor.advance(&mut crosswords, &chunk.bytes);
+                if render_state.sync_from_crosswords(&crosswords) {
+                    frames += 1;
+                }
+            }
+        }
+        (start.elapsed() / ITERATIONS, frames)
+    }
+
+    fn bench_capture(name: &str) {
+        let recording = load_capture(name);
+        assert!(!recording.chunks.is_empty(), "{} has no chunks", name);
+
+        let bytes = recording.total_bytes();
+        let parse = replay_parse(&recording);
+        let (parse_sync, frames) = replay_parse_and_sync(&recording);
+        let mb = bytes as f64 / 1_000_000.0;
+
+        println!(
+            "\n📊 [Replay {}] {}x{}, {} chunks, {} KB, recorded over {:?}",
+            name,
+            recording.cols,
+            recording.rows,
+            recording.chunks.len(),
+            bytes / 1024,
+            recording.duration()
+        );
+        println!(
+            "   Parse:        {:?} ({:.2} MB/s)",
+            parse,
+            mb / parse.as_secs_f64()
+        );
+        println!(
+            "   Parse + sync: {:?} ({:.2} MB/s, {} syncs with changes)",
+            parse_sync,
+            mb / parse_sync.as_secs_f64(),
+            frames
+        );
+    }
+
+    #[test]
+    fn bench_replay_vim() {
+        bench_capture("vim.ptyrec");
+    }
+
+    #[test]
+    fn bench_replay_top() {
+        bench_capture("top.ptyrec");
+    }
+
+    #[test]
+    fn bench_replay_git_diff() {
+        bench_capture("git_diff.ptyrec");
+    }
+
+    #[test]
+    fn bench_replay_build_log() {
+        bench_capture("build_log.ptyrec");
+    }
+}
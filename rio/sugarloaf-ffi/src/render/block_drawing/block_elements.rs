@@ -39,17 +39,62 @@
 //! | U+259E | ▞    | Quadrant UR+LL          | UR+LL (diagonal) |
 //! | U+259F | ▟    | Quadrant UR+LL+LR       | UR+LL+LR         |
 
-use skia_safe::{Canvas, Color4f, Paint, Rect};
+use std::collections::HashMap;
+use skia_safe::{Canvas, Color4f, Paint, Path, Rect, Vector};
+
+/// 几何缓存上限（字号/缩放频繁变化时整体清空，避免无限增长）
+const MAX_GEOMETRY_ENTRIES: usize = 512;
+
+/// 几何缓存 key
+///
+/// 宽高取像素对齐后的整数值：同一行内不同列的 cell 可能因为 round
+/// 产生 ±1px 的宽度差异，因此按对齐后的尺寸区分。
+#[derive(Hash, Eq, PartialEq, Clone, Copy, Debug)]
+struct GeometryKey {
+    ch: char,
+    width: u32,
+    height: u32,
+    /// scale 的 bit 表示（阴影点阵密度依赖 scale）
+    scale_bits: u32,
+}
+
+/// 预计算的字符几何（cell 局部坐标，原点为 cell 左上角）
+struct BlockGeometry {
+    /// 组成字符的矩形列表
+    rects: Vec<Rect>,
+    /// 多矩形时预合并的 Path（阴影点阵等），一次 draw_path 提交
+    path: Option<Path>,
+}
+
+/// 几何缓存统计
+#[derive(Debug, Default, Clone, Copy, PartialEq)]
+pub struct GeometryCacheStats {
+    pub hits: u64,
+    pub misses: u64,
+    pub entries: usize,
+}
 
 /// Block Elements 绘制器
 pub struct BlockDrawer {
     /// 是否启用（可通过配置关闭）
     enabled: bool,
+    /// 几何缓存：(字符, cell 尺寸, scale) → 局部坐标矩形
+    ///
+    /// 全屏 TUI 帧中同一字符大量重复出现，命中后只需平移绘制，
+    /// 不再重复计算分割点和阴影点阵。
+    geometry_cache: HashMap<GeometryKey, BlockGeometry>,
+    hits: u64,
+    misses: u64,
 }
 
 impl BlockDrawer {
     pub fn new() -> Self {
-        Self { enabled: true }
+        Self {
+            enabled: true,
+            geometry_cache: HashMap::new(),
+            hits: 0,
+            misses: 0,
+        }
     }
 
     /// 设置是否启用
@@ -62,6 +107,20 @@ impl BlockDrawer {
         self.enabled
     }
 
+    /// 获取几何缓存统计
+    pub fn cache_stats(&self) -> GeometryCacheStats {
+        GeometryCacheStats {
+            hits: self.hits,
+            misses: self.misses,
+            entries: self.geometry_cache.len(),
+        }
+    }
+
+    /// 清空几何缓存
+    pub fn clear_cache(&mut self) {
+        self.geometry_cache.clear();
+    }
+
     /// 绘制 Block Element 字符
     ///
     /// # 参数
@@ -78,7 +137,7 @@ impl BlockDrawer {
     /// - `true`: 成功绘制
     /// - `false`: 不是 Block Element 字符或未启用
     pub fn draw(
-        &self,
+        &mut self,
         canvas: &Canvas,
         ch: char,
         x: f32,
@@ -106,145 +165,155 @@ impl BlockDrawer {
         let right = (x + width).round();
         let bottom = (y + height).round();
 
-        let x = left;
-        let y = top;
-        let width = right - left;
-        let height = bottom - top;
+        let key = GeometryKey {
+            ch,
+            width: (right - left).max(0.0) as u32,
+            height: (bottom - top).max(0.0) as u32,
+            scale_bits: scale.to_bits(),
+        };
+
+        if !self.geometry_cache.contains_key(&key) {
+            let Some(rects) = Self::build_geometry(ch, key.width as f32, key.height as f32, scale) else {
+                return false;
+            };
+            self.misses += 1;
+            if self.geometry_cache.len() >= MAX_GEOMETRY_ENTRIES {
+                self.geometry_cache.clear();
+            }
+            let path = if rects.len() > 1 {
+                let mut path = Path::new();
+                for rect in &rects {
+                    path.add_rect(*rect, None);
+                }
+                Some(path)
+            } else {
+                None
+            };
+            self.geometry_cache.insert(key, BlockGeometry { rects, path });
+        } else {
+            self.hits += 1;
+        }
+        let geometry = &self.geometry_cache[&key];
 
         // 创建 Paint（关闭抗锯齿，确保像素精确）
         let mut paint = Paint::default();
         paint.set_anti_alias(false); // 关键：关闭抗锯齿
         paint.set_color4f(color, None);
 
+        // 平移是整数像素，关闭抗锯齿时覆盖结果与直接绘制一致
+        match &geometry.path {
+            Some(path) => {
+                canvas.save();
+                canvas.translate(Vector::new(left, top));
+                canvas.draw_path(path, &paint);
+                canvas.restore();
+            }
+            None => {
+                for rect in &geometry.rects {
+                    canvas.draw_rect(rect.with_offset((left, top)), &paint);
+                }
+            }
+        }
+
+        true
+    }
+
+    /// 计算字符几何（cell 局部坐标）
+    ///
+    /// 返回 `None` 表示不是 Block Element 字符
+    fn build_geometry(ch: char, width: f32, height: f32, scale: f32) -> Option<Vec<Rect>> {
+        let mut rects = Vec::new();
+        let out = &mut rects;
+        let (x, y, w, h) = (0.0, 0.0, width, height);
+
         match ch {
             // ===== 垂直分割（从下往上填充）=====
-            '▁' => self.draw_lower_block(canvas, x, y, width, height, 1.0 / 8.0, &paint),
-            '▂' => self.draw_lower_block(canvas, x, y, width, height, 2.0 / 8.0, &paint),
-            '▃' => self.draw_lower_block(canvas, x, y, width, height, 3.0 / 8.0, &paint),
-            '▄' => self.draw_lower_block(canvas, x, y, width, height, 4.0 / 8.0, &paint),
-            '▅' => self.draw_lower_block(canvas, x, y, width, height, 5.0 / 8.0, &paint),
-            '▆' => self.draw_lower_block(canvas, x, y, width, height, 6.0 / 8.0, &paint),
-            '▇' => self.draw_lower_block(canvas, x, y, width, height, 7.0 / 8.0, &paint),
-            '█' => self.draw_full_block(canvas, x, y, width, height, &paint),
-            '▀' => self.draw_upper_block(canvas, x, y, width, height, 4.0 / 8.0, &paint),
-            '▔' => self.draw_upper_block(canvas, x, y, width, height, 1.0 / 8.0, &paint),
+            '▁' => Self::lower_block(out, x, y, w, h, 1.0 / 8.0),
+            '▂' => Self::lower_block(out, x, y, w, h, 2.0 / 8.0),
+            '▃' => Self::lower_block(out, x, y, w, h, 3.0 / 8.0),
+            '▄' => Self::lower_block(out, x, y, w, h, 4.0 / 8.0),
+            '▅' => Self::lower_block(out, x, y, w, h, 5.0 / 8.0),
+            '▆' => Self::lower_block(out, x, y, w, h, 6.0 / 8.0),
+            '▇' => Self::lower_block(out, x, y, w, h, 7.0 / 8.0),
+            '█' => Self::full_block(out, x, y, w, h),
+            '▀' => Self::upper_block(out, x, y, w, h, 4.0 / 8.0),
+            '▔' => Self::upper_block(out, x, y, w, h, 1.0 / 8.0),
 
             // ===== 水平分割（从左往右填充）=====
-            '▏' => self.draw_left_block(canvas, x, y, width, height, 1.0 / 8.0, &paint),
-            '▎' => self.draw_left_block(canvas, x, y, width, height, 2.0 / 8.0, &paint),
-            '▍' => self.draw_left_block(canvas, x, y, width, height, 3.0 / 8.0, &paint),
-            '▌' => self.draw_left_block(canvas, x, y, width, height, 4.0 / 8.0, &paint),
-            '▋' => self.draw_left_block(canvas, x, y, width, height, 5.0 / 8.0, &paint),
-            '▊' => self.draw_left_block(canvas, x, y, width, height, 6.0 / 8.0, &paint),
-            '▉' => self.draw_left_block(canvas, x, y, width, height, 7.0 / 8.0, &paint),
-            '▐' => self.draw_right_block(canvas, x, y, width, height, 4.0 / 8.0, &paint),
-            '▕' => self.draw_right_block(canvas, x, y, width, height, 1.0 / 8.0, &paint),
+            '▏' => Self::left_block(out, x, y, w, h, 1.0 / 8.0),
+            '▎' => Self::left_block(out, x, y, w, h, 2.0 / 8.0),
+            '▍' => Self::left_block(out, x, y, w, h, 3.0 / 8.0),
+            '▌' => Self::left_block(out, x, y, w, h, 4.0 / 8.0),
+            '▋' => Self::left_block(out, x, y, w, h, 5.0 / 8.0),
+            '▊' => Self::left_block(out, x, y, w, h, 6.0 / 8.0),
+            '▉' => Self::left_block(out, x, y, w, h, 7.0 / 8.0),
+            '▐' => Self::right_block(out, x, y, w, h, 4.0 / 8.0),
+            '▕' => Self::right_block(out, x, y, w, h, 1.0 / 8.0),
 
             // ===== 阴影（点阵 pattern）=====
-            '░' => self.draw_shade(canvas, x, y, width, height, 0.25, scale, &paint),
-            '▒' => self.draw_shade(canvas, x, y, width, height, 0.50, scale, &paint),
-            '▓' => self.draw_shade(canvas, x, y, width, height, 0.75, scale, &paint),
+            '░' => Self::shade(out, x, y, w, h, 0.25, scale),
+            '▒' => Self::shade(out, x, y, w, h, 0.50, scale),
+            '▓' => Self::shade(out, x, y, w, h, 0.75, scale),
 
             // ===== 象限 =====
-            '▖' => self.draw_quadrant_ll(canvas, x, y, width, height, &paint),
-            '▗' => self.draw_quadrant_lr(canvas, x, y, width, height, &paint),
-            '▘' => self.draw_quadrant_ul(canvas, x, y, width, height, &paint),
-            '▝' => self.draw_quadrant_ur(canvas, x, y, width, height, &paint),
-            '▙' => self.draw_quadrants(canvas, x, y, width, height, true, false, true, true, &paint),
-            '▚' => self.draw_quadrants(canvas, x, y, width, height, true, false, false, true, &paint),
-            '▛' => self.draw_quadrants(canvas, x, y, width, height, true, true, true, false, &paint),
-            '▜' => self.draw_quadrants(canvas, x, y, width, height, true, true, false, true, &paint),
-            '▞' => self.draw_quadrants(canvas, x, y, width, height, false, true, true, false, &paint),
-            '▟' => self.draw_quadrants(canvas, x, y, width, height, false, true, true, true, &paint),
-
-            _ => return false,
+            '▖' => Self::quadrant_ll(out, x, y, w, h),
+            '▗' => Self::quadrant_lr(out, x, y, w, h),
+            '▘' => Self::quadrant_ul(out, x, y, w, h),
+            '▝' => Self::quadrant_ur(out, x, y, w, h),
+            '▙' => Self::quadrants(out, x, y, w, h, true, false, true, true),
+            '▚' => Self::quadrants(out, x, y, w, h, true, false, false, true),
+            '▛' => Self::quadrants(out, x, y, w, h, true, true, true, false),
+            '▜' => Self::quadrants(out, x, y, w, h, true, true, false, true),
+            '▞' => Self::quadrants(out, x, y, w, h, false, true, true, false),
+            '▟' => Self::quadrants(out, x, y, w, h, false, true, true, true),
+
+            _ => return None,
         }
 
-        true
+        Some(rects)
     }
 
-    // ===== 内部绘制方法 =====
+    // ===== 内部几何计算 =====
 
-    /// 绘制完整填充
+    /// 完整填充
     #[inline]
-    fn draw_full_block(&self, canvas: &Canvas, x: f32, y: f32, w: f32, h: f32, paint: &Paint) {
-        let rect = Rect::from_xywh(x, y, w, h);
-        canvas.draw_rect(rect, paint);
+    fn full_block(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32) {
+        out.push(Rect::from_xywh(x, y, w, h));
     }
 
-    /// 绘制下半部分（从底部向上 ratio 比例）
+    /// 下半部分（从底部向上 ratio 比例）
     #[inline]
-    fn draw_lower_block(
-        &self,
-        canvas: &Canvas,
-        x: f32,
-        y: f32,
-        w: f32,
-        h: f32,
-        ratio: f32,
-        paint: &Paint,
-    ) {
+    fn lower_block(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32, ratio: f32) {
         // 计算分割点并 round 到整数像素
         let block_h = (h * ratio).round();
         let block_y = y + h - block_h;
-        let rect = Rect::from_xywh(x, block_y, w, block_h);
-        canvas.draw_rect(rect, paint);
+        out.push(Rect::from_xywh(x, block_y, w, block_h));
     }
 
-    /// 绘制上半部分（从顶部向下 ratio 比例）
+    /// 上半部分（从顶部向下 ratio 比例）
     #[inline]
-    fn draw_upper_block(
-        &self,
-        canvas: &Canvas,
-        x: f32,
-        y: f32,
-        w: f32,
-        h: f32,
-        ratio: f32,
-        paint: &Paint,
-    ) {
+    fn upper_block(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32, ratio: f32) {
         let block_h = (h * ratio).round();
-        let rect = Rect::from_xywh(x, y, w, block_h);
-        canvas.draw_rect(rect, paint);
+        out.push(Rect::from_xywh(x, y, w, block_h));
     }
 
-    /// 绘制左半部分（从左向右 ratio 比例）
+    /// 左半部分（从左向右 ratio 比例）
     #[inline]
-    fn draw_left_block(
-        &self,
-        canvas: &Canvas,
-        x: f32,
-        y: f32,
-        w: f32,
-        h: f32,
-        ratio: f32,
-        paint: &Paint,
-    ) {
+    fn left_block(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32, ratio: f32) {
         let block_w = (w * ratio).round();
-        let rect = Rect::from_xywh(x, y, block_w, h);
-        canvas.draw_rect(rect, paint);
+        out.push(Rect::from_xywh(x, y, block_w, h));
     }
 
-    /// 绘制右半部分（从右向左 ratio 比例）
+    /// 右半部分（从右向左 ratio 比例）
     #[inline]
-    fn draw_right_block(
-        &self,
-        canvas: &Canvas,
-        x: f32,
-        y: f32,
-        w: f32,
-        h: f32,
-        ratio: f32,
-        paint: &Paint,
-    ) {
+    fn right_block(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32, ratio: f32) {
         // 右半部分：从左半部分结束的地方开始，确保无缝衔接
         let left_w = (w * (1.0 - ratio)).round();
         let block_w = w - left_w;
-        let rect = Rect::from_xywh(x + left_w, y, block_w, h);
-        canvas.draw_rect(rect, paint);
+        out.push(Rect::from_xywh(x + left_w, y, block_w, h));
     }
 
-    /// 绘制阴影（点阵模式，密度随 scale 自适应）
+    /// 阴影（点阵模式，密度随 scale 自适应）
     ///
     /// - 25% (░): 每 4 像素填 1 个
     /// - 50% (▒): 棋盘格
@@ -253,17 +322,7 @@ impl BlockDrawer {
     /// step = scale，确保在不同 DPI 下视觉密度一致：
     /// - scale=1.0 (低 DPI): 1x1 像素点阵
     /// - scale=2.0 (Retina): 2x2 物理像素 = 1 逻辑像素
-    fn draw_shade(
-        &self,
-        canvas: &Canvas,
-        x: f32,
-        y: f32,
-        w: f32,
-        h: f32,
-        density: f32,
-        scale: f32,
-        paint: &Paint,
-    ) {
+    fn shade(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32, density: f32, scale: f32) {
         // 根据 DPI 缩放调整点阵大小，保持视觉密度一致
         let step = scale.max(1.0);
 
@@ -292,8 +351,7 @@ impl BlockDrawer {
                 if should_draw {
                     let px_w = step.min(x + w - curr_x);
                     let px_h = step.min(y + h - curr_y);
-                    let rect = Rect::from_xywh(curr_x, curr_y, px_w, px_h);
-                    canvas.draw_rect(rect, paint);
+                    out.push(Rect::from_xywh(curr_x, curr_y, px_w, px_h));
                 }
 
                 curr_x += step;
@@ -304,11 +362,11 @@ impl BlockDrawer {
         }
     }
 
-    // ===== 象限绘制 =====
+    // ===== 象限 =====
 
     /// 计算象限的分割点（确保像素对齐）
     #[inline]
-    fn quadrant_splits(&self, w: f32, h: f32) -> (f32, f32, f32, f32) {
+    fn quadrant_splits(w: f32, h: f32) -> (f32, f32, f32, f32) {
         // 左半宽度和上半高度（round 到整数）
         let left_w = (w / 2.0).round();
         let top_h = (h / 2.0).round();
@@ -318,43 +376,38 @@ impl BlockDrawer {
         (left_w, right_w, top_h, bottom_h)
     }
 
-    /// 绘制左上象限
+    /// 左上象限
     #[inline]
-    fn draw_quadrant_ul(&self, canvas: &Canvas, x: f32, y: f32, w: f32, h: f32, paint: &Paint) {
-        let (left_w, _, top_h, _) = self.quadrant_splits(w, h);
-        let rect = Rect::from_xywh(x, y, left_w, top_h);
-        canvas.draw_rect(rect, paint);
+    fn quadrant_ul(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32) {
+        let (left_w, _, top_h, _) = Self::quadrant_splits(w, h);
+        out.push(Rect::from_xywh(x, y, left_w, top_h));
     }
 
-    /// 绘制右上象限
+    /// 右上象限
     #[inline]
-    fn draw_quadrant_ur(&self, canvas: &Canvas, x: f32, y: f32, w: f32, h: f32, paint: &Paint) {
-        let (left_w, right_w, top_h, _) = self.quadrant_splits(w, h);
-        let rect = Rect::from_xywh(x + left_w, y, right_w, top_h);
-        canvas.draw_rect(rect, paint);
+    fn quadrant_ur(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32) {
+        let (left_w, right_w, top_h, _) = Self::quadrant_splits(w, h);
+        out.push(Rect::from_xywh(x + left_w, y, right_w, top_h));
     }
 
-    /// 绘制左下象限
+    /// 左下象限
     #[inline]
-    fn draw_quadrant_ll(&self, canvas: &Canvas, x: f32, y: f32, w: f32, h: f32, paint: &Paint) {
-        let (left_w, _, top_h, bottom_h) = self.quadrant_splits(w, h);
-        let rect = Rect::from_xywh(x, y + top_h, left_w, bottom_h);
-        canvas.draw_rect(rect, paint);
+    fn quadrant_ll(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32) {
+        let (left_w, _, top_h, bottom_h) = Self::quadrant_splits(w, h);
+        out.push(Rect::from_xywh(x, y + top_h, left_w, bottom_h));
     }
 
-    /// 绘制右下象限
+    /// 右下象限
     #[inline]
-    fn draw_quadrant_lr(&self, canvas: &Canvas, x: f32, y: f32, w: f32, h: f32, paint: &Paint) {
-        let (left_w, right_w, top_h, bottom_h) = self.quadrant_splits(w, h);
-        let rect = Rect::from_xywh(x + left_w, y + top_h, right_w, bottom_h);
-        canvas.draw_rect(rect, paint);
+    fn quadrant_lr(out: &mut Vec<Rect>, x: f32, y: f32, w: f32, h: f32) {
+        let (left_w, right_w, top_h, bottom_h) = Self::quadrant_splits(w, h);
+        out.push(Rect::from_xywh(x + left_w, y + top_h, right_w, bottom_h));
     }
 
-    /// 绘制多个象限组合
+    /// 多个象限组合
     #[inline]
-    fn draw_quadrants(
-        &self,
-        canvas: &Canvas,
+    fn quadrants(
+        out: &mut Vec<Rect>,
         x: f32,
         y: f32,
         w: f32,
@@ -363,19 +416,18 @@ impl BlockDrawer {
         ur: bool,
         ll: bool,
         lr: bool,
-        paint: &Paint,
     ) {
         if ul {
-            self.draw_quadrant_ul(canvas, x, y, w, h, paint);
+            Self::quadrant_ul(out, x, y, w, h);
         }
         if ur {
-            self.draw_quadrant_ur(canvas, x, y, w, h, paint);
+            Self::quadrant_ur(out, x, y, w, h);
         }
         if ll {
-            self.draw_quadrant_ll(canvas, x, y, w, h, paint);
+            Self::quadrant_ll(out, x, y, w, h);
         }
         if lr {
-            self.draw_quadrant_lr(canvas, x, y, w, h, paint);
+            Self::quadrant_lr(out, x, y, w, h);
         }
     }
 }
@@ -399,7 +451,7 @@ mod tests {
 
     #[test]
     fn test_draw_full_block() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -409,7 +461,7 @@ mod tests {
 
     #[test]
     fn test_draw_half_blocks() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -426,7 +478,7 @@ mod tests {
 
     #[test]
     fn test_draw_eighth_blocks() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -443,7 +495,7 @@ mod tests {
 
     #[test]
     fn test_draw_shades() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -455,7 +507,7 @@ mod tests {
 
     #[test]
     fn test_draw_shades_low_dpi() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -468,7 +520,7 @@ mod tests {
 
     #[test]
     fn test_draw_quadrants() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -486,7 +538,7 @@ mod tests {
 
     #[test]
     fn test_draw_edge_blocks() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -498,7 +550,7 @@ mod tests {
 
     #[test]
     fn test_non_block_char_returns_false() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -523,7 +575,7 @@ mod tests {
 
     #[test]
     fn test_all_32_block_elements() {
-        let drawer = BlockDrawer::new();
+        let mut drawer = BlockDrawer::new();
         let mut surface = create_test_surface();
         let canvas = surface.canvas();
         let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
@@ -544,4 +596,118 @@ mod tests {
             );
         }
     }
+
+    #[test]
+    fn test_geometry_cache_hit() {
+        let mut drawer = BlockDrawer::new();
+        let mut surface = create_test_surface();
+        let canvas = surface.canvas();
+        let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
+
+        // 同尺寸不同位置：只计算一次几何
+        for col in 0..8 {
+            assert!(drawer.draw(canvas, '▒', col as f32 * 10.0, 0.0, 10.0, 20.0, color, TEST_SCALE));
+        }
+        let stats = drawer.cache_stats();
+        assert_eq!(stats.misses, 1);
+        assert_eq!(stats.hits, 7);
+        assert_eq!(stats.entries, 1);
+
+        // 尺寸变化 → 新条目
+        assert!(drawer.draw(canvas, '▒', 0.0, 0.0, 12.0, 20.0, color, TEST_SCALE));
+        assert_eq!(drawer.cache_stats().entries, 2);
+
+        // 非 Block 字符不进入缓存
+        assert!(!drawer.draw(canvas, 'A', 0.0, 0.0, 10.0, 20.0, color, TEST_SCALE));
+        assert_eq!(drawer.cache_stats().entries, 2);
+    }
+
+    #[test]
+    fn test_cached_geometry_matches_direct_draw() {
+        let mut drawer = BlockDrawer::new();
+        let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
+        let mut paint = Paint::default();
+        paint.set_anti_alias(false);
+        paint.set_color4f(color, None);
+
+        for ch in ['░', '▒', '▓', '▚', '▐', '▃'] {
+            // 先在原点预热缓存，再在非整数位置命中缓存绘制
+            let mut warm = create_test_surface();
+            drawer.draw(warm.canvas(), ch, 0.0, 0.0, 8.4, 17.0, color, 1.5);
+
+            let mut cached = create_test_surface();
+            drawer.draw(cached.canvas(), ch, 25.0, 30.2, 8.4, 17.0, color, 1.5);
+
+            // 对照：直接在目标位置逐矩形绘制
+            let mut direct = create_test_surface();
+            let rects = BlockDrawer::build_geometry(ch, 8.0, 17.0, 1.5).unwrap();
+            for rect in rects {
+                direct.canvas().draw_rect(rect.with_offset((25.0, 30.0)), &paint);
+            }
+
+            let a = cached.image_snapshot();
+            let b = direct.image_snapshot();
+            let a = a.peek_pixels().unwrap();
+            let b = b.peek_pixels().unwrap();
+            assert_eq!(a.bytes(), b.bytes(), "pixel mismatch for '{}'", ch);
+        }
+    }
+
+    /// 全屏 Block/Shade 帧：几何缓存 vs 每次重新计算
+    #[test]
+    fn bench_full_frame_block_geometry() {
+        use std::time::Instant;
+
+        const COLS: usize = 200;
+        const ROWS: usize = 50;
+        let chars = ['▒', '█', '▀', '▓', '░', '▚', '▌', '▄'];
+        let (cell_w, cell_h) = (16.8, 34.0);
+        let color = Color4f::new(1.0, 1.0, 1.0, 1.0);
+        let mut surface = surfaces::raster_n32_premul(((COLS as f32 * cell_w) as i32 + 1, cell_h as i32 + 1))
+            .expect("Failed to create surface");
+        let mut paint = Paint::default();
+        paint.set_anti_alias(false);
+        paint.set_color4f(color, None);
+
+        let iterations = 5;
+
+        // 对照：每个 cell 重新计算几何并逐矩形绘制
+        let start = Instant::now();
+        for _ in 0..iterations {
+            for _row in 0..ROWS {
+                let canvas = surface.canvas();
+                for col in 0..COLS {
+                    let ch = chars[col % chars.len()];
+                    let x = col as f32 * cell_w;
+                    let w = ((x + cell_w).round() - x.round()).max(0.0);
+                    for rect in BlockDrawer::build_geometry(ch, w, cell_h, TEST_SCALE).unwrap() {
+                        canvas.draw_rect(rect.with_offset((x.round(), 0.0)), &paint);
+                    }
+                }
+            }
+        }
+        let uncached = start.elapsed();
+
+        let mut drawer = BlockDrawer::new();
+        let start = Instant::now();
+        for _ in 0..iterations {
+            for _row in 0..ROWS {
+                let canvas = surface.canvas();
+                for col in 0..COLS {
+                    let ch = chars[col % chars.len()];
+                    drawer.draw(canvas, ch, col as f32 * cell_w, 0.0, cell_w, cell_h, color, TEST_SCALE);
+                }
+            }
+        }
+        let cached = start.elapsed();
+        let stats = drawer.cache_stats();
+
+        println!("\n📊 [Block frame {}x{} × {}]", COLS, ROWS, iterations);
+        println!("   Uncached: {:?} ({:?}/frame)", uncached, uncached / iterations);
+        println!("   Cached:   {:?} ({:?}/frame)", cached, cached / iterations);
+        println!("   Geometry cache: {} hits, {} misses, {} entries", stats.hits, stats.misses, stats.entries);
+
+        // 每种 (字符, 对齐宽度) 只计算一次
+        assert!(stats.misses <= (chars.len() * 2) as u64);
+    }
 }
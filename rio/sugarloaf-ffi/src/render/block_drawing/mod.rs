@@ -30,5 +30,5 @@
 mod block_elements;
 mod detector;
 
-pub use block_elements::BlockDrawer;
+pub use block_elements::{BlockDrawer, GeometryCacheStats};
 pub use detector::{is_block_element, is_box_drawing, is_drawable_block_char, BlockCharType};
@@ -5,6 +5,7 @@
 
 use std::collections::HashMap;
 use skia_safe::{surfaces, Surface, Image, Color, ImageInfo, ColorType, AlphaType};
+use skia_safe::{canvas::SrcRectConstraint, BlendMode, Paint, Rect};
 
 // ============================================================================
 // GlyphKey - 字形键（针对终端场景简化）
@@ -102,23 +103,32 @@ impl GlyphBitmap {
 }
 
 // ============================================================================
-// AtlasAllocator - Shelf-based 分配器（从 Rio 移植）
+// AtlasAllocator - Skyline 分配器
 // ============================================================================
 
-/// Atlas 分配器（shelf-based 算法）
+/// Atlas 分配器（skyline bottom-left 算法）
+///
+/// 用一条"天际线"记录每段 x 区间当前已占用到的高度，新矩形放在
+/// 能使其顶边最低的位置（同高时选最贴合的段）。相比 shelf 算法，
+/// 高度不一的字形（CJK、emoji、powerline）不会各自独占一整层，
+/// 矮字形可以填进高字形旁边的空隙。
 pub struct AtlasAllocator {
     width: u16,
     height: u16,
-    shelves: Vec<Shelf>,
-    waste_limit: f32,
+    /// 天际线分段（按 x 升序，首尾相接覆盖整个宽度）
+    skyline: Vec<SkylineNode>,
+    /// 已分配面积（含 1px padding）
+    allocated_area: u32,
+    /// 已分配矩形数量
+    num_allocations: usize,
 }
 
-#[derive(Debug, Clone)]
-struct Shelf {
+#[derive(Debug, Clone, Copy)]
+struct SkylineNode {
     x: u16,
+    /// 该段当前占用到的高度
     y: u16,
     width: u16,
-    height: u16,
 }
 
 impl AtlasAllocator {
@@ -126,8 +136,9 @@ impl AtlasAllocator {
         Self {
             width,
             height,
-            shelves: Vec::new(),
-            waste_limit: 0.1,
+            skyline: vec![SkylineNode { x: 0, y: 0, width }],
+            allocated_area: 0,
+            num_allocations: 0,
         }
     }
 
@@ -136,101 +147,138 @@ impl AtlasAllocator {
         let padded_width = width.saturating_add(1);
         let padded_height = height.saturating_add(1);
 
-        if padded_width > self.width {
+        if padded_width > self.width || padded_height > self.height {
             return None;
         }
 
-        if let Some((shelf_idx, x, y)) = self.find_best_shelf(padded_width, padded_height) {
-            let shelf = &mut self.shelves[shelf_idx];
-            shelf.x += padded_width;
-            shelf.width = shelf.width.saturating_sub(padded_width);
-            return Some((x, y));
-        }
-
-        self.create_new_shelf(padded_width, padded_height)
-    }
-
-    fn find_best_shelf(&mut self, width: u16, height: u16) -> Option<(usize, u16, u16)> {
-        let mut best_shelf = None;
-        let mut best_waste = f32::INFINITY;
-
-        for (i, shelf) in self.shelves.iter().enumerate() {
-            if shelf.width >= width && shelf.height >= height {
-                let waste_ratio = self.calculate_waste_ratio(shelf, height);
-                let score = if shelf.height == height {
-                    waste_ratio - 1.0
-                } else {
-                    waste_ratio
-                };
-
-                if score < best_waste && waste_ratio <= self.waste_limit {
-                    best_waste = score;
-                    best_shelf = Some((i, shelf.x, shelf.y));
+        // 选择顶边最低的位置；同高时选择宽度最贴合的段（减少碎片）
+        let mut best: Option<(usize, u16)> = None;
+        let mut best_top = u32::MAX;
+        let mut best_width = u16::MAX;
+        for i in 0..self.skyline.len() {
+            if let Some(y) = self.fit(i, padded_width, padded_height) {
+                let top = y as u32 + padded_height as u32;
+                let node_width = self.skyline[i].width;
+                if top < best_top || (top == best_top && node_width < best_width) {
+                    best = Some((i, y));
+                    best_top = top;
+                    best_width = node_width;
                 }
             }
         }
 
-        best_shelf
+        let (index, y) = best?;
+        let x = self.skyline[index].x;
+        self.insert_node(index, x, y + padded_height, padded_width);
+
+        self.allocated_area += padded_width as u32 * padded_height as u32;
+        self.num_allocations += 1;
+        Some((x, y))
     }
 
-    fn calculate_waste_ratio(&self, shelf: &Shelf, height: u16) -> f32 {
-        if shelf.height == 0 {
-            return f32::INFINITY;
+    /// 检查从第 index 段开始放置 width×height 是否可行，返回放置的 y
+    fn fit(&self, index: usize, width: u16, height: u16) -> Option<u16> {
+        let x = self.skyline[index].x;
+        if x as u32 + width as u32 > self.width as u32 {
+            return None;
         }
-        let wasted = shelf.height.saturating_sub(height) as f32;
-        wasted / shelf.height as f32
+
+        // 矩形跨越的所有段中取最高点作为底边
+        let mut remaining = width as i32;
+        let mut y = 0u16;
+        let mut i = index;
+        while remaining > 0 {
+            let node = self.skyline.get(i)?;
+            y = y.max(node.y);
+            if y as u32 + height as u32 > self.height as u32 {
+                return None;
+            }
+            remaining -= node.width as i32;
+            i += 1;
+        }
+        Some(y)
     }
 
-    fn create_new_shelf(&mut self, width: u16, height: u16) -> Option<(u16, u16)> {
-        let y = self.find_next_y();
+    /// 在 index 处插入新段，并裁剪/移除被覆盖的后续段
+    fn insert_node(&mut self, index: usize, x: u16, y: u16, width: u16) {
+        self.skyline.insert(index, SkylineNode { x, y, width });
 
-        if y.saturating_add(height) > self.height {
-            return None;
+        let i = index + 1;
+        while i < self.skyline.len() {
+            let prev_end = self.skyline[i - 1].x + self.skyline[i - 1].width;
+            let node = &mut self.skyline[i];
+            if node.x >= prev_end {
+                break;
+            }
+            let shrink = prev_end - node.x;
+            if node.width <= shrink {
+                self.skyline.remove(i);
+            } else {
+                node.x += shrink;
+                node.width -= shrink;
+                break;
+            }
         }
 
-        let shelf = Shelf {
-            x: width,
-            y,
-            width: self.width.saturating_sub(width),
-            height,
-        };
+        // 合并相邻同高段
+        let mut i = 0;
+        while i + 1 < self.skyline.len() {
+            if self.skyline[i].y == self.skyline[i + 1].y {
+                self.skyline[i].width += self.skyline[i + 1].width;
+                self.skyline.remove(i + 1);
+            } else {
+                i += 1;
+            }
+        }
+    }
 
-        self.shelves.push(shelf);
-        Some((0, y))
+    pub fn clear(&mut self) {
+        self.skyline.clear();
+        self.skyline.push(SkylineNode { x: 0, y: 0, width: self.width });
+        self.allocated_area = 0;
+        self.num_allocations = 0;
     }
 
-    fn find_next_y(&self) -> u16 {
-        self.shelves
-            .iter()
-            .map(|s| s.y.saturating_add(s.height))
-            .max()
-            .unwrap_or(0)
+    pub fn is_empty(&self) -> bool {
+        self.num_allocations == 0
     }
 
-    pub fn clear(&mut self) {
-        self.shelves.clear();
+    /// 天际线以下的面积（已分配 + 被困住的空隙）
+    fn covered_area(&self) -> u32 {
+        self.skyline
+            .iter()
+            .map(|node| node.width as u32 * node.y as u32)
+            .sum()
     }
 
-    pub fn is_empty(&self) -> bool {
-        self.shelves.is_empty()
+    /// 碎片率：天际线以下未被字形使用的面积占比
+    ///
+    /// 0.0 = 完全紧凑；值越大说明被困在高字形之间的空隙越多
+    pub fn fragmentation(&self) -> f32 {
+        let covered = self.covered_area();
+        if covered == 0 {
+            return 0.0;
+        }
+        1.0 - self.allocated_area as f32 / covered as f32
     }
 
     /// 获取利用率统计
     pub fn utilization(&self) -> AtlasStats {
         let total_area = (self.width as u32) * (self.height as u32);
-        let used_height = self.find_next_y() as u32;
-        let used_area = (self.width as u32) * used_height;
 
         AtlasStats {
             total_area,
-            used_area,
+            used_area: self.allocated_area,
+            covered_area: self.covered_area(),
             utilization_ratio: if total_area > 0 {
-                used_area as f32 / total_area as f32
+                self.allocated_area as f32 / total_area as f32
             } else {
                 0.0
             },
-            num_shelves: self.shelves.len(),
+            fragmentation: self.fragmentation(),
+            num_skyline_nodes: self.skyline.len(),
             num_glyphs: 0,  // 由 GlyphAtlas 填充
+            compactions: 0, // 由 GlyphAtlas 填充
         }
     }
 }
@@ -239,10 +287,18 @@ impl AtlasAllocator {
 #[derive(Debug)]
 pub struct AtlasStats {
     pub total_area: u32,
+    /// 字形实际占用面积（含 padding）
     pub used_area: u32,
+    /// 天际线以下面积（used_area + 碎片）
+    pub covered_area: u32,
+    /// used_area / total_area
     pub utilization_ratio: f32,
-    pub num_shelves: usize,
+    /// 1 - used_area / covered_area
+    pub fragmentation: f32,
+    pub num_skyline_nodes: usize,
     pub num_glyphs: usize,
+    /// 累计整理次数
+    pub compactions: usize,
 }
 
 // ============================================================================
@@ -261,12 +317,19 @@ pub struct GlyphAtlas {
     allocator: AtlasAllocator,
     /// 字形位置映射
     glyph_map: HashMap<GlyphKey, AtlasRegion>,
+    /// 布局代数：clear/compact 后字形位置会变化，每次 +1
+    generation: u64,
+    /// 累计整理次数
+    compactions: usize,
 }
 
 impl GlyphAtlas {
     /// Atlas 尺寸（2048×2048 RGBA = 16MB）
     pub const ATLAS_SIZE: i32 = 2048;
 
+    /// 碎片率超过该阈值时，Atlas 满了先整理再清空
+    pub const COMPACT_THRESHOLD: f32 = 0.15;
+
     pub fn new() -> Self {
         let surface = surfaces::raster_n32_premul((Self::ATLAS_SIZE, Self::ATLAS_SIZE))
             .expect("Failed to create atlas surface");
@@ -277,9 +340,19 @@ impl GlyphAtlas {
             dirty: true,
             allocator: AtlasAllocator::new(Self::ATLAS_SIZE as u16, Self::ATLAS_SIZE as u16),
             glyph_map: HashMap::new(),
+            generation: 0,
+            compactions: 0,
         }
     }
 
+    /// 布局代数
+    ///
+    /// 调用方在一次绘制中收集多个 `AtlasRegion` 时，如果代数发生变化，
+    /// 说明之前拿到的区域已失效，需要重新查询。
+    pub fn generation(&self) -> u64 {
+        self.generation
+    }
+
     /// 获取 Atlas Image（dirty flag 机制）
     pub fn get_image(&mut self) -> &Image {
         if self.dirty || self.cached_image.is_none() {
@@ -321,13 +394,21 @@ impl GlyphAtlas {
         let (x, y) = match self.allocator.allocate(bitmap.width, bitmap.height) {
             Some(pos) => pos,
             None => {
-                // Atlas 满了，清空重建
-                crate::rust_log_info!(
-                    "[GlyphAtlas] Atlas full ({} glyphs), clearing...",
-                    self.glyph_map.len()
-                );
-                self.clear();
-                self.allocator.allocate(bitmap.width, bitmap.height)?
+                // Atlas 满了：碎片多时先整理，腾出被困住的空隙
+                let compacted = self.allocator.fragmentation() >= Self::COMPACT_THRESHOLD
+                    && self.compact();
+                match compacted.then(|| self.allocator.allocate(bitmap.width, bitmap.height)).flatten() {
+                    Some(pos) => pos,
+                    None => {
+                        // 整理后仍然放不下，清空重建
+                        crate::rust_log_info!(
+                            "[GlyphAtlas] Atlas full ({} glyphs), clearing...",
+                            self.glyph_map.len()
+                        );
+                        self.clear();
+                        self.allocator.allocate(bitmap.width, bitmap.height)?
+                    }
+                }
             }
         };
 
@@ -358,6 +439,70 @@ impl GlyphAtlas {
         Some(region)
     }
 
+    /// 整理 Atlas：按高度降序重新装箱所有已缓存字形，并搬移像素
+    ///
+    /// 高度相同的字形排在一起后天际线几乎没有台阶，原先被困在
+    /// 高字形之间的空隙被回收。所有字形保持缓存（不会重新光栅化），
+    /// 只是位置变化，因此 generation 会 +1。
+    ///
+    /// 返回 `false` 表示重新装箱失败（Atlas 保持原状）。
+    pub fn compact(&mut self) -> bool {
+        let mut live: Vec<(GlyphKey, AtlasRegion)> = self
+            .glyph_map
+            .iter()
+            .filter(|(_, r)| r.width > 0 && r.height > 0)
+            .map(|(k, r)| (*k, *r))
+            .collect();
+        live.sort_by(|a, b| {
+            b.1.height
+                .cmp(&a.1.height)
+                .then(b.1.width.cmp(&a.1.width))
+        });
+
+        let mut allocator = AtlasAllocator::new(Self::ATLAS_SIZE as u16, Self::ATLAS_SIZE as u16);
+        let mut placements = Vec::with_capacity(live.len());
+        for (key, region) in live {
+            let Some((x, y)) = allocator.allocate(region.width, region.height) else {
+                return false;
+            };
+            placements.push((key, region, x, y));
+        }
+
+        let Some(mut surface) = surfaces::raster_n32_premul((Self::ATLAS_SIZE, Self::ATLAS_SIZE)) else {
+            return false;
+        };
+        let old_image = self.surface.image_snapshot();
+        let canvas = surface.canvas();
+        canvas.clear(Color::TRANSPARENT);
+        let mut paint = Paint::default();
+        paint.set_blend_mode(BlendMode::Src);
+        for (key, old, x, y) in placements {
+            let dst = Rect::from_xywh(x as f32, y as f32, old.width as f32, old.height as f32);
+            canvas.draw_image_rect(
+                &old_image,
+                Some((&old.to_src_rect(), SrcRectConstraint::Strict)),
+                dst,
+                &paint,
+            );
+            self.glyph_map.insert(key, AtlasRegion { x, y, width: old.width, height: old.height });
+        }
+
+        crate::rust_log_info!(
+            "[GlyphAtlas] Compacted {} glyphs, fragmentation {:.1}% -> {:.1}%",
+            self.glyph_map.len(),
+            self.allocator.fragmentation() * 100.0,
+            allocator.fragmentation() * 100.0
+        );
+
+        self.surface = surface;
+        self.allocator = allocator;
+        self.cached_image = None;
+        self.dirty = true;
+        self.generation += 1;
+        self.compactions += 1;
+        true
+    }
+
     /// 清空 Atlas
     pub fn clear(&mut self) {
         self.glyph_map.clear();
@@ -365,12 +510,14 @@ impl GlyphAtlas {
         self.surface.canvas().clear(Color::TRANSPARENT);
         self.cached_image = None;
         self.dirty = true;
+        self.generation += 1;
     }
 
     /// 获取统计信息
     pub fn stats(&self) -> AtlasStats {
         let mut stats = self.allocator.utilization();
         stats.num_glyphs = self.glyph_map.len();
+        stats.compactions = self.compactions;
         stats
     }
 
@@ -523,4 +670,158 @@ mod tests {
         assert_eq!(stats.num_glyphs, 1);
         assert!(stats.utilization_ratio > 0.0);
     }
+
+    #[test]
+    fn test_skyline_fills_gap_beside_tall_glyph() {
+        let mut alloc = AtlasAllocator::new(100, 100);
+
+        // 高字形（emoji）+ 矮字形：矮字形放在高字形右侧，而不是另起一层
+        assert_eq!(alloc.allocate(39, 39), Some((0, 0)));
+        assert_eq!(alloc.allocate(9, 19), Some((40, 0)));
+        // 第二个矮字形叠在第一个矮字形上方的空隙里
+        assert_eq!(alloc.allocate(49, 19), Some((50, 0)));
+        assert_eq!(alloc.allocate(9, 19), Some((40, 20)));
+    }
+
+    #[test]
+    fn test_atlas_allocator_fragmentation() {
+        let mut alloc = AtlasAllocator::new(100, 100);
+        assert_eq!(alloc.fragmentation(), 0.0);
+
+        // 同高字形排满一行：没有碎片
+        for _ in 0..10 {
+            alloc.allocate(9, 9);
+        }
+        assert!(alloc.fragmentation() < 0.001);
+
+        // 矮字形跨在高低不平的天际线上，下方留下空隙
+        let mut alloc = AtlasAllocator::new(20, 100);
+        alloc.allocate(9, 29);
+        alloc.allocate(9, 9);
+        alloc.allocate(19, 9);
+        assert!(alloc.fragmentation() > 0.0);
+
+        let stats = alloc.utilization();
+        assert!(stats.covered_area > stats.used_area);
+    }
+
+    #[test]
+    fn test_glyph_atlas_compact_preserves_glyphs() {
+        let mut atlas = GlyphAtlas::new();
+
+        // 交替写入高/矮字形制造碎片
+        for i in 0..64u64 {
+            let (w, h) = if i % 2 == 0 { (36, 40) } else { (10, 20) };
+            let key = GlyphKey::new(i, 0, 14.0, 1.0, 0);
+            atlas.get_or_rasterize(key, || {
+                Some(GlyphBitmap {
+                    width: w,
+                    height: h,
+                    data: vec![(i as u8) | 1; w as usize * h as usize * 4],
+                    row_bytes: w as usize * 4,
+                })
+            });
+        }
+
+        let generation = atlas.generation();
+        assert!(atlas.compact());
+        assert_eq!(atlas.generation(), generation + 1);
+        assert_eq!(atlas.glyph_count(), 64);
+        assert_eq!(atlas.stats().compactions, 1);
+
+        // 像素随区域一起搬移
+        let image = atlas.get_image().clone();
+        let pixmap = image.peek_pixels().unwrap();
+        for i in 0..64u64 {
+            let key = GlyphKey::new(i, 0, 14.0, 1.0, 0);
+            let region = atlas.get(&key).unwrap();
+            let color = pixmap.get_color((region.x as i32, region.y as i32));
+            assert_ne!(color, Color::TRANSPARENT, "glyph {} lost after compact", i);
+        }
+    }
+
+    /// 参照实现：原 shelf 分配器（仅用于装箱效率对比）
+    struct ShelfAllocator {
+        width: u16,
+        height: u16,
+        shelves: Vec<(u16, u16, u16, u16)>, // (x, y, 剩余宽度, 高度)
+    }
+
+    impl ShelfAllocator {
+        fn allocate(&mut self, width: u16, height: u16) -> Option<(u16, u16)> {
+            let (w, h) = (width + 1, height + 1);
+            let mut best: Option<(usize, f32)> = None;
+            for (i, &(_, _, rest, sh)) in self.shelves.iter().enumerate() {
+                if rest >= w && sh >= h {
+                    let waste = (sh - h) as f32 / sh as f32;
+                    let score = if sh == h { waste - 1.0 } else { waste };
+                    if waste <= 0.1 && best.map_or(true, |(_, b)| score < b) {
+                        best = Some((i, score));
+                    }
+                }
+            }
+            if let Some((i, _)) = best {
+                let shelf = &mut self.shelves[i];
+                let pos = (shelf.0, shelf.1);
+                shelf.0 += w;
+                shelf.2 -= w;
+                return Some(pos);
+            }
+            let y = self.shelves.iter().map(|s| s.1 + s.3).max().unwrap_or(0);
+            if w > self.width || y + h > self.height {
+                return None;
+            }
+            self.shelves.push((w, y, self.width - w, h));
+            Some((0, y))
+        }
+    }
+
+    /// 装箱效率：混合高度字形流（ASCII/CJK/emoji/powerline/下标）
+    #[test]
+    fn bench_atlas_packing_efficiency() {
+        // 模拟真实终端：不同字号 + 不同字形类别交错出现
+        let shapes: [(u16, u16); 8] = [
+            (9, 20),  // ASCII
+            (18, 20), // CJK
+            (36, 34), // emoji
+            (10, 23), // powerline
+            (7, 11),  // 上/下标、组合符号
+            (12, 26), // 大字号 ASCII
+            (24, 26), // 大字号 CJK
+            (5, 14),  // 细符号
+        ];
+        let mut seed = 0x2545_f491_u32;
+        let mut next = move || {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            seed
+        };
+        let stream: Vec<(u16, u16)> = (0..200_000)
+            .map(|_| {
+                let (w, h) = shapes[next() as usize % shapes.len()];
+                // ±2px 抖动：hinting/fallback 字体导致的高度差
+                (w, h + (next() % 5) as u16)
+            })
+            .collect();
+
+        let size = 1024u16;
+        let mut shelf = ShelfAllocator { width: size, height: size, shelves: Vec::new() };
+        let shelf_fit = stream.iter().take_while(|&&(w, h)| shelf.allocate(w, h).is_some()).count();
+
+        let mut skyline = AtlasAllocator::new(size, size);
+        let skyline_fit = stream.iter().take_while(|&&(w, h)| skyline.allocate(w, h).is_some()).count();
+        let stats = skyline.utilization();
+
+        println!("\n📊 [Atlas packing {}x{}, mixed heights]", size, size);
+        println!("   Shelf:   {} glyphs", shelf_fit);
+        println!("   Skyline: {} glyphs ({:.2}x)", skyline_fit, skyline_fit as f32 / shelf_fit as f32);
+        println!(
+            "   Skyline occupancy: {:.1}%, fragmentation: {:.1}%",
+            stats.utilization_ratio * 100.0,
+            stats.fragmentation * 100.0
+        );
+
+        assert!(skyline_fit > shelf_fit);
+    }
 }
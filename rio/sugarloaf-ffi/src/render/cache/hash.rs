@@ -1,8 +1,9 @@
 use std::hash::Hasher;
 use std::collections::hash_map::DefaultHasher;
-use crate::domain::{TerminalState, MatchRange};
+use crate::domain::TerminalState;
+use super::SelectionInfo;
 #[cfg(test)]
-use crate::domain::SearchView;
+use crate::domain::{SearchView, MatchRange};
 
 /// 计算文本内容的 hash（不包含状态）
 ///
@@ -54,34 +55,23 @@ pub fn compute_state_hash_for_line(screen_line: usize, state: &TerminalState) ->
     }
 
     // 2. 选区覆盖本行？（使用绝对行号比较）
+    // 按行换算成列区间（O(1)），已处理反向拖拽和块选区；整行选中只写入一个标记
     if let Some(sel) = &state.selection {
-        // 检查选区是否覆盖本行
-        let sel_start = sel.start.line;
-        let sel_end = sel.end.line;
-        if abs_line >= sel_start && abs_line <= sel_end {
-            // 本行在选区范围内，计算覆盖的列范围
-            let start_col = if abs_line == sel_start { sel.start.col } else { 0 };
-            let end_col = if abs_line == sel_end { sel.end.col } else { usize::MAX };
-            hasher.write_usize(start_col);
-            hasher.write_usize(end_col);
-            hasher.write_u8(sel.ty as u8);
-            hasher.write_u8(3); // 标记有选区
+        let columns = state.grid.columns();
+        if let Some(span) = sel.span_on_line(abs_line, columns) {
+            SelectionInfo::new(span, columns).hash_into(&mut hasher);
         }
     }
 
     // 3. 搜索覆盖本行？（使用绝对行号比较）
-    // 🚀 性能优化：使用按行索引的 HashMap，避免遍历所有匹配
+    // 🚀 性能优化：读取搜索时预先换算好的行内区间，避免遍历所有匹配
+    // 焦点移动时只有新旧焦点匹配所在行的 hash 变化
     if let Some(search) = &state.search {
-        // 先通过行号快速查找该行的匹配索引（usize 类型）
-        if let Some(indices) = search.get_matches_at_line(abs_line) {
-            // 只遍历该行的匹配
-            for &idx in indices {
-                let m = &search.matches[idx];
-                let (start_col, end_col) = match_range_on_line(abs_line, m);
-                hasher.write_usize(start_col);
-                hasher.write_usize(end_col);
-                let is_focused = idx == search.focused_index;
-                hasher.write_u8(is_focused as u8);
+        if let Some(spans) = search.get_matches_at_line(abs_line) {
+            for span in spans {
+                hasher.write_usize(span.start_col);
+                hasher.write_usize(span.end_col);
+                hasher.write_u8(search.is_focused(span) as u8);
             }
         }
     }
@@ -110,17 +100,6 @@ pub fn compute_state_hash_for_line(screen_line: usize, state: &TerminalState) ->
     hasher.finish()
 }
 
-/// 获取匹配在本行的范围
-///
-/// # 参数
-/// - `abs_line`: 绝对行号（已转换）
-/// - `m`: 匹配范围（使用绝对坐标）
-fn match_range_on_line(abs_line: usize, m: &MatchRange) -> (usize, usize) {
-    let start_col = if abs_line == m.start.line { m.start.col } else { 0 };
-    let end_col = if abs_line == m.end.line { m.end.col } else { usize::MAX };
-    (start_col, end_col)
-}
-
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -312,6 +291,24 @@ mod tests {
         assert_ne!(hash1, hash2);
     }
 
+    /// 测试：焦点移动只影响新旧焦点匹配所在的行
+    #[test]
+    fn test_search_focus_move_only_affects_focused_lines() {
+        let mut state = create_mock_state(23, 0);
+        let matches: Vec<MatchRange> = (0..20)
+            .map(|line| MatchRange::new(AbsolutePoint::new(line, 2), AbsolutePoint::new(line, 6)))
+            .collect();
+        let search = SearchView::new(matches, 3);
+        state.search = Some(search.clone());
+        let before: Vec<u64> = (0..24).map(|line| compute_state_hash_for_line(line, &state)).collect();
+
+        state.search = Some(search.with_focus(4));
+        let after: Vec<u64> = (0..24).map(|line| compute_state_hash_for_line(line, &state)).collect();
+
+        let changed: Vec<usize> = (0..24).filter(|&line| before[line] != after[line]).collect();
+        assert_eq!(changed, vec![3, 4]);
+    }
+
     /// 测试：选区从 row3 col10 移动到 col20，只有 row3 的 hash 应该变化
     ///
     /// 场景：100 行终端，选中 row0-row3，选区从 (0,0)-(3,10) 变为 (0,0)-(3,20)
@@ -372,4 +369,70 @@ mod tests {
         assert_eq!(changed_lines, vec![3],
             "Only row 3 should change, but got: {:?}", changed_lines);
     }
+
+    #[test]
+    fn bench_full_screen_selection() {
+        use std::time::Instant;
+
+        // 200 列 × 60 行，选中整屏（拖拽全选大窗口）
+        let (columns, rows) = (200, 60);
+        let row_hashes: Vec<u64> = (0..rows).map(|i| 1000 + i as u64).collect();
+        let grid = GridView::new(Arc::new(GridData::new_mock(columns, rows, 0, row_hashes)));
+        let selection = SelectionView::new(
+            AbsolutePoint::new(0, 3),
+            AbsolutePoint::new(rows - 1, columns - 4),
+            SelectionType::Simple,
+        );
+        let state = TerminalState {
+            grid,
+            cursor: CursorView::new(AbsolutePoint::new(0, 0), CursorShape::Block),
+            selection: Some(selection),
+            search: None,
+            hyperlink_hover: None,
+            ime: None,
+        };
+
+        let iterations = 1000;
+
+        // 逐 cell 判断是否在选区内
+        let start = Instant::now();
+        let mut selected_cells = 0usize;
+        for _ in 0..iterations {
+            for line in 0..rows {
+                for col in 0..columns {
+                    let hit = selection
+                        .span_on_line(line, columns)
+                        .is_some_and(|span| span.contains(col));
+                    selected_cells += hit as usize;
+                }
+            }
+        }
+        let per_cell = start.elapsed();
+
+        // 每帧换算一次行区间，整行选中的行不再逐列判断
+        let start = Instant::now();
+        let mut full_rows = 0usize;
+        for _ in 0..iterations {
+            for span in selection.spans(0, rows, columns).into_iter().flatten() {
+                if span.is_full_row(columns) {
+                    full_rows += 1;
+                }
+            }
+        }
+        let per_row = start.elapsed();
+
+        let start = Instant::now();
+        for _ in 0..iterations {
+            for line in 0..rows {
+                std::hint::black_box(compute_state_hash_for_line(line, &state));
+            }
+        }
+        let hashing = start.elapsed();
+
+        assert_eq!(full_rows, (rows - 2) * iterations);
+        println!("\n📊 [Full-screen selection {}×{} × {}]", columns, rows, iterations);
+        println!("   Per-cell checks: {:?} ({:?}/frame, {} cells)", per_cell, per_cell / iterations as u32, selected_cells);
+        println!("   Row spans:       {:?} ({:?}/frame)", per_row, per_row / iterations as u32);
+        println!("   State hash:      {:?} ({:?}/frame)", hashing, hashing / iterations as u32);
+    }
 }
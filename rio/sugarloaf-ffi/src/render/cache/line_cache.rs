@@ -1,6 +1,8 @@
+use std::hash::Hasher;
 use std::num::NonZeroUsize;
 use lru::LruCache;
 
+use crate::domain::SelectionSpan;
 use crate::render::layout::GlyphInfo;
 use rio_backend::ansi::CursorShape;
 
@@ -51,17 +53,40 @@ pub struct CursorInfo {
     pub color: [f32; 4],
 }
 
-/// 选区信息（用于渲染时动态覆盖背景色）
-#[derive(Debug, Clone, Copy)]
+/// 选区在本行的覆盖信息（参与 state hash）
+///
+/// 由 SelectionView 按行换算一次得到，整行选中时不再区分具体列，
+/// 选区在中间行上扩展/收缩时这些行的 state hash 保持不变
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
 pub struct SelectionInfo {
     /// 选区起始列
     pub start_col: usize,
-    /// 选区结束列
+    /// 选区结束列（包含）
     pub end_col: usize,
-    /// 选区前景色 (RGBA)
-    pub fg_color: [f32; 4],
-    /// 选区背景色 (RGBA)
-    pub bg_color: [f32; 4],
+    /// 整行选中
+    pub full_row: bool,
+}
+
+impl SelectionInfo {
+    pub fn new(span: SelectionSpan, columns: usize) -> Self {
+        Self {
+            start_col: span.start_col,
+            end_col: span.end_col,
+            full_row: span.is_full_row(columns),
+        }
+    }
+
+    /// 写入 state hash
+    #[inline]
+    pub fn hash_into<H: Hasher>(&self, hasher: &mut H) {
+        if self.full_row {
+            hasher.write_u8(4); // 标记整行选中
+        } else {
+            hasher.write_usize(self.start_col);
+            hasher.write_usize(self.end_col);
+            hasher.write_u8(3); // 标记有选区
+        }
+    }
 }
 
 /// 搜索匹配信息（用于渲染时动态覆盖背景色）
@@ -182,9 +207,8 @@ impl LineCache {
         self.cache.len()
     }
 
-    /// 获取内存统计信息（用于调试）
+    /// 获取内存统计信息（调试日志和内存预算使用）
     /// 返回：(条目数, 图像数, 最大条目数, 估算内存字节数)
-    #[allow(dead_code)]
     pub fn memory_stats(&self) -> (usize, usize, usize, usize) {
         let entries = self.cache.len();
         let mut images = 0usize;
@@ -5,7 +5,13 @@ mod glyph;
 mod text_shaper;
 
 
+mod run_cache;
+
+
 pub use glyph::GlyphInfo;
 
 
 pub use text_shaper::TextShaper;
+
+
+pub use run_cache::RunCacheStats;
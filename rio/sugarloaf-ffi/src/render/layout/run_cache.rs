@@ -0,0 +1,248 @@
+
+use sugarloaf::layout::FragmentStyle;
+use skia_safe::Font;
+use std::collections::HashMap;
+use std::hash::{Hash, Hasher};
+use std::sync::Arc;
+
+/// 运行缓存最大条目数（超出后整体清空，避免无界增长）
+///
+/// 提示符片段、状态栏、文件树等持久内容通常只有几百个不同的 run，
+/// 4096 足够覆盖多终端场景下的工作集。
+const MAX_RUN_ENTRIES: usize = 4096;
+
+/// 文本运行缓存 key
+///
+/// 只包含影响"字体选择 + 定位"的属性：
+/// - 颜色、背景色、装饰不影响整形结果，命中后再按 fragment 样式套用
+/// - 浮点数按 bit 存储，保证 Hash/Eq 语义稳定
+#[derive(Hash, Eq, PartialEq, Clone, Copy, Debug)]
+pub struct RunKey {
+    font_id: usize,
+    font_size_bits: u32,
+    cell_width_bits: u32,
+    char_width_bits: u32,
+    font_attrs: u32,
+    text_hash: u64,
+}
+
+impl RunKey {
+    pub fn new(text: &str, style: &FragmentStyle, font_size: f32, cell_width: f32) -> Self {
+        let mut hasher = std::collections::hash_map::DefaultHasher::new();
+        text.hash(&mut hasher);
+
+        Self {
+            font_id: style.font_id,
+            font_size_bits: font_size.to_bits(),
+            cell_width_bits: cell_width.to_bits(),
+            char_width_bits: style.width.to_bits(),
+            font_attrs: style.font_attrs.0,
+            text_hash: hasher.finish(),
+        }
+    }
+}
+
+/// 已定位的字形（x 相对于 run 起点）
+#[derive(Clone)]
+pub struct RunGlyph {
+    pub grapheme: String,
+    pub font: Font,
+    pub x: f32,
+}
+
+/// 已整形 + 定位的文本运行
+pub struct ShapedRun {
+    /// 原始文本（命中时校验，防止 hash 碰撞）
+    text: Box<str>,
+    pub glyphs: Vec<RunGlyph>,
+    /// run 总宽度（像素），用于推进下一个 fragment 的起点
+    pub advance: f32,
+}
+
+impl ShapedRun {
+    pub fn new(text: &str, glyphs: Vec<RunGlyph>, advance: f32) -> Self {
+        Self {
+            text: text.into(),
+            glyphs,
+            advance,
+        }
+    }
+}
+
+/// 运行缓存统计（用于 profiling）
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct RunCacheStats {
+    pub hits: u64,
+    pub misses: u64,
+    pub entries: usize,
+}
+
+impl RunCacheStats {
+    /// 命中率（0.0 - 1.0）
+    pub fn hit_rate(&self) -> f32 {
+        let total = self.hits + self.misses;
+        if total == 0 {
+            0.0
+        } else {
+            self.hits as f32 / total as f32
+        }
+    }
+}
+
+/// 文本运行缓存
+///
+/// 按 (font_id, 字号, 样式, 文本 hash) 缓存已整形、已定位的字形序列，
+/// 跨帧、跨行、跨终端复用。LineCache 以整行为粒度，一行中任意位置变化
+/// （如状态栏时钟）都会整行 miss；RunCache 以 fragment 为粒度，未变化的
+/// 片段直接复用，跳过字体 fallback 查找和定位。
+pub struct RunCache {
+    runs: HashMap<RunKey, Arc<ShapedRun>>,
+    hits: u64,
+    misses: u64,
+}
+
+impl RunCache {
+    pub fn new() -> Self {
+        Self {
+            runs: HashMap::new(),
+            hits: 0,
+            misses: 0,
+        }
+    }
+
+    /// 查找 run（文本不一致视为 miss）
+    pub fn get(&mut self, key: &RunKey, text: &str) -> Option<Arc<ShapedRun>> {
+        match self.runs.get(key) {
+            Some(run) if &*run.text == text => {
+                self.hits += 1;
+                Some(Arc::clone(run))
+            }
+            _ => {
+                self.misses += 1;
+                None
+            }
+        }
+    }
+
+    /// 插入 run
+    pub fn insert(&mut self, key: RunKey, run: ShapedRun) -> Arc<ShapedRun> {
+        if self.runs.len() >= MAX_RUN_ENTRIES {
+            self.runs.clear();
+        }
+        let run = Arc::new(run);
+        self.runs.insert(key, Arc::clone(&run));
+        run
+    }
+
+    /// 获取统计信息
+    pub fn stats(&self) -> RunCacheStats {
+        RunCacheStats {
+            hits: self.hits,
+            misses: self.misses,
+            entries: self.runs.len(),
+        }
+    }
+
+    /// 清空缓存（字体库变化时调用）
+    pub fn clear(&mut self) {
+        self.runs.clear();
+    }
+}
+
+impl Default for RunCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn make_run(text: &str) -> ShapedRun {
+        let glyphs = text
+            .chars()
+            .enumerate()
+            .map(|(i, ch)| RunGlyph {
+                grapheme: ch.to_string(),
+                font: Font::default(),
+                x: i as f32 * 8.0,
+            })
+            .collect::<Vec<_>>();
+        let advance = glyphs.len() as f32 * 8.0;
+        ShapedRun::new(text, glyphs, advance)
+    }
+
+    #[test]
+    fn test_run_key_ignores_color() {
+        let style = FragmentStyle::default();
+        let mut colored = FragmentStyle::default();
+        colored.color = [1.0, 0.0, 0.0, 1.0];
+        colored.background_color = Some([0.0, 0.0, 1.0, 1.0]);
+
+        // 颜色不影响整形，key 相同
+        assert_eq!(
+            RunKey::new("hello", &style, 14.0, 8.0),
+            RunKey::new("hello", &colored, 14.0, 8.0)
+        );
+
+        // 字号 / cell 宽度 / 文本不同，key 不同
+        assert_ne!(
+            RunKey::new("hello", &style, 14.0, 8.0),
+            RunKey::new("hello", &style, 16.0, 8.0)
+        );
+        assert_ne!(
+            RunKey::new("hello", &style, 14.0, 8.0),
+            RunKey::new("hello", &style, 14.0, 9.0)
+        );
+        assert_ne!(
+            RunKey::new("hello", &style, 14.0, 8.0),
+            RunKey::new("hellO", &style, 14.0, 8.0)
+        );
+    }
+
+    #[test]
+    fn test_run_cache_hit_miss() {
+        let mut cache = RunCache::new();
+        let style = FragmentStyle::default();
+        let key = RunKey::new("$ ls", &style, 14.0, 8.0);
+
+        assert!(cache.get(&key, "$ ls").is_none());
+        cache.insert(key, make_run("$ ls"));
+
+        let run = cache.get(&key, "$ ls").expect("should hit");
+        assert_eq!(run.glyphs.len(), 4);
+        assert_eq!(run.advance, 32.0);
+
+        let stats = cache.stats();
+        assert_eq!(stats.hits, 1);
+        assert_eq!(stats.misses, 1);
+        assert_eq!(stats.entries, 1);
+        assert_eq!(stats.hit_rate(), 0.5);
+    }
+
+    #[test]
+    fn test_run_cache_text_mismatch_is_miss() {
+        let mut cache = RunCache::new();
+        let style = FragmentStyle::default();
+        let key = RunKey::new("abc", &style, 14.0, 8.0);
+        cache.insert(key, make_run("abc"));
+
+        // 模拟 hash 碰撞：同一 key，不同文本
+        assert!(cache.get(&key, "xyz").is_none());
+        assert_eq!(cache.stats().misses, 1);
+    }
+
+    #[test]
+    fn test_run_cache_bounded() {
+        let mut cache = RunCache::new();
+        let style = FragmentStyle::default();
+
+        for i in 0..(MAX_RUN_ENTRIES + 10) {
+            let text = format!("run{}", i);
+            cache.insert(RunKey::new(&text, &style, 14.0, 8.0), make_run(&text));
+        }
+
+        assert!(cache.stats().entries <= MAX_RUN_ENTRIES);
+    }
+}
@@ -1,21 +1,28 @@
 
 use super::GlyphInfo;
+use super::run_cache::{RunCache, RunCacheStats, RunGlyph, RunKey, ShapedRun};
 use crate::render::font::FontContext;
 use crate::render::cache::GlyphLayout;
 use crate::domain::state::TerminalState;
-use sugarloaf::layout::BuilderLine;
+use sugarloaf::layout::{BuilderLine, FragmentData};
 use skia_safe::{Font, Color4f};
+use std::cell::RefCell;
 use std::sync::Arc;
 
 /// 文本整形器（Text Shaper）
 /// 复用老代码的 generate_line_layout 逻辑（1364-1441 行）
 pub struct TextShaper {
     font_context: Arc<FontContext>,
+    /// 文本运行缓存（Renderer 由 TerminalPool 内所有终端共享，缓存随之共享）
+    run_cache: RefCell<RunCache>,
 }
 
 impl TextShaper {
     pub fn new(font_context: Arc<FontContext>) -> Self {
-        Self { font_context }
+        Self {
+            font_context,
+            run_cache: RefCell::new(RunCache::new()),
+        }
     }
 
     /// 为一行生成字形布局
@@ -36,104 +43,42 @@ impl TextShaper {
         let mut x = 0.0;
 
         for fragment in &line.fragments {
-            // 1. 获取 fragment 的样式字体（基于 fragment.style.font_id）
-            let styled_typeface = self.font_context.get_typeface_for_font_id(fragment.style.font_id);
-            let styled_font = styled_typeface
-                .as_ref()
-                .map(|tf| Font::from_typeface(tf, font_size))
-                .unwrap_or_else(|| self.font_context.get_primary_font(font_size));
-
-            let fragment_cell_width = fragment.style.width;
-            let chars_vec: Vec<char> = fragment.content.chars().collect();
-            let mut i = 0;
-
-            // 2. 遍历字符（完整复用 1389-1431 行逻辑）
-            while i < chars_vec.len() {
-                let ch = chars_vec[i];
-
-                // ===== VS16/VS15/Keycap 检测（1392-1394 行）=====
-                let next_is_vs16 = chars_vec.get(i + 1) == Some(&'\u{FE0F}');
-                let next_is_vs15 = chars_vec.get(i + 1) == Some(&'\u{FE0E}');
-                let is_keycap_sequence = next_is_vs16 && chars_vec.get(i + 2) == Some(&'\u{20E3}');
-
-                // ===== 跳过 selector 本身（1396-1399 行）=====
-                if ch == '\u{FE0F}' || ch == '\u{FE0E}' || ch == '\u{20E3}' {
-                    i += 1;
-                    continue;
+            // 1. 查询运行缓存（命中则跳过字体选择和定位）
+            let key = RunKey::new(&fragment.content, &fragment.style, font_size, cell_width);
+            let cached = self.run_cache.borrow_mut().get(&key, &fragment.content);
+            let run = match cached {
+                Some(run) => run,
+                None => {
+                    let run = self.shape_fragment(fragment, font_size, cell_width);
+                    self.run_cache.borrow_mut().insert(key, run)
                 }
-
-                // ===== 字体选择优先级（1401-1416 行）=====
-                let (best_font, _is_emoji) = if is_keycap_sequence {
-                    // 优先级 1: Keycap → 直接获取 emoji 字体（不检查字符）
-                    // 因为 keycap 的基础字符是 ASCII 数字，Apple Color Emoji 没有单独的数字字形
-                    if let Some(emoji_font) = self.font_context.get_emoji_font(font_size) {
-                        (emoji_font, true)
-                    } else {
-                        self.font_context.find_font_for_char(ch, font_size, &styled_font)
-                    }
-                } else if next_is_vs16 {
-                    // 优先级 2: VS16 emoji → 尝试匹配 emoji 字体
-                    if let Some(emoji_font) = self.font_context.find_emoji_font(ch, font_size) {
-                        (emoji_font, true)
-                    } else {
-                        self.font_context.find_font_for_char(ch, font_size, &styled_font)
-                    }
-                } else if (ch as u32) >= 0x80 {
-                    // 优先级 2: 非 ASCII → 使用 fallback 查找
-                    self.font_context.find_font_for_char(ch, font_size, &styled_font)
-                } else {
-                    // 优先级 3: ASCII → 直接使用 styled_font
-                    (styled_font.clone(), false)
-                };
-
-                // ===== 构建完整 grapheme cluster（用于渲染）=====
-                let grapheme = if is_keycap_sequence {
-                    // Keycap sequence: "2\u{FE0F}\u{20E3}"
-                    format!("{}\u{FE0F}\u{20E3}", ch)
-                } else if next_is_vs16 {
-                    // VS16 emoji: "❤\u{FE0F}"
-                    format!("{}\u{FE0F}", ch)
-                } else {
-                    // 普通字符: "A", "中", "1"
-                    ch.to_string()
-                };
-
-                // ===== 记录字形（1418-1422 行）=====
-                // 从 fragment.style 获取颜色
-                let color = Color4f::new(
-                    fragment.style.color[0],
-                    fragment.style.color[1],
-                    fragment.style.color[2],
-                    fragment.style.color[3],
-                );
-                let background_color = fragment.style.background_color.map(|c| {
-                    Color4f::new(c[0], c[1], c[2], c[3])
-                });
-
-                // ===== 根据 font_attrs 选择正确的字体变体 =====
-                let final_font = self.font_context.apply_font_attrs(&best_font, &fragment.style.font_attrs, font_size);
-
+            };
+
+            // 2. 从 fragment.style 获取颜色（颜色/装饰不参与缓存 key）
+            let color = Color4f::new(
+                fragment.style.color[0],
+                fragment.style.color[1],
+                fragment.style.color[2],
+                fragment.style.color[3],
+            );
+            let background_color = fragment.style.background_color.map(|c| {
+                Color4f::new(c[0], c[1], c[2], c[3])
+            });
+
+            glyphs.reserve(run.glyphs.len());
+            for run_glyph in &run.glyphs {
                 glyphs.push(GlyphInfo {
-                    grapheme,
-                    font: final_font,
-                    x,
+                    grapheme: run_glyph.grapheme.clone(),
+                    font: run_glyph.font.clone(),
+                    x: x + run_glyph.x,
                     color,
                     background_color,
-                    width: fragment_cell_width,
+                    width: fragment.style.width,
                     decoration: fragment.style.decoration,  // 传递装饰信息
                 });
-
-                x += cell_width * fragment_cell_width;
-
-                // ===== 索引增量（1424-1430 行）=====
-                if is_keycap_sequence {
-                    i += 3;  // 跳过 ch + VS16 + keycap
-                } else if next_is_vs16 || next_is_vs15 {
-                    i += 2;  // 跳过 ch + selector
-                } else {
-                    i += 1;  // 普通字符
-                }
             }
+
+            x += run.advance;
         }
 
         // 注意：光标/选区/搜索等状态信息不在这里计算
@@ -141,6 +86,108 @@ impl TextShaper {
 
         GlyphLayout { glyphs }
     }
+
+    /// 获取运行缓存统计
+    pub fn run_cache_stats(&self) -> RunCacheStats {
+        self.run_cache.borrow().stats()
+    }
+
+    /// 清空运行缓存
+    pub fn clear_run_cache(&self) {
+        self.run_cache.borrow_mut().clear();
+    }
+
+    /// 整形单个 fragment，字形 x 坐标相对于 fragment 起点
+    fn shape_fragment(&self, fragment: &FragmentData, font_size: f32, cell_width: f32) -> ShapedRun {
+        let mut glyphs = Vec::new();
+        let mut x = 0.0;
+
+        // 1. 获取 fragment 的样式字体（基于 fragment.style.font_id）
+        let styled_typeface = self.font_context.get_typeface_for_font_id(fragment.style.font_id);
+        let styled_font = styled_typeface
+            .as_ref()
+            .map(|tf| Font::from_typeface(tf, font_size))
+            .unwrap_or_else(|| self.font_context.get_primary_font(font_size));
+
+        let fragment_cell_width = fragment.style.width;
+        let chars_vec: Vec<char> = fragment.content.chars().collect();
+        let mut i = 0;
+
+        // 2. 遍历字符（完整复用 1389-1431 行逻辑）
+        while i < chars_vec.len() {
+            let ch = chars_vec[i];
+
+            // ===== VS16/VS15/Keycap 检测（1392-1394 行）=====
+            let next_is_vs16 = chars_vec.get(i + 1) == Some(&'\u{FE0F}');
+            let next_is_vs15 = chars_vec.get(i + 1) == Some(&'\u{FE0E}');
+            let is_keycap_sequence = next_is_vs16 && chars_vec.get(i + 2) == Some(&'\u{20E3}');
+
+            // ===== 跳过 selector 本身（1396-1399 行）=====
+            if ch == '\u{FE0F}' || ch == '\u{FE0E}' || ch == '\u{20E3}' {
+                i += 1;
+                continue;
+            }
+
+            // ===== 字体选择优先级（1401-1416 行）=====
+            let (best_font, _is_emoji) = if is_keycap_sequence {
+                // 优先级 1: Keycap → 直接获取 emoji 字体（不检查字符）
+                // 因为 keycap 的基础字符是 ASCII 数字，Apple Color Emoji 没有单独的数字字形
+                if let Some(emoji_font) = self.font_context.get_emoji_font(font_size) {
+                    (emoji_font, true)
+                } else {
+                    self.font_context.find_font_for_char(ch, font_size, &styled_font)
+                }
+            } else if next_is_vs16 {
+                // 优先级 2: VS16 emoji → 尝试匹配 emoji 字体
+                if let Some(emoji_font) = self.font_context.find_emoji_font(ch, font_size) {
+                    (emoji_font, true)
+                } else {
+                    self.font_context.find_font_for_char(ch, font_size, &styled_font)
+                }
+            } else if (ch as u32) >= 0x80 {
+                // 优先级 2: 非 ASCII → 使用 fallback 查找
+                self.font_context.find_font_for_char(ch, font_size, &styled_font)
+            } else {
+                // 优先级 3: ASCII → 直接使用 styled_font
+                (styled_font.clone(), false)
+            };
+
+            // ===== 构建完整 grapheme cluster（用于渲染）=====
+            let grapheme = if is_keycap_sequence {
+                // Keycap sequence: "2\u{FE0F}\u{20E3}"
+                format!("{}\u{FE0F}\u{20E3}", ch)
+            } else if next_is_vs16 {
+                // VS16 emoji: "❤\u{FE0F}"
+                format!("{}\u{FE0F}", ch)
+            } else {
+                // 普通字符: "A", "中", "1"
+                ch.to_string()
+            };
+
+            // ===== 根据 font_attrs 选择正确的字体变体 =====
+            let final_font = self.font_context.apply_font_attrs(&best_font, &fragment.style.font_attrs, font_size);
+
+            // ===== 记录字形（1418-1422 行）=====
+            glyphs.push(RunGlyph {
+                grapheme,
+                font: final_font,
+                x,
+            });
+
+            x += cell_width * fragment_cell_width;
+
+            // ===== 索引增量（1424-1430 行）=====
+            if is_keycap_sequence {
+                i += 3;  // 跳过 ch + VS16 + keycap
+            } else if next_is_vs16 || next_is_vs15 {
+                i += 2;  // 跳过 ch + selector
+            } else {
+                i += 1;  // 普通字符
+            }
+        }
+
+        ShapedRun::new(&fragment.content, glyphs, x)
+    }
 }
 
 #[cfg(test)]
@@ -261,4 +308,119 @@ mod tests {
         assert_eq!(layout.glyphs[2].x, 16.0);
         assert_eq!(layout.glyphs[3].x, 24.0);
     }
+
+    fn create_styled_line(parts: &[(&str, [f32; 4])]) -> BuilderLine {
+        BuilderLine {
+            fragments: parts
+                .iter()
+                .map(|(content, color)| FragmentData {
+                    content: content.to_string(),
+                    style: FragmentStyle {
+                        color: *color,
+                        ..FragmentStyle::default()
+                    },
+                })
+                .collect(),
+            ..Default::default()
+        }
+    }
+
+    #[test]
+    fn test_run_cache_reuses_fragments() {
+        let shaper = create_test_shaper();
+        let state = create_test_state();
+        let white = [1.0, 1.0, 1.0, 1.0];
+        let green = [0.0, 1.0, 0.0, 1.0];
+
+        // 状态栏：只有时钟片段变化
+        let line1 = create_styled_line(&[("NORMAL ", white), ("main.rs ", green), ("12:00", white)]);
+        let line2 = create_styled_line(&[("NORMAL ", white), ("main.rs ", green), ("12:01", white)]);
+
+        shaper.shape_line(&line1, 14.0, 8.0, 0, &state);
+        let stats = shaper.run_cache_stats();
+        assert_eq!(stats.misses, 3);
+        assert_eq!(stats.hits, 0);
+
+        let layout = shaper.shape_line(&line2, 14.0, 8.0, 0, &state);
+        let stats = shaper.run_cache_stats();
+        assert_eq!(stats.hits, 2);
+        assert_eq!(stats.misses, 4);
+
+        // 复用的 run 按 fragment 起点偏移，颜色按 fragment 样式套用
+        assert_eq!(layout.glyphs.len(), 20);
+        assert_eq!(layout.glyphs[7].grapheme, "m");
+        assert_eq!(layout.glyphs[7].x, 56.0);
+        assert_eq!(layout.glyphs[7].color, Color4f::new(0.0, 1.0, 0.0, 1.0));
+        assert_eq!(layout.glyphs[19].grapheme, "1");
+        assert_eq!(layout.glyphs[19].x, 152.0);
+    }
+
+    #[test]
+    fn test_run_cache_matches_uncached_layout() {
+        let shaper = create_test_shaper();
+        let state = create_test_state();
+        let line = create_test_line("A❤️1️⃣B世界");
+
+        let first = shaper.shape_line(&line, 14.0, 8.0, 0, &state);
+        let second = shaper.shape_line(&line, 14.0, 8.0, 0, &state);
+
+        assert_eq!(shaper.run_cache_stats().hits, 1);
+        assert_eq!(first.glyphs.len(), second.glyphs.len());
+        for (a, b) in first.glyphs.iter().zip(second.glyphs.iter()) {
+            assert_eq!(a.grapheme, b.grapheme);
+            assert_eq!(a.x, b.x);
+            assert_eq!(a.font.size(), b.font.size());
+            assert_eq!(a.font.typeface().unique_id(), b.font.typeface().unique_id());
+        }
+
+        // 字号变化不复用
+        shaper.shape_line(&line, 16.0, 8.0, 0, &state);
+        assert_eq!(shaper.run_cache_stats().entries, 2);
+    }
+
+    #[test]
+    fn bench_run_cache_prompt_lines() {
+        use std::time::Instant;
+
+        // 典型场景：提示符 + 文件树，跨帧内容不变但整行 hash 变化
+        let shaper = create_test_shaper();
+        let state = create_test_state();
+        let white = [1.0, 1.0, 1.0, 1.0];
+        let blue = [0.3, 0.5, 1.0, 1.0];
+        let lines: Vec<BuilderLine> = (0..24)
+            .map(|i| {
+                create_styled_line(&[
+                    ("├── ", white),
+                    ("src/render/layout ", blue),
+                    ("文件树 ", white),
+                    (if i % 2 == 0 { "✓" } else { "✗" }, white),
+                ])
+            })
+            .collect();
+
+        let iterations = 200;
+
+        let start = Instant::now();
+        for _ in 0..iterations {
+            shaper.clear_run_cache();
+            for line in &lines {
+                shaper.shape_line(line, 14.0, 8.0, 0, &state);
+            }
+        }
+        let uncached = start.elapsed();
+
+        let start = Instant::now();
+        for _ in 0..iterations {
+            for line in &lines {
+                shaper.shape_line(line, 14.0, 8.0, 0, &state);
+            }
+        }
+        let cached = start.elapsed();
+        let stats = shaper.run_cache_stats();
+
+        println!("\n📊 [Run cache 24 lines × {}]", iterations);
+        println!("   Uncached: {:?} ({:?}/frame)", uncached, uncached / iterations);
+        println!("   Cached:   {:?} ({:?}/frame)", cached, cached / iterations);
+        println!("   Run cache: {} hits, {} misses, hit rate {:.1}%", stats.hits, stats.misses, stats.hit_rate() * 100.0);
+    }
 }
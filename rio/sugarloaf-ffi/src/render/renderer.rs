@@ -91,6 +91,11 @@ impl Renderer {
         self.glyph_atlas.stats()
     }
 
+    /// 获取文本运行缓存统计（命中率用于 profiling）
+    pub fn run_cache_stats(&self) -> super::layout::RunCacheStats {
+        self.text_shaper.run_cache_stats()
+    }
+
     /// 渲染一行
     ///
     /// # 参数
@@ -516,41 +521,27 @@ impl Renderer {
             None
         };
 
-        // 🔧 计算搜索高亮信息（从 state 动态计算）
-        // 🐛 调试日志：验证搜索状态是否正确传递
-        if state.search.is_some() {
-            eprintln!("🔍 [render_with_atlas] Line {} has search state with {} matches",
-                line, state.search.as_ref().unwrap().matches.len());
-        }
+        // 🔧 计算搜索高亮信息（读取 SearchView 预先换算好的行内区间）
         let search_ranges: Vec<(usize, usize, bool)> = if let Some(search) = &state.search {
             let abs_line = state.grid.history_size()
                 .saturating_add(line)
                 .saturating_sub(state.grid.display_offset());
 
-            if let Some(indices) = search.get_matches_at_line(abs_line) {
-                indices.iter().map(|&idx| {
-                    let m = &search.matches[idx];
-                    let is_focused = idx == search.focused_index;
-                    let start_col = if abs_line == m.start.line { m.start.col } else { 0 };
-                    let end_col = if abs_line == m.end.line { m.end.col } else { usize::MAX };
-                    (start_col, end_col, is_focused)
-                }).collect()
-            } else {
-                Vec::new()
-            }
+            search.get_matches_at_line(abs_line).map_or_else(Vec::new, |spans| {
+                spans.iter()
+                    .map(|span| (span.start_col, span.end_col, search.is_focused(span)))
+                    .collect()
+            })
         } else {
             Vec::new()
         };
 
-        // 🐛 调试日志：显示当前行的搜索匹配范围
-        if !search_ranges.is_empty() {
-            eprintln!("🔍 [render_with_atlas] Line {} search_ranges: {:?}", line, search_ranges);
-        }
-
         // 预填充 Atlas + 收集绘制数据（仅普通字符）
         let mut xforms: Vec<skia_safe::RSXform> = Vec::with_capacity(layout.glyphs.len());
         let mut tex_rects: Vec<Rect> = Vec::with_capacity(layout.glyphs.len());
         let mut colors: Vec<skia_safe::Color> = Vec::with_capacity(layout.glyphs.len());
+        let mut atlas_keys: Vec<super::cache::GlyphKey> = Vec::with_capacity(layout.glyphs.len());
+        let atlas_generation = self.glyph_atlas.generation();
 
         // 收集需要单独渲染的 emoji（带列号，用于搜索高亮）
         let mut emoji_glyphs: Vec<(usize, &super::layout::GlyphInfo)> = Vec::new();
@@ -643,6 +634,7 @@ impl Renderer {
                     // y_offset = 0 因为 bitmap 中已经按 baseline_offset 定位了字形
                     xforms.push(skia_safe::RSXform::new(1.0, 0.0, skia_safe::Vector::new(glyph.x - x_offset, 0.0)));
                     tex_rects.push(region.to_src_rect());
+                    atlas_keys.push(key);
 
                     // 确定前景色（搜索高亮优先）
                     let fg_color = if let Some(is_focused) = search_match {
@@ -665,6 +657,22 @@ impl Renderer {
             }
         }
 
+        // Atlas 在本行绘制过程中被整理/清空过：之前收集的区域已失效，按 key 重新查询
+        if self.glyph_atlas.generation() != atlas_generation {
+            let mut kept = 0;
+            for i in 0..atlas_keys.len() {
+                if let Some(region) = self.glyph_atlas.get(&atlas_keys[i]) {
+                    xforms[kept] = xforms[i];
+                    tex_rects[kept] = region.to_src_rect();
+                    colors[kept] = colors[i];
+                    kept += 1;
+                }
+            }
+            xforms.truncate(kept);
+            tex_rects.truncate(kept);
+            colors.truncate(kept);
+        }
+
         // 一次 draw_atlas 调用绘制所有普通字符
         if !xforms.is_empty() {
             let atlas_image = self.glyph_atlas.get_image();
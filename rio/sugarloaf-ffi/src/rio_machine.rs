@@ -8,17 +8,21 @@ use std::collections::VecDeque;
 use std::io::{self, ErrorKind, Read, Write};
 use std::sync::Arc;
 use std::thread::{Builder, JoinHandle};
-use std::time::Instant;
+use std::time::{Duration, Instant};
 
 use corcovado::channel;
 #[cfg(unix)]
 use corcovado::unix::UnixReady;
 use corcovado::{Events, PollOpt, Ready};
 
+use rio_backend::crosswords::grid::Dimensions;
 use rio_backend::crosswords::Crosswords;
+use rio_backend::event::paste::{Paste, PASTE_CHUNK_SIZE};
 use rio_backend::event::Msg;
 use rio_backend::performer::handler::Processor;
 
+use crate::infra::flow_control::{FlowControl, ReadReport};
+use crate::infra::pty_recording::PtyRecorder;
 use crate::infra::SharedLogBuffer;
 use teletypewriter::EventedPty;
 
@@ -43,6 +47,9 @@ const READ_BUFFER_SIZE: usize = 0x10_0000;
 /// 照抄 Rio: 锁定 terminal 时最大读取字节数
 const MAX_LOCKED_READ: usize = u16::MAX as usize;
 
+/// 每次 pty_write 最多写入的粘贴字节数，写满后回到事件循环，让交互输入插队
+const PASTE_WRITE_BUDGET: usize = 4 * PASTE_CHUNK_SIZE;
+
 /// 照抄 Rio: PeekableReceiver
 struct PeekableReceiver<T> {
     rx: channel::Receiver<T>,
@@ -106,10 +113,26 @@ impl Writing {
 pub struct State {
     write_list: VecDeque<Cow<'static, [u8]>>,
     writing: Option<Writing>,
+    /// 流式粘贴，排在交互输入之后按块写入
+    pastes: VecDeque<Paste>,
     parser: Processor,
 }
 
 impl State {
+    /// 排队交互输入，正在进行的粘贴让它先写
+    #[inline]
+    fn push_input(&mut self, input: Cow<'static, [u8]>) {
+        if let Some(paste) = self.pastes.front_mut() {
+            paste.yield_to_input();
+        }
+        self.write_list.push_back(input);
+    }
+
+    #[inline]
+    fn has_input(&self) -> bool {
+        self.writing.is_some() || !self.write_list.is_empty()
+    }
+
     #[inline]
     fn ensure_next(&mut self) {
         if self.writing.is_none() {
@@ -129,7 +152,7 @@ impl State {
 
     #[inline]
     fn needs_write(&self) -> bool {
-        self.writing.is_some() || !self.write_list.is_empty()
+        self.has_input() || !self.pastes.is_empty()
     }
 
     #[inline]
@@ -165,6 +188,10 @@ pub struct Machine<T: EventedPty> {
     log_buffer: SharedLogBuffer,
     /// 共享内存 ring buffer（daemon 模式下用于恢复屏幕）
     shared_ring: Option<SharedRingBuffer>,
+    /// PTY 字节流录制（可选，设置 ETERM_PTY_RECORD_DIR 时启用）
+    recorder: Option<PtyRecorder>,
+    /// 输出洪泛检测与读取限速
+    flow: FlowControl,
 }
 
 impl<T> Machine<T>
@@ -195,6 +222,14 @@ where
     ) -> Result<Machine<T>, Box<dyn std::error::Error>> {
         let (sender, receiver) = channel::channel();
         let poll = corcovado::Poll::new()?;
+        let recorder = {
+            let terminal = terminal.read();
+            PtyRecorder::from_env(
+                route_id,
+                terminal.grid.columns() as u16,
+                terminal.grid.screen_lines() as u16,
+            )
+        };
 
         Ok(Machine {
             sender,
@@ -210,6 +245,8 @@ where
             shell_pid,
             log_buffer,
             shared_ring,
+            recorder,
+            flow: FlowControl::new(Instant::now()),
         })
     }
 
@@ -248,19 +285,35 @@ where
     /// 照抄 Rio: Machine::pty_read
     ///
     /// 这是最关键的函数，从 PTY 读取数据并解析
+    ///
+    /// 返回 `true` 表示因 MAX_LOCKED_READ 或洪泛限速配额提前返回、PTY 中可能还有数据。
+    /// PTY 以边沿触发注册，不会再为这些数据产生新事件，调用方需要主动继续读取。
     #[inline]
-    fn pty_read(&mut self, state: &mut State, buf: &mut [u8]) -> io::Result<()> {
+    fn pty_read(&mut self, state: &mut State, buf: &mut [u8]) -> io::Result<bool> {
         let mut unprocessed = 0;
         let mut processed = 0;
+        let mut pending = false;
+
+        // 洪泛模式下只读本时间片剩余的配额，其余留在内核 PTY 缓冲区
+        let budget = self.flow.read_budget(Instant::now());
+        if budget == 0 {
+            return Ok(true);
+        }
+        let read_limit = budget.min(buf.len());
+        // 交给流控：解析耗时、是否抢锁、是否读空了内核缓冲区
+        let mut report = ReadReport::default();
 
         // RwLock 不需要 lease，parking_lot 的 RwLock 默认是公平的
         let mut terminal = None;
 
         loop {
             // 照抄 Rio: Read from the PTY.
-            match self.pty.reader().read(&mut buf[unprocessed..]) {
+            match self.pty.reader().read(&mut buf[unprocessed..read_limit]) {
                 // This is received on Windows/macOS when no more data is readable from the PTY.
-                Ok(0) if unprocessed == 0 => break,
+                Ok(0) if unprocessed == 0 => {
+                    report.drained = true;
+                    break;
+                }
                 Ok(got) => {
                     // ⚠️ [PERFORMANCE] 注释掉频繁的进程检测（每次PTY读取都调用proc_pidpath+ps命令，导致严重卡顿）
                     // 原因：处理64KB数据时可能触发几百次系统调用，累积耗时2-3.5秒
@@ -299,6 +352,7 @@ where
                     ErrorKind::Interrupted | ErrorKind::WouldBlock => {
                         // Go back to mio if we're caught up on parsing and the PTY would block.
                         if unprocessed == 0 {
+                            report.drained = true;
                             break;
                         }
                     }
@@ -313,14 +367,18 @@ where
                 None => {
                     let lock_acquired = match self.terminal.try_write() {
                         // Force block if we are at the buffer size limit.
-                        None if unprocessed >= READ_BUFFER_SIZE => {
+                        None if unprocessed >= read_limit => {
+                            report.contended = true;
                             perf_log!("🔒 [I/O Thread] try_write failed, forcing write lock...");
                             let t = self.terminal.write();
                             let elapsed = lock_start.elapsed().as_micros();
                             perf_log!("🔒 [I/O Thread] Acquired write lock after {}μs ({}ms)", elapsed, elapsed / 1000);
                             t
                         }
-                        None => continue,
+                        None => {
+                            report.contended = true;
+                            continue;
+                        }
                         Some(t) => {
                             let elapsed = lock_start.elapsed().as_micros();
                             if elapsed > 1000 {
@@ -348,10 +406,23 @@ where
                 crate::rust_log_info!("[perf] shm_write: {}ns for {} bytes", shm_ns, unprocessed);
             }
 
+            // 录制原始 PTY 字节流（如果启用），写失败时停止录制
+            if let Some(ref mut recorder) = self.recorder {
+                if let Err(e) = recorder.record(&buf[..unprocessed]) {
+                    crate::rust_log_warn!(
+                        "[PtyRecorder] write failed, recording stopped: {}",
+                        e
+                    );
+                    self.recorder = None;
+                }
+            }
+
             // 照抄 Rio: Parse the incoming bytes.
             let parse_start = std::time::Instant::now();
             state.parser.advance(&mut **terminal, &buf[..unprocessed]);
-            let parse_time = parse_start.elapsed().as_micros();
+            let parse_elapsed = parse_start.elapsed();
+            report.parse_time += parse_elapsed;
+            let parse_time = parse_elapsed.as_micros();
 
             if parse_time > 10000 {
                 perf_log!("🔒 [I/O Thread] parser.advance() took {}μs ({}ms) for {} bytes",
@@ -364,10 +435,25 @@ where
             // 照抄 Rio: Assure we're not blocking the terminal too long unnecessarily.
             if processed >= MAX_LOCKED_READ {
                 perf_log!("🔒 [I/O Thread] Releasing write lock after processing {} bytes (MAX_LOCKED_READ limit)", processed);
+                pending = true;
+                break;
+            }
+
+            if processed >= budget {
+                pending = true;
                 break;
             }
         }
 
+        report.bytes = processed;
+        if self.flow.record(report, Instant::now()) {
+            crate::rust_log_info!(
+                "[Machine-{}] output flood {}",
+                self.route_id,
+                if self.flow.is_flooding() { "detected, throttling reads" } else { "ended" }
+            );
+        }
+
         // 释放锁时打印日志
         if terminal.is_some() && processed > 0 {
             perf_log!("🔒 [I/O Thread] Releasing write lock after processing {} bytes total", processed);
@@ -382,7 +468,7 @@ where
                 .send_event(RioEvent::Wakeup(self.route_id));
         }
 
-        Ok(())
+        Ok(pending)
     }
 
     /// 照抄 Rio: Machine::drain_recv_channel
@@ -392,7 +478,10 @@ where
         while let Some(msg) = self.receiver.recv() {
             match msg {
                 Msg::Input(input) => {
-                    state.write_list.push_back(input);
+                    state.push_input(input);
+                }
+                Msg::Paste(paste) => {
+                    state.pastes.push_back(paste);
                 }
                 Msg::Resize(window_size) => {
                     eprintln!("[Machine-{}] Resize: cols={} rows={}",
@@ -412,27 +501,32 @@ where
     /// 照抄 Rio: Machine::channel_event
     ///
     /// Returns a `bool` indicating whether or not the event loop should continue running.
+    ///
+    /// channel 以边沿触发（非 oneshot）注册，处理完无需重新注册
     #[inline]
-    fn channel_event(&mut self, token: corcovado::Token, state: &mut State) -> bool {
-        if !self.drain_recv_channel(state) {
-            return false;
-        }
-
-        self.poll
-            .reregister(
-                &self.receiver.rx,
-                token,
-                Ready::readable(),
-                PollOpt::edge() | PollOpt::oneshot(),
-            )
-            .unwrap();
-
-        true
+    fn channel_event(&mut self, state: &mut State) -> bool {
+        self.drain_recv_channel(state)
     }
 
     /// 照抄 Rio: Machine::pty_write
+    ///
+    /// 先写交互输入，再按块写粘贴，每次最多写 PASTE_WRITE_BUDGET 字节的粘贴。
+    /// 返回 `true` 表示 PTY 写满（WouldBlock），需要等可写事件；返回 `false`
+    /// 且 `needs_write()` 仍为真时表示粘贴用完了本轮配额，调用方应尽快再写。
     #[inline]
-    fn pty_write(&mut self, state: &mut State) -> io::Result<()> {
+    fn pty_write(&mut self, state: &mut State) -> io::Result<bool> {
+        if state.has_input() {
+            // 粘贴写到一半时先把 bracketed paste 收尾，交互输入才不会混进粘贴内容
+            while let Some(paste) = state.pastes.front_mut() {
+                if paste.at_boundary() {
+                    break;
+                }
+                if Self::write_paste(self.pty.writer(), paste, usize::MAX)? == 0 {
+                    return Ok(true);
+                }
+            }
+        }
+
         state.ensure_next();
 
         'write_many: while let Some(mut current) = state.take_current() {
@@ -459,7 +553,49 @@ where
                 }
             }
         }
-        Ok(())
+        if state.has_input() {
+            return Ok(true);
+        }
+
+        let mut budget = PASTE_WRITE_BUDGET;
+        while let Some(paste) = state.pastes.front_mut() {
+            if paste.is_finished() {
+                state.pastes.pop_front();
+                continue;
+            }
+            if budget == 0 {
+                return Ok(false);
+            }
+            match Self::write_paste(self.pty.writer(), paste, budget)? {
+                0 => return Ok(true),
+                n => budget = budget.saturating_sub(n),
+            }
+        }
+        Ok(false)
+    }
+
+    /// 写一块粘贴内容（最多 `limit` 字节），返回写入的字节数，0 表示 PTY 写满
+    #[inline]
+    fn write_paste(
+        writer: &mut impl Write,
+        paste: &mut Paste,
+        limit: usize,
+    ) -> io::Result<usize> {
+        let chunk = paste.chunk();
+        let len = chunk.len().min(limit);
+        loop {
+            match writer.write(&chunk[..len]) {
+                Ok(n) => {
+                    paste.advance(n);
+                    return Ok(n);
+                }
+                Err(err) => match err.kind() {
+                    ErrorKind::Interrupted => continue,
+                    ErrorKind::WouldBlock => return Ok(0),
+                    _ => return Err(err),
+                },
+            }
+        }
     }
 
     /// 获取消息发送通道
@@ -479,7 +615,10 @@ where
 
                 let mut tokens = (0..).map(Into::into);
 
-                let poll_opts = PollOpt::edge() | PollOpt::oneshot();
+                // 边沿触发、不使用 oneshot：事件处理完无需重新注册（省掉每轮读的
+                // epoll_ctl/kevent 调用），代价是每次都必须读到 WouldBlock，
+                // 否则剩余数据不会再触发事件，见 `read_pending`
+                let poll_opts = PollOpt::edge();
 
                 let channel_token = tokens.next().unwrap();
                 self.poll
@@ -498,6 +637,17 @@ where
 
                 let mut events = Events::with_capacity(1024);
 
+                // 当前注册的 PTY 兴趣，只在变化时才重新注册
+                let mut registered_interest = Ready::readable();
+
+                // pty_read 因 MAX_LOCKED_READ 提前返回，PTY 中还有未读数据
+                let mut read_pending = false;
+
+                // pty_write 遇到 WouldBlock，等下一个可写事件再写
+                let mut write_blocked = false;
+                // 粘贴用完了本轮配额但 PTY 仍可写，不会再有可写事件
+                let mut write_pending = false;
+
                 eprintln!("[Machine-{}] event loop started, pty_fd={}, shell_pid={}", self.route_id, self.pty_fd, self.shell_pid);
 
                 'event_loop: loop {
@@ -506,6 +656,20 @@ where
                     let timeout = handler
                         .sync_timeout()
                         .map(|st| st.saturating_duration_since(Instant::now()));
+                    // 还有数据待读写时不阻塞，只收集一下 channel 等其他事件；
+                    // 洪泛限速时等到下一个时间片再读，期间仍响应输入和 resize
+                    let throttle = if read_pending {
+                        self.flow.throttle_delay(Instant::now())
+                    } else {
+                        None
+                    };
+                    let timeout = if write_pending || (read_pending && throttle.is_none()) {
+                        Some(Duration::ZERO)
+                    } else if let Some(throttle) = throttle {
+                        Some(timeout.map_or(throttle, |t| t.min(throttle)))
+                    } else {
+                        timeout
+                    };
 
                     events.clear();
                     if let Err(err) = self.poll.poll(&mut events, timeout) {
@@ -519,7 +683,11 @@ where
                     }
 
                     // 照抄 Rio: Handle synchronized update timeout.
-                    if events.is_empty() && self.receiver.peek().is_none() {
+                    if events.is_empty()
+                        && self.receiver.peek().is_none()
+                        && !read_pending
+                        && !write_pending
+                    {
                         let mut terminal = self.terminal.write();
                         state.parser.stop_sync(&mut *terminal);
 
@@ -535,11 +703,13 @@ where
                         break;
                     }
 
+                    let mut pty_readable = read_pending;
+
                     for event in events.iter() {
                         match event.token() {
                             token if token == channel_token => {
                                 // 照抄 Rio: In case should shutdown by message
-                                if !self.channel_event(channel_token, &mut state) {
+                                if !self.channel_event(&mut state) {
                                     break 'event_loop;
                                 }
                             }
@@ -566,30 +736,19 @@ where
                                     continue;
                                 }
                                 if event.readiness().is_readable() {
-                                    if let Err(err) = self.pty_read(&mut state, &mut buf) {
-                                        // 照抄 Rio: On Linux, a `read` on the master side of a PTY can fail
-                                        // with `EIO` if the client side hangs up. In that case,
-                                        // just loop back round for the inevitable `Exited` event.
-                                        #[cfg(target_os = "linux")]
-                                        if err.raw_os_error() == Some(libc::EIO) {
-                                            continue;
-                                        }
-
-                                        eprintln!(
-                                            "[Machine-{}] Error reading from PTY in event loop: {}",
-                                            self.route_id, err
-                                        );
-                                        break 'event_loop;
-                                    }
+                                    pty_readable = true;
                                 }
 
                                 if event.readiness().is_writable() {
-                                    if let Err(err) = self.pty_write(&mut state) {
-                                        eprintln!(
-                                            "[Machine-{}] Error writing to PTY in event loop: {}",
-                                            self.route_id, err
-                                        );
-                                        break 'event_loop;
+                                    match self.pty_write(&mut state) {
+                                        Ok(blocked) => write_blocked = blocked,
+                                        Err(err) => {
+                                            eprintln!(
+                                                "[Machine-{}] Error writing to PTY in event loop: {}",
+                                                self.route_id, err
+                                            );
+                                            break 'event_loop;
+                                        }
                                     }
                                 }
                             }
@@ -597,12 +756,41 @@ where
                         }
                     }
 
+                    // 同一批事件里读写都处理完之后再读 PTY，read_pending 时没有新事件也要继续读。
+                    // 洪泛限速中本时间片配额已用完时先不读，保留 read_pending 等下一个时间片
+                    if pty_readable && self.flow.throttle_delay(Instant::now()).is_some() {
+                        read_pending = true;
+                    } else if pty_readable {
+                        match self.pty_read(&mut state, &mut buf) {
+                            Ok(pending) => read_pending = pending,
+                            Err(err) => {
+                                read_pending = false;
+
+                                // 照抄 Rio: On Linux, a `read` on the master side of a PTY can fail
+                                // with `EIO` if the client side hangs up. In that case,
+                                // just loop back round for the inevitable `Exited` event.
+                                #[cfg(target_os = "linux")]
+                                let hangup = err.raw_os_error() == Some(libc::EIO);
+                                #[cfg(not(target_os = "linux"))]
+                                let hangup = false;
+
+                                if !hangup {
+                                    eprintln!(
+                                        "[Machine-{}] Error reading from PTY in event loop: {}",
+                                        self.route_id, err
+                                    );
+                                    break 'event_loop;
+                                }
+                            }
+                        }
+                    }
+
                     // 🎯 处理 EventListener 队列中的事件（如 CPR 响应）
                     let queued_events = self.event_listener.queue().drain();
                     for event in queued_events {
                         match event {
                             crate::rio_event::RioEvent::PtyWrite(text) => {
-                                state.write_list.push_back(std::borrow::Cow::Owned(text.into_bytes()));
+                                state.push_input(std::borrow::Cow::Owned(text.into_bytes()));
                             }
                             _ => {
                                 // 其他事件不在这里处理（如 Wakeup、Render 等由 Swift 处理）
@@ -610,15 +798,35 @@ where
                         }
                     }
 
+                    // 边沿触发下，已注册写兴趣且本轮写到了 WouldBlock 之前就写完时，
+                    // 新排队的数据（如 CPR 响应）不会再等到可写事件，这里直接尝试写一次
+                    if state.needs_write() && !write_blocked {
+                        match self.pty_write(&mut state) {
+                            Ok(blocked) => write_blocked = blocked,
+                            Err(err) => {
+                                eprintln!(
+                                    "[Machine-{}] Error writing to PTY in event loop: {}",
+                                    self.route_id, err
+                                );
+                                break 'event_loop;
+                            }
+                        }
+                    }
+                    write_pending = state.needs_write() && !write_blocked;
+
                     // 照抄 Rio: Register write interest if necessary.
                     let mut interest = Ready::readable();
                     if state.needs_write() {
                         interest.insert(Ready::writable());
                     }
                     // 照抄 Rio: Reregister with new interest.
-                    self.pty
-                        .reregister(&self.poll, interest, poll_opts)
-                        .unwrap();
+                    // 只有兴趣变化时才重新注册
+                    if interest != registered_interest {
+                        self.pty
+                            .reregister(&self.poll, interest, poll_opts)
+                            .unwrap();
+                        registered_interest = interest;
+                    }
                 }
 
                 // 照抄 Rio: The evented instances are not dropped here so deregister them explicitly.
@@ -642,6 +850,16 @@ pub fn send_input(sender: &channel::Sender<Msg>, data: &[u8]) -> bool {
     result
 }
 
+/// 用于发送流式粘贴的辅助函数
+pub fn send_paste(sender: &channel::Sender<Msg>, paste: Paste) -> bool {
+    let len = paste.len();
+    let result = sender.send(Msg::Paste(paste)).is_ok();
+    if !result {
+        eprintln!("[send_paste] channel send FAILED ({} bytes)", len);
+    }
+    result
+}
+
 /// 用于发送 resize 消息的辅助函数
 pub fn send_resize(sender: &channel::Sender<Msg>, winsize: teletypewriter::WinsizeBuilder) -> bool {
     sender.send(Msg::Resize(winsize)).is_ok()
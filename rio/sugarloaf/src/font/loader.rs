@@ -527,7 +527,7 @@ impl Database {
                         font_index
                     );
                     return Some((
-                        Source::Binary(SharedData::new(bytes.to_vec())),
+                        Source::Binary(SharedData::from_arc(bytes)),
                         font_index,
                     ));
                 }
@@ -27,7 +27,7 @@ use parking_lot::RwLock;
 use rustc_hash::FxHashMap;
 use std::ops::Range;
 use std::path::PathBuf;
-use std::sync::{Arc, OnceLock};
+use std::sync::{Arc, OnceLock, Weak};
 
 pub use crate::font_introspector::{Style, Weight};
 
@@ -38,18 +38,105 @@ type FontDataCache = Arc<DashMap<PathBuf, SharedData>>;
 // This cache stores font file data indexed by path, so fonts are only loaded once
 // and shared across all font library instances. This significantly improves
 // performance when the same font is referenced multiple times.
+//
+// Entries are memory mapped, so keeping them alive costs address space rather
+// than private memory: the pages live in the page cache and are shared with
+// every other process mapping the same file.
 static FONT_DATA_CACHE: OnceLock<FontDataCache> = OnceLock::new();
 
+// Second level of the cache keyed by file identity instead of path. Different
+// paths resolving to the same file (symlinks, hard links, a family installed
+// in two font directories) share one mapping. Holds weak references so the
+// identity map never keeps a font alive on its own.
+#[cfg(not(target_arch = "wasm32"))]
+static FONT_FILE_REGISTRY: OnceLock<DashMap<FontFileKey, Weak<SharedBytes>>> =
+    OnceLock::new();
+
 fn get_font_data_cache() -> &'static FontDataCache {
     FONT_DATA_CACHE.get_or_init(|| Arc::new(DashMap::default()))
 }
 
+#[cfg(not(target_arch = "wasm32"))]
+fn get_font_file_registry() -> &'static DashMap<FontFileKey, Weak<SharedBytes>> {
+    FONT_FILE_REGISTRY.get_or_init(DashMap::default)
+}
+
 /// Clears the global font data cache, forcing fonts to be reloaded from disk
 /// on next access. This should be called when font configuration changes.
+///
+/// Fonts still referenced by a live `FontLibrary` keep their mapping; files
+/// that did not change on disk are picked up again from the identity map.
 pub fn clear_font_data_cache() {
     if let Some(cache) = FONT_DATA_CACHE.get() {
         cache.clear();
     }
+    #[cfg(not(target_arch = "wasm32"))]
+    if let Some(registry) = FONT_FILE_REGISTRY.get() {
+        registry.retain(|_, weak| weak.strong_count() > 0);
+    }
+}
+
+/// Font file identity: device and inode on unix (path elsewhere), plus size
+/// and modification time so a font rewritten in place is not served from a
+/// stale mapping.
+#[cfg(not(target_arch = "wasm32"))]
+#[derive(Clone, Debug, PartialEq, Eq, Hash)]
+struct FontFileKey {
+    #[cfg(unix)]
+    dev: u64,
+    #[cfg(unix)]
+    ino: u64,
+    #[cfg(not(unix))]
+    path: PathBuf,
+    len: u64,
+    modified: Option<std::time::SystemTime>,
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+impl FontFileKey {
+    #[cfg_attr(unix, allow(unused_variables))]
+    fn new(path: &std::path::Path, metadata: &std::fs::Metadata) -> Self {
+        #[cfg(unix)]
+        use std::os::unix::fs::MetadataExt;
+
+        Self {
+            #[cfg(unix)]
+            dev: metadata.dev(),
+            #[cfg(unix)]
+            ino: metadata.ino(),
+            #[cfg(not(unix))]
+            path: path.to_path_buf(),
+            len: metadata.len(),
+            modified: metadata.modified().ok(),
+        }
+    }
+}
+
+/// Memory held by font data loaded from disk.
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct FontDataStats {
+    /// Number of distinct font files currently alive.
+    pub files: usize,
+    /// Bytes backed by file mappings (shared page cache, not private memory).
+    pub mapped_bytes: usize,
+    /// Bytes copied onto the heap (mapping failed or not supported).
+    pub heap_bytes: usize,
+}
+
+/// Reports the font files currently kept alive by any `FontLibrary`.
+#[cfg(not(target_arch = "wasm32"))]
+pub fn font_data_stats() -> FontDataStats {
+    let mut stats = FontDataStats::default();
+    for entry in get_font_file_registry().iter() {
+        if let Some(bytes) = entry.value().upgrade() {
+            stats.files += 1;
+            match &*bytes {
+                SharedBytes::Mapped(map) => stats.mapped_bytes += map.len(),
+                other => stats.heap_bytes += other.as_slice().len(),
+            }
+        }
+    }
+    stats
 }
 
 pub fn lookup_for_font_match(
@@ -415,7 +502,7 @@ impl FontLibraryData {
 
         // 提权 Nerd Font Symbols，放在 emoji 字体之前
         // 原因：Nerd Font 包含大量终端符号的单色版本，应优先于彩色 emoji 字体
-        self.insert(FontData::from_slice(FONT_SYMBOLS_NERD_FONT_MONO, false).unwrap());
+        self.insert(FontData::from_static(FONT_SYMBOLS_NERD_FONT_MONO, false).unwrap());
 
         if let Some(emoji_font) = spec.emoji.clone() {
             // PATCH: emoji 字体设置 evictable=false，确保数据被保留
@@ -518,7 +605,7 @@ impl FontLibraryData {
 
     #[cfg(target_arch = "wasm32")]
     pub fn load(&mut self, _font_spec: SugarloafFonts) -> Vec<SugarloafFont> {
-        self.insert(FontData::from_slice(FONT_CASCADIAMONO_REGULAR, false).unwrap());
+        self.insert(FontData::from_static(FONT_CASCADIAMONO_REGULAR, false).unwrap());
 
         vec![]
     }
@@ -527,29 +614,83 @@ impl FontLibraryData {
 /// Atomically reference counted, heap allocated or memory mapped buffer.
 #[derive(Clone, Debug)]
 pub struct SharedData {
-    inner: Arc<[u8]>,
+    inner: Arc<SharedBytes>,
+}
+
+#[derive(Debug)]
+enum SharedBytes {
+    Heap(Box<[u8]>),
+    /// Bytes already shared elsewhere (e.g. font-kit memory handles).
+    Shared(Arc<Vec<u8>>),
+    /// Fonts embedded in the binary.
+    Static(&'static [u8]),
+    /// Read-only private mapping of a font file.
+    #[cfg(not(target_arch = "wasm32"))]
+    Mapped(memmap2::Mmap),
+}
+
+impl SharedBytes {
+    #[inline]
+    fn as_slice(&self) -> &[u8] {
+        match self {
+            SharedBytes::Heap(data) => data,
+            SharedBytes::Shared(data) => data.as_slice(),
+            SharedBytes::Static(data) => data,
+            #[cfg(not(target_arch = "wasm32"))]
+            SharedBytes::Mapped(map) => map,
+        }
+    }
 }
 
 impl SharedData {
     /// Creates shared data from the specified bytes.
     pub fn new(data: Vec<u8>) -> Self {
         Self {
-            inner: Arc::from(data),
+            inner: Arc::new(SharedBytes::Heap(data.into_boxed_slice())),
+        }
+    }
+
+    /// Creates shared data from bytes that are already reference counted,
+    /// without copying them.
+    pub fn from_arc(data: Arc<Vec<u8>>) -> Self {
+        Self {
+            inner: Arc::new(SharedBytes::Shared(data)),
+        }
+    }
+
+    /// Creates shared data borrowing bytes embedded in the binary.
+    pub fn from_static(data: &'static [u8]) -> Self {
+        Self {
+            inner: Arc::new(SharedBytes::Static(data)),
         }
     }
+
+    /// Returns true if both handles point at the same underlying buffer.
+    pub fn ptr_eq(&self, other: &SharedData) -> bool {
+        Arc::ptr_eq(&self.inner, &other.inner)
+    }
+
+    /// Returns true if the bytes are backed by a file mapping.
+    pub fn is_mapped(&self) -> bool {
+        #[cfg(not(target_arch = "wasm32"))]
+        if let SharedBytes::Mapped(_) = *self.inner {
+            return true;
+        }
+        false
+    }
 }
 
 impl std::ops::Deref for SharedData {
     type Target = [u8];
 
     fn deref(&self) -> &Self::Target {
-        (*self.inner).as_ref()
+        self.inner.as_slice()
     }
 }
 
 impl AsRef<[u8]> for SharedData {
     fn as_ref(&self) -> &[u8] {
-        (*self.inner).as_ref()
+        self.inner.as_slice()
     }
 }
 
@@ -760,7 +901,25 @@ impl FontData {
         data: &[u8],
         is_emoji: bool,
     ) -> Result<Self, Box<dyn std::error::Error>> {
-        let font = FontRef::from_index(data, 0).unwrap();
+        Self::from_shared(SharedData::new(data.to_vec()), is_emoji)
+    }
+
+    /// Same as `from_slice` for fonts embedded in the binary, without copying
+    /// the font bytes into every `FontLibrary`.
+    #[inline]
+    pub fn from_static(
+        data: &'static [u8],
+        is_emoji: bool,
+    ) -> Result<Self, Box<dyn std::error::Error>> {
+        Self::from_shared(SharedData::from_static(data), is_emoji)
+    }
+
+    #[inline]
+    fn from_shared(
+        data: SharedData,
+        is_emoji: bool,
+    ) -> Result<Self, Box<dyn std::error::Error>> {
+        let font = FontRef::from_index(&data, 0).unwrap();
         let (offset, key) = (font.offset, font.key);
         // Return our struct with the original file data and copies of the
         // offset and key from the font reference
@@ -771,7 +930,7 @@ impl FontData {
         let synth = attributes.synthesize(attributes);
 
         Ok(Self {
-            data: Some(SharedData::new(data.to_vec())),
+            data: Some(data),
             offset,
             key,
             synth,
@@ -958,7 +1117,7 @@ fn load_fallback_from_memory(font_spec: &SugarloafFont) -> FontData {
         (_, _) => constants::FONT_CASCADIAMONO_REGULAR,
     };
 
-    FontData::from_slice(font_to_load, false).unwrap()
+    FontData::from_static(font_to_load, false).unwrap()
 }
 
 #[allow(dead_code)]
@@ -986,8 +1145,6 @@ fn find_font_path(
 
 #[cfg(not(target_arch = "wasm32"))]
 fn load_from_font_source(path: &PathBuf) -> Option<SharedData> {
-    use std::io::Read;
-
     let cache = get_font_data_cache();
 
     // Check if already cached - DashMap handles concurrent access efficiently
@@ -995,18 +1152,124 @@ fn load_from_font_source(path: &PathBuf) -> Option<SharedData> {
         return Some(cached_data.clone());
     }
 
-    // Load from disk if not cached
-    if let Ok(mut file) = std::fs::File::open(path) {
-        let mut font_data = vec![];
-        if file.read_to_end(&mut font_data).is_ok() {
-            let shared_data = SharedData::new(font_data);
+    let file = std::fs::File::open(path).ok()?;
+    let metadata = file.metadata().ok()?;
+    let key = FontFileKey::new(path, &metadata);
+    let registry = get_font_file_registry();
+
+    // Same file reached through another path, or still alive in a library
+    // created before the last clear_font_data_cache()
+    let existing = registry.get(&key).and_then(|weak| weak.upgrade());
+    let shared_data = match existing {
+        Some(inner) => SharedData { inner },
+        None => {
+            let shared_data = map_font_file(&file)?;
             // Use entry API to handle concurrent inserts properly
-            let entry = cache
-                .entry(path.clone())
-                .or_insert_with(|| shared_data.clone());
-            return Some(entry.clone());
+            let mut entry = registry
+                .entry(key)
+                .or_insert_with(|| Arc::downgrade(&shared_data.inner));
+            match entry.upgrade() {
+                Some(inner) => SharedData { inner },
+                None => {
+                    *entry = Arc::downgrade(&shared_data.inner);
+                    shared_data
+                }
+            }
+        }
+    };
+
+    let entry = cache
+        .entry(path.clone())
+        .or_insert_with(|| shared_data.clone());
+    Some(entry.clone())
+}
+
+/// Maps a font file read-only, falling back to reading it onto the heap.
+///
+/// Font files are expected to be replaced rather than truncated in place while
+/// mapped; the identity key (inode, size, mtime) picks up replacements.
+#[cfg(not(target_arch = "wasm32"))]
+fn map_font_file(file: &std::fs::File) -> Option<SharedData> {
+    use std::io::Read;
+
+    // SAFETY: the mapping is read-only and private; see the note above about
+    // files being modified while mapped.
+    match unsafe { memmap2::Mmap::map(file) } {
+        Ok(map) => Some(SharedData {
+            inner: Arc::new(SharedBytes::Mapped(map)),
+        }),
+        Err(err) => {
+            warn!("Failed to map font file, reading it instead: {err}");
+            let mut font_data = vec![];
+            let mut file = file;
+            file.read_to_end(&mut font_data).ok()?;
+            Some(SharedData::new(font_data))
         }
     }
+}
 
-    None
+#[cfg(all(test, not(target_arch = "wasm32")))]
+mod shared_data_tests {
+    use super::*;
+
+    fn write_font_file(name: &str, data: &[u8]) -> PathBuf {
+        let dir = std::env::temp_dir().join(format!(
+            "sugarloaf-font-data-{}-{}",
+            std::process::id(),
+            name
+        ));
+        std::fs::create_dir_all(&dir).unwrap();
+        let path = dir.join("font.ttf");
+        std::fs::write(&path, data).unwrap();
+        path
+    }
+
+    #[test]
+    fn test_same_path_shares_mapping() {
+        let path = write_font_file("same-path", FONT_CASCADIAMONO_REGULAR);
+        let a = load_from_font_source(&path).unwrap();
+        let b = load_from_font_source(&path).unwrap();
+
+        assert!(a.ptr_eq(&b));
+        assert!(a.is_mapped());
+        assert_eq!(&a[..], FONT_CASCADIAMONO_REGULAR);
+    }
+
+    #[cfg(unix)]
+    #[test]
+    fn test_symlinked_path_shares_mapping() {
+        let path = write_font_file("symlink", FONT_CASCADIAMONO_REGULAR);
+        let link = path.with_file_name("link.ttf");
+        let _ = std::fs::remove_file(&link);
+        std::os::unix::fs::symlink(&path, &link).unwrap();
+
+        let a = load_from_font_source(&path).unwrap();
+        let b = load_from_font_source(&link).unwrap();
+        assert!(a.ptr_eq(&b));
+    }
+
+    #[test]
+    fn test_replaced_file_is_reloaded() {
+        let path = write_font_file("replaced", FONT_CASCADIAMONO_REGULAR);
+        let a = load_from_font_source(&path).unwrap();
+
+        // Atomic replace: new inode, same path
+        let tmp = path.with_file_name("font.ttf.new");
+        std::fs::write(&tmp, FONT_CASCADIAMONO_BOLD).unwrap();
+        std::fs::rename(&tmp, &path).unwrap();
+
+        get_font_data_cache().remove(&path);
+        let b = load_from_font_source(&path).unwrap();
+        assert!(!a.ptr_eq(&b));
+        assert_eq!(&b[..], FONT_CASCADIAMONO_BOLD);
+        // The old mapping stays valid for whoever still holds it
+        assert_eq!(&a[..], FONT_CASCADIAMONO_REGULAR);
+    }
+
+    #[test]
+    fn test_static_font_data_is_not_copied() {
+        let font = FontData::from_static(FONT_CASCADIAMONO_REGULAR, false).unwrap();
+        let data = font.data().as_ref().unwrap();
+        assert_eq!(data.as_ptr(), FONT_CASCADIAMONO_REGULAR.as_ptr());
+    }
 }
@@ -27,6 +27,7 @@ use rustc_hash::FxHashMap;
 use std::collections::HashSet;
 use std::hash::{Hash, Hasher};
 use std::num::NonZeroUsize;
+use std::ops::Range;
 use std::sync::atomic::{AtomicUsize, Ordering};
 use tracing::debug;
 
@@ -111,6 +112,80 @@ pub struct BuilderLine {
     pub content_hash: u64,
 }
 
+/// Edit applied to the fragments of a single [`BuilderLine`].
+///
+/// Ranges are fragment indices and are clamped to the line length.
+#[derive(Debug, Clone)]
+pub enum FragmentPatch {
+    Insert {
+        at: usize,
+        fragments: Vec<FragmentData>,
+    },
+    Replace {
+        range: Range<usize>,
+        fragments: Vec<FragmentData>,
+    },
+    Delete {
+        range: Range<usize>,
+    },
+}
+
+impl BuilderLine {
+    /// Applies `patch` to the fragment list and drops the runs that were laid
+    /// out for the removed fragments, keeping the runs of untouched fragments.
+    ///
+    /// Returns the range of fragments that must be laid out again. Each
+    /// fragment normally produces exactly one run; if the runs are out of
+    /// sync with the fragments (line never built, or a fragment failed to
+    /// shape), the render data is cleared and the whole line is returned.
+    pub fn apply_patch(&mut self, patch: FragmentPatch) -> Range<usize> {
+        let in_sync = self.render_data.runs.len() == self.fragments.len();
+        let len = self.fragments.len();
+
+        let (removed, inserted) = match patch {
+            FragmentPatch::Insert { at, fragments } => {
+                let at = at.min(len);
+                let count = fragments.len();
+                self.fragments.splice(at..at, fragments);
+                (at..at, at..at + count)
+            }
+            FragmentPatch::Replace { range, fragments } => {
+                let end = range.end.min(len);
+                let start = range.start.min(end);
+                let count = fragments.len();
+                self.fragments.splice(start..end, fragments);
+                (start..end, start..start + count)
+            }
+            FragmentPatch::Delete { range } => {
+                let end = range.end.min(len);
+                let start = range.start.min(end);
+                self.fragments.drain(start..end);
+                (start..end, start..start)
+            }
+        };
+
+        if !in_sync {
+            self.render_data.clear();
+            return 0..self.fragments.len();
+        }
+
+        let had_media = self.render_data.runs[removed.clone()]
+            .iter()
+            .any(|run| run.span.media.is_some());
+        self.render_data.runs.drain(removed);
+        if had_media {
+            self.render_data.graphics = self
+                .render_data
+                .runs
+                .iter()
+                .filter_map(|run| run.span.media.map(|graphic| graphic.id))
+                .collect();
+        }
+
+        inserted
+    }
+}
+
 
 #[derive(Default, Clone, PartialEq, Debug)]
 #[repr(C)]
@@ -606,6 +681,43 @@ impl Content {
         self
     }
 
+    /// Patches the fragments of `line_idx` in place and lays out only the
+    /// affected fragments, instead of clearing and rebuilding the whole line.
+    ///
+    /// Runs of untouched fragments are kept as-is, so a spinner or clock
+    /// changing a single fragment costs one shaped run per frame.
+    pub fn patch_line(&mut self, line_idx: usize, patch: FragmentPatch) -> &mut Content {
+        if let Some(selector) = self.selector {
+            let patched = match self.states.get_mut(&selector) {
+                Some(state) => match state.lines.get_mut(line_idx) {
+                    Some(line) => {
+                        let dirty = line.apply_patch(patch);
+                        // Runs after the patched range are detached so the new
+                        // runs can be appended in place, then reattached.
+                        let tail = line.render_data.runs.split_off(dirty.start);
+                        state.mark_line_dirty(line_idx);
+                        Some((dirty, tail))
+                    }
+                    None => None,
+                },
+                None => None,
+            };
+
+            if let Some((dirty, tail)) = patched {
+                self.process_fragments(selector, line_idx, dirty);
+                if let Some(line) = self
+                    .states
+                    .get_mut(&selector)
+                    .and_then(|state| state.lines.get_mut(line_idx))
+                {
+                    line.render_data.runs.extend(tail);
+                }
+            }
+        }
+
+        self
+    }
+
     /// Adds a text fragment to the paragraph.
     pub fn add_text_with_id(
         &mut self,
@@ -645,6 +757,24 @@ impl Content {
 
     // Helper function to process a single line that avoids borrow issues
     fn process_line(&mut self, state_id: usize, line_number: usize) {
+        let fragments = match self.states.get(&state_id) {
+            Some(state) => match state.lines.get(line_number) {
+                Some(line) => line.fragments.len(),
+                None => return,
+            },
+            None => return,
+        };
+
+        self.process_fragments(state_id, line_number, 0..fragments);
+    }
+
+    // Lays out `range` of the line's fragments, appending one run per fragment
+    fn process_fragments(
+        &mut self,
+        state_id: usize,
+        line_number: usize,
+        range: Range<usize>,
+    ) {
         // Get all needed data while borrowing parts of self separately
         let script = Script::Latin;
 
@@ -667,7 +797,8 @@ impl Content {
         let line = &mut state.lines[line_number];
 
         // Process each fragment
-        for fragment_idx in 0..line.fragments.len() {
+        let range = range.start..range.end.min(line.fragments.len());
+        for fragment_idx in range {
             // Get a reference to the current fragment
             let item = &line.fragments[fragment_idx];
             let font_id = item.style.font_id;
@@ -3147,4 +3278,207 @@ mod tests {
             "Content hashes should be different for 'along' and 'clone'"
         );
     }
+
+    const SPINNER: [&str; 10] = ["⠋", "⠙", "⠹", "⠸", "⠼", "⠴", "⠦", "⠧", "⠇", "⠏"];
+
+    fn spinner_fragments(frame: usize, line: usize) -> Vec<FragmentData> {
+        vec![
+            FragmentData {
+                content: SPINNER[frame % SPINNER.len()].to_string(),
+                style: FragmentStyle::default(),
+            },
+            FragmentData {
+                content: format!(" Compiling crate-{line} v0.1.0"),
+                style: FragmentStyle::default(),
+            },
+            FragmentData {
+                content: " (build script)".to_string(),
+                style: FragmentStyle {
+                    color: [0.5, 0.5, 0.5, 1.0],
+                    ..FragmentStyle::default()
+                },
+            },
+        ]
+    }
+
+    fn build_spinner_content(lines: usize, frame: usize) -> (Content, usize) {
+        let font_library = FontLibrary::default();
+        let mut content = Content::new(&font_library);
+        let layout = RichTextLayout {
+            line_height: 1.0,
+            font_size: 14.0,
+            original_font_size: 14.0,
+            dimensions: crate::layout::SugarDimensions {
+                scale: 1.0,
+                ..Default::default()
+            },
+        };
+        let id = content.create_state(&layout);
+        content.sel(id).clear();
+        for line in 0..lines {
+            if line > 0 {
+                content.new_line();
+            }
+            for fragment in spinner_fragments(frame, line) {
+                content.add_text(&fragment.content, fragment.style);
+            }
+        }
+        content.build();
+        (content, id)
+    }
+
+    fn run_signature(line: &BuilderLine) -> Vec<(usize, u32, Vec<u32>)> {
+        line.render_data
+            .runs
+            .iter()
+            .map(|run| {
+                (
+                    run.glyphs.len(),
+                    run.advance.to_bits(),
+                    run.glyphs.iter().map(|glyph| glyph.data).collect(),
+                )
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_apply_patch_keeps_untouched_runs() {
+        let (mut content, id) = build_spinner_content(1, 0);
+        let line = &mut content.get_state_mut(&id).unwrap().lines[0];
+        assert_eq!(line.render_data.runs.len(), 3);
+        let text_advance = line.render_data.runs[1].advance;
+
+        let dirty = line.apply_patch(FragmentPatch::Delete { range: 2..10 });
+        assert_eq!(dirty, 2..2);
+        assert_eq!(line.fragments.len(), 2);
+        assert_eq!(line.render_data.runs.len(), 2);
+
+        let dirty = line.apply_patch(FragmentPatch::Replace {
+            range: 0..1,
+            fragments: spinner_fragments(1, 0)[..1].to_vec(),
+        });
+        assert_eq!(dirty, 0..1);
+        assert_eq!(line.fragments.len(), 2);
+        assert_eq!(line.render_data.runs.len(), 1);
+        assert_eq!(line.render_data.runs[0].advance, text_advance);
+    }
+
+    #[test]
+    fn test_apply_patch_out_of_sync_relayouts_line() {
+        let mut line = BuilderLine {
+            fragments: spinner_fragments(0, 0),
+            ..Default::default()
+        };
+
+        // Never laid out: the whole line must be shaped
+        let dirty = line.apply_patch(FragmentPatch::Insert {
+            at: 99,
+            fragments: spinner_fragments(1, 0)[..1].to_vec(),
+        });
+        assert_eq!(dirty, 0..4);
+        assert_eq!(line.fragments[3].content, SPINNER[1]);
+        assert!(line.render_data.runs.is_empty());
+    }
+
+    #[test]
+    fn test_patch_line_matches_full_rebuild() {
+        let (mut patched, id) = build_spinner_content(3, 0);
+        for line in 0..3 {
+            patched.sel(id).patch_line(
+                line,
+                FragmentPatch::Replace {
+                    range: 0..1,
+                    fragments: spinner_fragments(5, line)[..1].to_vec(),
+                },
+            );
+        }
+        let (rebuilt, rebuilt_id) = build_spinner_content(3, 5);
+
+        let patched_state = patched.get_state(&id).unwrap();
+        let rebuilt_state = rebuilt.get_state(&rebuilt_id).unwrap();
+        for line in 0..3 {
+            assert_eq!(
+                run_signature(&patched_state.lines[line]),
+                run_signature(&rebuilt_state.lines[line])
+            );
+        }
+        assert_eq!(
+            patched_state.last_update,
+            BuilderStateUpdate::Partial(HashSet::from([0, 1, 2]))
+        );
+
+        // Insert and delete keep runs aligned with fragments
+        patched.sel(id).patch_line(
+            1,
+            FragmentPatch::Insert {
+                at: 1,
+                fragments: vec![FragmentData {
+                    content: "!".to_string(),
+                    style: FragmentStyle::default(),
+                }],
+            },
+        );
+        patched
+            .sel(id)
+            .patch_line(1, FragmentPatch::Delete { range: 1..2 });
+        assert_eq!(
+            run_signature(&patched.get_state(&id).unwrap().lines[1]),
+            run_signature(&rebuilt.get_state(&rebuilt_id).unwrap().lines[1])
+        );
+    }
+
+    #[test]
+    fn bench_spinner_patch_vs_rebuild() {
+        const LINES: usize = 50;
+        let frames = 200;
+
+        // Full rebuild: clear and re-add every fragment of every line each frame
+        let (mut content, id) = build_spinner_content(LINES, 0);
+        let start = std::time::Instant::now();
+        for frame in 0..frames {
+            content.sel(id).clear();
+            for line in 0..LINES {
+                if line > 0 {
+                    content.new_line();
+                }
+                for fragment in spinner_fragments(frame, line) {
+                    content.add_text(&fragment.content, fragment.style);
+                }
+            }
+            content.build();
+        }
+        let rebuild = start.elapsed();
+
+        // Patch: replace only the spinner fragment of each line
+        let (mut content, id) = build_spinner_content(LINES, 0);
+        let start = std::time::Instant::now();
+        for frame in 0..frames {
+            for line in 0..LINES {
+                content.sel(id).patch_line(
+                    line,
+                    FragmentPatch::Replace {
+                        range: 0..1,
+                        fragments: vec![FragmentData {
+                            content: SPINNER[frame % SPINNER.len()].to_string(),
+                            style: FragmentStyle::default(),
+                        }],
+                    },
+                );
+            }
+            content.mark_states_clean();
+        }
+        let patch = start.elapsed();
+
+        println!("\nSpinner {} lines x {} frames", LINES, frames);
+        println!(
+            "  full rebuild: {:?} ({:?}/frame)",
+            rebuild,
+            rebuild / frames as u32
+        );
+        println!(
+            "  patch_line:   {:?} ({:?}/frame)",
+            patch,
+            patch / frames as u32
+        );
+    }
 }
@@ -15,8 +15,8 @@ pub use glyph::Glyph;
 pub use render_data::RenderData;
 
 pub use content::{
-    BuilderLine, BuilderState, BuilderStateUpdate, Content, FragmentData, FragmentStyle,
-    FragmentStyleDecoration, UnderlineInfo, UnderlineShape, WordCache,
+    BuilderLine, BuilderState, BuilderStateUpdate, Content, FragmentData, FragmentPatch,
+    FragmentStyle, FragmentStyleDecoration, UnderlineInfo, UnderlineShape, WordCache,
 };
 
 pub use render_data::Run;